@@ -0,0 +1,185 @@
+/*
+ * synthclone - Synthesizer-cloning software
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "benchmarkzone.h"
+
+// The effects only need a zone to pass to Effect::process(), so this zone has
+// fixed properties and ignores changes to anything but its dry sample.
+
+BenchmarkZone::BenchmarkZone(QObject *parent):
+    synthclone::Zone(parent)
+{
+    drySample = 0;
+}
+
+BenchmarkZone::~BenchmarkZone()
+{
+    // Empty
+}
+
+synthclone::MIDIData
+BenchmarkZone::getAftertouch() const
+{
+    return synthclone::MIDI_VALUE_NOT_SET;
+}
+
+synthclone::MIDIData
+BenchmarkZone::getChannel() const
+{
+    return 1;
+}
+
+synthclone::MIDIData
+BenchmarkZone::getChannelPressure() const
+{
+    return synthclone::MIDI_VALUE_NOT_SET;
+}
+
+const BenchmarkZone::ControlMap &
+BenchmarkZone::getControlMap() const
+{
+    return controlMap;
+}
+
+synthclone::MIDIData
+BenchmarkZone::getControlValue(synthclone::MIDIData /*control*/) const
+{
+    return synthclone::MIDI_VALUE_NOT_SET;
+}
+
+const synthclone::Sample *
+BenchmarkZone::getDrySample() const
+{
+    return drySample;
+}
+
+synthclone::MIDIData
+BenchmarkZone::getNote() const
+{
+    return 60;
+}
+
+synthclone::SampleTime
+BenchmarkZone::getReleaseTime() const
+{
+    return 1.0;
+}
+
+synthclone::SampleTime
+BenchmarkZone::getSampleTime() const
+{
+    return 10.0;
+}
+
+BenchmarkZone::Status
+BenchmarkZone::getStatus() const
+{
+    return STATUS_EFFECTS;
+}
+
+synthclone::MIDIData
+BenchmarkZone::getVelocity() const
+{
+    return 0x7f;
+}
+
+const synthclone::Sample *
+BenchmarkZone::getWetSample() const
+{
+    return 0;
+}
+
+int
+BenchmarkZone::getXrunCount() const
+{
+    return 0;
+}
+
+bool
+BenchmarkZone::isDrySampleStale() const
+{
+    return false;
+}
+
+bool
+BenchmarkZone::isWetSampleStale() const
+{
+    return true;
+}
+
+void
+BenchmarkZone::setAftertouch(synthclone::MIDIData /*aftertouch*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setChannel(synthclone::MIDIData /*channel*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setChannelPressure(synthclone::MIDIData /*pressure*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setControlValue(synthclone::MIDIData /*control*/,
+                               synthclone::MIDIData /*value*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setDrySample(synthclone::Sample *sample)
+{
+    drySample = sample;
+}
+
+void
+BenchmarkZone::setNote(synthclone::MIDIData /*note*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setReleaseTime(synthclone::SampleTime /*releaseTime*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setSampleTime(synthclone::SampleTime /*sampleTime*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setVelocity(synthclone::MIDIData /*velocity*/)
+{
+    // Empty
+}
+
+void
+BenchmarkZone::setWetSampleStale()
+{
+    // Empty
+}
@@ -0,0 +1,116 @@
+/*
+ * synthclone - Synthesizer-cloning software
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __BENCHMARKZONE_H__
+#define __BENCHMARKZONE_H__
+
+#include <synthclone/zone.h>
+
+class BenchmarkZone: public synthclone::Zone {
+
+public:
+
+    explicit
+    BenchmarkZone(QObject *parent=0);
+
+    ~BenchmarkZone();
+
+    synthclone::MIDIData
+    getAftertouch() const;
+
+    synthclone::MIDIData
+    getChannel() const;
+
+    synthclone::MIDIData
+    getChannelPressure() const;
+
+    const ControlMap &
+    getControlMap() const;
+
+    synthclone::MIDIData
+    getControlValue(synthclone::MIDIData control) const;
+
+    const synthclone::Sample *
+    getDrySample() const;
+
+    synthclone::MIDIData
+    getNote() const;
+
+    synthclone::SampleTime
+    getReleaseTime() const;
+
+    synthclone::SampleTime
+    getSampleTime() const;
+
+    Status
+    getStatus() const;
+
+    synthclone::MIDIData
+    getVelocity() const;
+
+    const synthclone::Sample *
+    getWetSample() const;
+
+    int
+    getXrunCount() const;
+
+    bool
+    isDrySampleStale() const;
+
+    bool
+    isWetSampleStale() const;
+
+    void
+    setAftertouch(synthclone::MIDIData aftertouch);
+
+    void
+    setChannel(synthclone::MIDIData channel);
+
+    void
+    setChannelPressure(synthclone::MIDIData pressure);
+
+    void
+    setControlValue(synthclone::MIDIData control, synthclone::MIDIData value);
+
+    void
+    setDrySample(synthclone::Sample *sample);
+
+    void
+    setNote(synthclone::MIDIData note);
+
+    void
+    setReleaseTime(synthclone::SampleTime releaseTime);
+
+    void
+    setSampleTime(synthclone::SampleTime sampleTime);
+
+    void
+    setVelocity(synthclone::MIDIData velocity);
+
+    void
+    setWetSampleStale();
+
+private:
+
+    ControlMap controlMap;
+    synthclone::Sample *drySample;
+
+};
+
+#endif
@@ -0,0 +1,39 @@
+include(../../../synthclone.pri)
+
+################################################################################
+# Build
+################################################################################
+
+# The benchmark isn't part of the regular build.  Build `synthclone` first,
+# then run `qmake` and `make` in this directory.  Run the benchmark with the
+# directory containing the built plugins as its argument.
+
+isEmpty(BUILDDIR) {
+    BUILDDIR = ../../../build
+}
+
+isEmpty(MAKEDIR) {
+    MAKEDIR = ../../../make
+}
+
+unix:!macx {
+    # See the note in `src/plugins/plugins.pri`.
+    LIB_BUILDDIR = $${BUILDDIR}/$${SYNTHCLONE_LIBRARY_SUFFIX}
+    LIB_VERSION = $${MAJOR_VERSION}.$${MINOR_VERSION}.$${REVISION}
+    LIBS += $${LIB_BUILDDIR}/libsynthclone.so.$${LIB_VERSION}
+} else {
+    LIBS += -L$${BUILDDIR}/$${SYNTHCLONE_LIBRARY_SUFFIX} -lsynthclone
+}
+
+CONFIG += console
+DESTDIR = $${BUILDDIR}/benchmarks
+HEADERS += benchmarkzone.h \
+    legacyeffects.h
+INCLUDEPATH += ../../include
+MOC_DIR = $${MAKEDIR}/benchmarks/effectbenchmark
+OBJECTS_DIR = $${MAKEDIR}/benchmarks/effectbenchmark
+SOURCES += benchmarkzone.cpp \
+    legacyeffects.cpp \
+    main.cpp
+TARGET = synthclone-effect-benchmark
+TEMPLATE = app
@@ -0,0 +1,219 @@
+/*
+ * synthclone - Synthesizer-cloning software
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include <QtCore/QScopedArrayPointer>
+
+#include <synthclone/samplecopier.h>
+
+#include "legacyeffects.h"
+
+// Static data
+
+static const float FADE_IN_START_VOLUME = -64.0;
+static const float FADE_IN_TIME = 0.01;
+static const float FADE_OUT_END_VOLUME = -64.0;
+static const float FADE_OUT_TIME = 0.01;
+static const float SAMPLE_FLOOR = -70.0;
+
+// Static functions
+
+static float
+getAmplitude(float dBFS)
+{
+    assert(dBFS <= 0.0);
+    return std::pow(10, dBFS / 20.0);
+}
+
+static float
+getDBFS(float sample)
+{
+    return (sample == 0.0) ? -FLT_MAX : 20.0 * std::log10(std::fabs(sample));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LegacyFader
+////////////////////////////////////////////////////////////////////////////////
+
+LegacyFader::LegacyFader(QObject *parent):
+    synthclone::Effect("Legacy Fader", parent)
+{
+    // Empty
+}
+
+LegacyFader::~LegacyFader()
+{
+    // Empty
+}
+
+void
+LegacyFader::process(const synthclone::Zone &/*zone*/,
+                     synthclone::SampleInputStream &inputStream,
+                     synthclone::SampleOutputStream &outputStream)
+{
+    synthclone::SampleFrameCount frames = inputStream.getFrames();
+    float sampleRate = static_cast<float>(inputStream.getSampleRate());
+    synthclone::SampleFrameCount fadeInFrames =
+        static_cast<synthclone::SampleFrameCount>(FADE_IN_TIME * sampleRate);
+    synthclone::SampleFrameCount fadeOutFrames =
+        static_cast<synthclone::SampleFrameCount>(FADE_OUT_TIME * sampleRate);
+    synthclone::SampleFrameCount totalFadeFrames =
+        fadeInFrames + fadeOutFrames;
+    if (totalFadeFrames > frames) {
+        fadeInFrames = static_cast<synthclone::SampleFrameCount>
+            (static_cast<float>(fadeInFrames) *
+             (static_cast<float>(frames) /
+              static_cast<float>(totalFadeFrames)));
+        fadeOutFrames = frames - fadeInFrames;
+    }
+
+    synthclone::SampleChannelCount channels = inputStream.getChannels();
+    QScopedArrayPointer<float> audioDataPtr(new float[channels]);
+    float *audioData = audioDataPtr.data();
+    synthclone::SampleFrameCount currentFrame = 0;
+    synthclone::SampleFrameCount framesRead;
+    float volume;
+    for (; currentFrame < fadeInFrames; currentFrame++) {
+        framesRead = inputStream.read(audioData, 1);
+        assert(framesRead == 1);
+        volume = getAmplitude(FADE_IN_START_VOLUME *
+                              (1.0 - (static_cast<float>(currentFrame + 1) /
+                                      static_cast<float>(fadeInFrames))));
+        for (int i = 0; i < channels; i++) {
+            audioData[i] *= volume;
+        }
+        outputStream.write(audioData, 1);
+        emit progressChanged(static_cast<float>(currentFrame + 1) /
+                             static_cast<float>(frames));
+    }
+    synthclone::SampleFrameCount fadeOutStartFrame = frames - fadeOutFrames;
+    synthclone::SampleFrameCount copyFrames = fadeOutStartFrame - currentFrame;
+    if (copyFrames) {
+        synthclone::SampleCopier copier;
+        copier.copy(inputStream, outputStream, copyFrames);
+    }
+    currentFrame += copyFrames;
+    for (; currentFrame < frames; currentFrame++) {
+        framesRead = inputStream.read(audioData, 1);
+        assert(framesRead == 1);
+        volume = getAmplitude(FADE_OUT_END_VOLUME *
+                              (static_cast<float>(currentFrame + 1 -
+                                                  fadeOutStartFrame) /
+                               static_cast<float>(fadeOutFrames)));
+        for (int i = 0; i < channels; i++) {
+            audioData[i] *= volume;
+        }
+        outputStream.write(audioData, 1);
+        emit progressChanged(static_cast<float>(currentFrame + 1) /
+                             static_cast<float>(frames));
+    }
+    emit progressChanged(0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LegacyReverser
+////////////////////////////////////////////////////////////////////////////////
+
+LegacyReverser::LegacyReverser(QObject *parent):
+    synthclone::Effect("Legacy Reverser", parent)
+{
+    // Empty
+}
+
+LegacyReverser::~LegacyReverser()
+{
+    // Empty
+}
+
+void
+LegacyReverser::process(const synthclone::Zone &/*zone*/,
+                        synthclone::SampleInputStream &inputStream,
+                        synthclone::SampleOutputStream &outputStream)
+{
+    QScopedArrayPointer<float> dataPtr(new float[inputStream.getChannels()]);
+    float *data = dataPtr.data();
+    synthclone::SampleFrameCount totalFrames = inputStream.getFrames();
+    emit progressChanged(0.0);
+    for (synthclone::SampleFrameCount i = totalFrames - 1; i >= 0; i--) {
+        inputStream.seek(i, synthclone::SampleStream::OFFSET_START);
+        synthclone::SampleFrameCount n = inputStream.read(data, 1);
+        assert(n == 1);
+        outputStream.write(data, 1);
+        emit progressChanged(static_cast<float>(totalFrames - i) /
+                             static_cast<float>(totalFrames));
+    }
+    emit progressChanged(0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LegacyTrimmer
+////////////////////////////////////////////////////////////////////////////////
+
+LegacyTrimmer::LegacyTrimmer(QObject *parent):
+    synthclone::Effect("Legacy Trimmer", parent)
+{
+    // Empty
+}
+
+LegacyTrimmer::~LegacyTrimmer()
+{
+    // Empty
+}
+
+void
+LegacyTrimmer::process(const synthclone::Zone &/*zone*/,
+                       synthclone::SampleInputStream &inputStream,
+                       synthclone::SampleOutputStream &outputStream)
+{
+    synthclone::SampleChannelCount channels = inputStream.getChannels();
+    QScopedArrayPointer<float> audioDataPtr(new float[channels]);
+    float *audioData = audioDataPtr.data();
+    synthclone::SampleFrameCount frames = inputStream.getFrames();
+    synthclone::SampleFrameCount framesRead;
+    synthclone::SampleFrameCount end = frames - 1;
+    synthclone::SampleFrameCount start = 0;
+    for (; start < end; start++) {
+        framesRead = inputStream.read(audioData, 1);
+        assert(framesRead == 1);
+        for (int i = 0; i < channels; i++) {
+            if (getDBFS(audioData[i]) >= SAMPLE_FLOOR) {
+                goto findEnd;
+            }
+        }
+    }
+ findEnd:
+    for (; end >= start; end--) {
+        inputStream.seek(end, synthclone::SampleStream::OFFSET_START);
+        framesRead = inputStream.read(audioData, 1);
+        assert(framesRead == 1);
+        for (int i = 0; i < channels; i++) {
+            if (getDBFS(audioData[i]) >= SAMPLE_FLOOR) {
+                goto writeSample;
+            }
+        }
+    }
+ writeSample:
+    inputStream.seek(start, synthclone::SampleStream::OFFSET_START);
+    synthclone::SampleCopier copier;
+    copier.copy(inputStream, outputStream, (end - start) + 1);
+    emit progressChanged(0.0);
+}
@@ -0,0 +1,77 @@
+/*
+ * synthclone - Synthesizer-cloning software
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __LEGACYEFFECTS_H__
+#define __LEGACYEFFECTS_H__
+
+#include <synthclone/effect.h>
+
+// Copies of the fader, reverser and trimmer effects as they were before they
+// were ported to BlockEffect.  They read and write one frame at a time, and
+// use the plugins' default settings.
+
+class LegacyFader: public synthclone::Effect {
+
+public:
+
+    explicit
+    LegacyFader(QObject *parent=0);
+
+    ~LegacyFader();
+
+    void
+    process(const synthclone::Zone &zone,
+            synthclone::SampleInputStream &inputStream,
+            synthclone::SampleOutputStream &outputStream);
+
+};
+
+class LegacyReverser: public synthclone::Effect {
+
+public:
+
+    explicit
+    LegacyReverser(QObject *parent=0);
+
+    ~LegacyReverser();
+
+    void
+    process(const synthclone::Zone &zone,
+            synthclone::SampleInputStream &inputStream,
+            synthclone::SampleOutputStream &outputStream);
+
+};
+
+class LegacyTrimmer: public synthclone::Effect {
+
+public:
+
+    explicit
+    LegacyTrimmer(QObject *parent=0);
+
+    ~LegacyTrimmer();
+
+    void
+    process(const synthclone::Zone &zone,
+            synthclone::SampleInputStream &inputStream,
+            synthclone::SampleOutputStream &outputStream);
+
+};
+
+#endif
@@ -0,0 +1,240 @@
+/*
+ * synthclone - Synthesizer-cloning software
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <cmath>
+#include <cstdlib>
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+#include <QtWidgets/QApplication>
+
+#include <synthclone/error.h>
+#include <synthclone/iplugin.h>
+#include <synthclone/sampleinputstream.h>
+#include <synthclone/sampleoutputstream.h>
+
+#include "benchmarkzone.h"
+#include "legacyeffects.h"
+
+typedef QList<synthclone::Effect *> EffectList;
+
+// Static data
+
+static const synthclone::SampleChannelCount CHANNELS = 2;
+
+// The speedup the block effects are expected to have over the per-frame
+// effects they replaced.
+static const double EFFECT_SPEEDUP_TARGET = 20.0;
+
+// Each measurement is the best of this many runs.
+static const int RUNS = 5;
+
+static const synthclone::SampleRate SAMPLE_RATE = 44100;
+
+// The length of the dry sample, in seconds.  The first and last half second
+// are silent, so that the trimmer has something to trim.
+static const int SAMPLE_TIME = 10;
+
+// Static functions
+
+static synthclone::Sample *
+createDrySample()
+{
+    synthclone::Sample *sample =
+        new synthclone::Sample(synthclone::Sample::STORAGE_FILE);
+    QScopedPointer<synthclone::Sample> samplePtr(sample);
+    synthclone::SampleOutputStream stream(*sample, SAMPLE_RATE, CHANNELS);
+    synthclone::SampleFrameCount frames = SAMPLE_TIME * SAMPLE_RATE;
+    synthclone::SampleFrameCount silenceFrames = SAMPLE_RATE / 2;
+    QVector<float> data(SAMPLE_RATE * CHANNELS);
+    for (synthclone::SampleFrameCount start = 0; start < frames;
+         start += SAMPLE_RATE) {
+        for (synthclone::SampleFrameCount i = 0; i < SAMPLE_RATE; i++) {
+            synthclone::SampleFrameCount frame = start + i;
+            float value = ((frame < silenceFrames) ||
+                           (frame >= (frames - silenceFrames))) ? 0.0 :
+                0.5 * std::sin(6.28318531 * 440.0 * frame / SAMPLE_RATE);
+            for (int j = 0; j < CHANNELS; j++) {
+                data[(i * CHANNELS) + j] = value;
+            }
+        }
+        stream.write(data.constData(), SAMPLE_RATE);
+    }
+    stream.close();
+    return samplePtr.take();
+}
+
+static synthclone::Effect *
+createEffect(const QDir &pluginDirectory, const QString &name)
+{
+    QByteArray id = "com.googlecode.synthclone.plugins." + name.toLatin1();
+    QStringList files = pluginDirectory.entryList(QDir::Files);
+    for (int i = 0; i < files.count(); i++) {
+        QPluginLoader loader(pluginDirectory.absoluteFilePath(files[i]));
+        synthclone::IPlugin *plugin =
+            qobject_cast<synthclone::IPlugin *>(loader.instance());
+        if (plugin && (plugin->getId() == id)) {
+            synthclone::Effect *effect =
+                plugin->getParticipant()->cloneEffect(QVariant());
+            if (! effect) {
+                throw synthclone::Error(QString("the '%1' plugin can't create "
+                                                "effects").arg(name));
+            }
+            return effect;
+        }
+    }
+    throw synthclone::Error(QString("the '%1' plugin isn't in '%2'").
+                            arg(name, pluginDirectory.absolutePath()));
+}
+
+static double
+runChain(const EffectList &effects, const synthclone::Zone &zone,
+         synthclone::Sample::Storage intermediateStorage)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const synthclone::Sample *inputSample = zone.getDrySample();
+    QScopedPointer<synthclone::Sample> inputSamplePtr;
+    int count = effects.count();
+    for (int i = 0; i < count; i++) {
+        // Like the session, the final wet sample is always written to a file.
+        synthclone::Sample *outputSample =
+            new synthclone::Sample(i == (count - 1) ?
+                                   synthclone::Sample::STORAGE_FILE :
+                                   intermediateStorage);
+        QScopedPointer<synthclone::Sample> outputSamplePtr(outputSample);
+        {
+            synthclone::SampleInputStream inputStream(*inputSample);
+            synthclone::SampleOutputStream
+                outputStream(*outputSample, inputStream.getSampleRate(),
+                             inputStream.getChannels());
+            effects[i]->process(zone, inputStream, outputStream);
+        }
+        inputSample = outputSample;
+        inputSamplePtr.reset(outputSamplePtr.take());
+    }
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+static double
+measureChain(const EffectList &effects, const synthclone::Zone &zone,
+             synthclone::Sample::Storage intermediateStorage)
+{
+    double best = 0.0;
+    for (int i = 0; i < RUNS; i++) {
+        double time = runChain(effects, zone, intermediateStorage);
+        if ((! i) || (time < best)) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+static void
+reportChainBenchmark(QTextStream &out, const QDir &pluginDirectory,
+                     const synthclone::Zone &zone)
+{
+    EffectList effects;
+    try {
+        effects.append(createEffect(pluginDirectory, "trimmer"));
+        effects.append(createEffect(pluginDirectory, "fader"));
+        effects.append(createEffect(pluginDirectory, "reverser"));
+        effects.append(createEffect(pluginDirectory, "fader"));
+        double fileTime =
+            measureChain(effects, zone, synthclone::Sample::STORAGE_FILE);
+        double memoryTime =
+            measureChain(effects, zone, synthclone::Sample::STORAGE_MEMORY);
+        out << "Effect chain (trimmer, fader, reverser, fader):\n"
+            << "  temporary file intermediates: " << fileTime << " ms\n"
+            << "  in-memory intermediates:      " << memoryTime << " ms\n"
+            << "  speedup:                      " << (fileTime / memoryTime)
+            << "x\n";
+    } catch (...) {
+        qDeleteAll(effects);
+        throw;
+    }
+    qDeleteAll(effects);
+}
+
+static void
+reportEffectBenchmark(QTextStream &out, const QDir &pluginDirectory,
+                      const synthclone::Zone &zone, const QString &name,
+                      synthclone::Effect *legacyEffect)
+{
+    // The effects are measured alone, reading the file-backed dry sample and
+    // writing a file-backed wet sample, as the effects did before in-memory
+    // intermediates were added.
+    QScopedPointer<synthclone::Effect> legacyEffectPtr(legacyEffect);
+    QScopedPointer<synthclone::Effect>
+        blockEffect(createEffect(pluginDirectory, name));
+    EffectList effects;
+    effects.append(legacyEffect);
+    double legacyTime =
+        measureChain(effects, zone, synthclone::Sample::STORAGE_FILE);
+    effects[0] = blockEffect.data();
+    double blockTime =
+        measureChain(effects, zone, synthclone::Sample::STORAGE_FILE);
+    double speedup = legacyTime / blockTime;
+    out << "Effect '" << name << "':\n"
+        << "  per-frame I/O: " << legacyTime << " ms\n"
+        << "  block I/O:     " << blockTime << " ms\n"
+        << "  speedup:       " << speedup << "x ("
+        << ((speedup >= EFFECT_SPEEDUP_TARGET) ? "meets" : "misses")
+        << " the " << EFFECT_SPEEDUP_TARGET << "x target)\n\n";
+}
+
+int
+main(int argc, char **argv)
+{
+    // The effect plugins create their views when they're loaded, so a GUI
+    // application is needed.  Set QT_QPA_PLATFORM=offscreen to run without a
+    // display.
+    QApplication application(argc, argv);
+    QStringList arguments = application.arguments();
+    QTextStream out(stdout);
+    if (arguments.count() != 2) {
+        out << "usage: " << arguments[0] << " plugin-directory\n";
+        return EXIT_FAILURE;
+    }
+    QDir pluginDirectory(arguments[1]);
+    try {
+        QScopedPointer<synthclone::Sample> drySample(createDrySample());
+        BenchmarkZone zone;
+        zone.setDrySample(drySample.data());
+        out << "Dry sample: " << SAMPLE_TIME << " seconds, " << CHANNELS
+            << " channels, " << SAMPLE_RATE << " Hz\n"
+            << "Times are the best of " << RUNS << " runs.\n\n";
+        reportEffectBenchmark(out, pluginDirectory, zone, "fader",
+                              new LegacyFader());
+        reportEffectBenchmark(out, pluginDirectory, zone, "reverser",
+                              new LegacyReverser());
+        reportEffectBenchmark(out, pluginDirectory, zone, "trimmer",
+                              new LegacyTrimmer());
+        reportChainBenchmark(out, pluginDirectory, zone);
+    } catch (synthclone::Error &e) {
+        out << "error: " << e.getMessage() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __SYNTHCLONE_BLOCKEFFECT_H__
+#define __SYNTHCLONE_BLOCKEFFECT_H__
+
+#include <synthclone/effect.h>
+
+namespace synthclone {
+
+    /**
+     * Effect that processes audio data in blocks of interleaved frames.
+     * Subclasses choose the range of frames to process in prepareBlocks(),
+     * and alter each block in processBlock().  Reading, writing and progress
+     * reporting are handled by BlockEffect.
+     */
+
+    class BlockEffect: public Effect {
+
+        Q_OBJECT
+
+    public:
+
+        /**
+         * Applies this Effect to audio data.  The range returned by
+         * prepareBlocks() is read in blocks, each block is passed to
+         * processBlock(), and the result is written to the output stream.
+         *
+         * @param zone
+         *   The Zone for which the Effect is being applied.
+         *
+         * @param inputStream
+         *   Contains the audio data to which this Effect should be applied.
+         *
+         * @param outputStream
+         *   Processed audio data is written to this stream.
+         */
+
+        void
+        process(const Zone &zone, SampleInputStream &inputStream,
+                SampleOutputStream &outputStream);
+
+    protected:
+
+        /**
+         * Directions in which blocks can be read from the input stream.
+         */
+
+        enum Direction {
+            DIRECTION_FORWARD = 0,
+            DIRECTION_BACKWARD
+        };
+
+        /**
+         * Constructs a new BlockEffect object.  This constructor cannot be
+         * called directly; instead, subclasses should call this constructor in
+         * their constructors.
+         *
+         * @param name
+         *   The initial name for the effect.
+         *
+         * @param parent
+         *   The parent object of the effect.
+         */
+
+        explicit
+        BlockEffect(const QString &name, QObject *parent=0);
+
+        virtual
+        ~BlockEffect();
+
+        /**
+         * Gets the maximum number of frames passed to processBlock().
+         *
+         * @returns
+         *   The block size.
+         */
+
+        SampleFrameCount
+        getBlockSize() const;
+
+        /**
+         * Gets the direction in which blocks are read.  When blocks are read
+         * backwards, the last block of the range is read first.  The frames
+         * inside each block remain in stream order.  The default
+         * implementation returns DIRECTION_FORWARD.
+         *
+         * @returns
+         *   The direction.
+         */
+
+        virtual Direction
+        getDirection() const;
+
+        /**
+         * Called before any blocks are processed.  Subclasses can use this
+         * method to inspect the input stream and to narrow the range of frames
+         * that is processed.  The position of the input stream may be changed
+         * by this method.  The default implementation does nothing.
+         *
+         * @param zone
+         *   The Zone for which the Effect is being applied.
+         *
+         * @param inputStream
+         *   The input stream.
+         *
+         * @param startFrame
+         *   The first frame of the range.  Initially set to 0.
+         *
+         * @param frames
+         *   The number of frames in the range.  Initially set to the number of
+         *   frames in the input stream.
+         */
+
+        virtual void
+        prepareBlocks(const Zone &zone, SampleInputStream &inputStream,
+                      SampleFrameCount &startFrame, SampleFrameCount &frames);
+
+        /**
+         * Called to alter a block of audio data in place.  The default
+         * implementation leaves the data unchanged.
+         *
+         * @param data
+         *   The interleaved audio data.
+         *
+         * @param offset
+         *   The offset of the first frame of the block from the start of the
+         *   range returned by prepareBlocks().
+         *
+         * @param frames
+         *   The number of frames in the block.
+         *
+         * @param channels
+         *   The number of channels in each frame.
+         */
+
+        virtual void
+        processBlock(float *data, SampleFrameCount offset,
+                     SampleFrameCount frames, SampleChannelCount channels);
+
+        /**
+         * Sets the maximum number of frames passed to processBlock().
+         *
+         * @param size
+         *   The block size.  Must be greater than 0.
+         */
+
+        void
+        setBlockSize(SampleFrameCount size);
+
+    private:
+
+        SampleFrameCount blockSize;
+
+    };
+
+}
+
+#endif
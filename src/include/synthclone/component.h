@@ -20,6 +20,7 @@
 #ifndef __SYNTHCLONE_COMPONENT_H__
 #define __SYNTHCLONE_COMPONENT_H__
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
@@ -124,9 +125,75 @@ namespace synthclone {
         virtual
         ~Component();
 
+        /**
+         * Gets the maximum number of times per second that reportProgress()
+         * will emit the Component::progressChanged() signal.
+         *
+         * @returns
+         *   The maximum rate.  Defaults to 30.
+         */
+
+        float
+        getMaximumProgressRate() const;
+
+        /**
+         * Gets the smallest change in progress that reportProgress() will
+         * emit the Component::progressChanged() signal for.
+         *
+         * @returns
+         *   The minimum step.  Defaults to 0.01.
+         */
+
+        float
+        getMinimumProgressStep() const;
+
+        /**
+         * Reports progress through the Component::progressChanged() signal,
+         * dropping updates that arrive too quickly or that are too small to be
+         * noticed.  Progress values of 0.0 and 1.0 are always emitted, unless
+         * they repeat the last emitted value.  Components that report progress
+         * often, like samplers and effects, should use this method instead of
+         * emitting Component::progressChanged() directly.
+         *
+         * @param progress
+         *   The progress amount, in the range [0.0, 1.0].
+         *
+         * @sa
+         *   setMaximumProgressRate(), setMinimumProgressStep()
+         */
+
+        void
+        reportProgress(float progress);
+
+        /**
+         * Sets the maximum number of times per second that reportProgress()
+         * will emit the Component::progressChanged() signal.
+         *
+         * @param rate
+         *   The maximum rate.  Must be greater than 0.
+         */
+
+        void
+        setMaximumProgressRate(float rate);
+
+        /**
+         * Sets the smallest change in progress that reportProgress() will
+         * emit the Component::progressChanged() signal for.
+         *
+         * @param step
+         *   The minimum step.  Must be in the range [0.0, 1.0].
+         */
+
+        void
+        setMinimumProgressStep(float step);
+
     private:
 
+        float lastProgress;
+        float maximumProgressRate;
+        float minimumProgressStep;
         QString name;
+        QElapsedTimer progressTimer;
 
     };
 
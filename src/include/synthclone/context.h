@@ -607,6 +607,30 @@ namespace synthclone {
         virtual bool
         isWetSamplePropertyVisible() const = 0;
 
+        /**
+         * Gets a boolean indicating whether or not the xrun count property is
+         * visible.
+         *
+         * @returns
+         *   The boolean.
+         */
+
+        virtual bool
+        isXrunCountPropertyVisible() const = 0;
+
+        /**
+         * Gets a boolean indicating whether or not a Zone batch is active.
+         *
+         * @returns
+         *   The boolean.
+         *
+         * @sa
+         *   beginZoneBatch(), endZoneBatch()
+         */
+
+        virtual bool
+        isZoneBatchActive() const = 0;
+
         /**
          * Gets a boolean indicating whether or not a Zone is selected.
          *
@@ -948,6 +972,21 @@ namespace synthclone {
         virtual Zone *
         addZone(int index=-1) = 0;
 
+        /**
+         * Begins a Zone batch.  While a batch is active, the application
+         * defers updating its views in response to Zone additions, removals,
+         * moves, selection changes, and property changes until the batch is
+         * finished.  Call this before adding or removing a large number of
+         * Zones.  Batches can be nested; every call to this method must be
+         * matched by a call to endZoneBatch().
+         *
+         * @sa
+         *   endZoneBatch()
+         */
+
+        virtual void
+        beginZoneBatch() = 0;
+
         /**
          * Attempts to build all registered targets.
          */
@@ -983,6 +1022,17 @@ namespace synthclone {
         virtual void
         deactivateParticipant(const Participant *participant) = 0;
 
+        /**
+         * Ends a Zone batch started with beginZoneBatch().  When the outermost
+         * batch ends, the application updates its views in one pass.
+         *
+         * @sa
+         *   beginZoneBatch()
+         */
+
+        virtual void
+        endZoneBatch() = 0;
+
         /**
          * Loads a `synthclone` session.  The currently loaded session will be
          * unloaded first.  This call will NOT prompt the user.
@@ -1211,6 +1261,19 @@ namespace synthclone {
         virtual void
         removeZone(int index) = 0;
 
+        /**
+         * Reorders the Zone list in one operation.  Unlike a series of
+         * moveZone() calls, this emits a single zonesReordered() signal.
+         *
+         * @param indexes
+         *   The new order of the Zone list.  Each element is the current index
+         *   of the Zone that will be at the element's position.  The list must
+         *   contain every Zone index exactly once.
+         */
+
+        virtual void
+        reorderZones(const QList<int> &indexes) = 0;
+
         /**
          * Reports a session error.  The application responds by showing an
          * error dialog.
@@ -1453,6 +1516,16 @@ namespace synthclone {
         virtual void
         setWetSamplePropertyVisible(bool visible) = 0;
 
+        /**
+         * Sets the visibility of the xrun count property.
+         *
+         * @param visible
+         *   Whether or not the xrun count property should be visible.
+         */
+
+        virtual void
+        setXrunCountPropertyVisible(bool visible) = 0;
+
         /**
          * (De)selects a Zone.
          *
@@ -2973,6 +3046,16 @@ namespace synthclone {
         void
         wetSamplePropertyVisibilityChanged(bool visible);
 
+        /**
+         * Emitted when the visibility of the xrun count property is changed.
+         *
+         * @param visible
+         *   The visibility of the xrun count property.
+         */
+
+        void
+        xrunCountPropertyVisibilityChanged(bool visible);
+
         /**
          * Emitted when a Zone has been added to the Zone list.
          *
@@ -2986,6 +3069,27 @@ namespace synthclone {
         void
         zoneAdded(synthclone::Zone *zone, int index);
 
+        /**
+         * Emitted when the outermost Zone batch has ended.
+         *
+         * @sa
+         *   endZoneBatch()
+         */
+
+        void
+        zoneBatchFinished();
+
+        /**
+         * Emitted when a Zone batch has begun, and no other Zone batch was
+         * active.
+         *
+         * @sa
+         *   beginZoneBatch()
+         */
+
+        void
+        zoneBatchStarted();
+
         /**
          * Emitted when a Zone has been moved in the Zone list.
          *
@@ -3032,6 +3136,19 @@ namespace synthclone {
         zoneSelectionChanged(synthclone::Zone *zone, int index,
                              bool selected);
 
+        /**
+         * Emitted after the Zone list has been reordered by reorderZones() or
+         * sortZones().
+         *
+         * @param indexes
+         *   The new order of the Zone list.  Each element is the index the
+         *   Zone at the element's position had before the Zone list was
+         *   reordered.
+         */
+
+        void
+        zonesReordered(const QList<int> &indexes);
+
     protected:
 
         /**
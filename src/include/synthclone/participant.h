@@ -54,6 +54,25 @@ namespace synthclone {
         virtual void
         activate(Context &context, const QVariant &state=QVariant());
 
+        /**
+         * Creates a copy of an Effect created by this Participant.  The copy
+         * is not registered with the session; `synthclone` uses copies to
+         * apply effects to several zones at once, giving each effect thread
+         * its own Effect objects.  The caller takes ownership of the copy.
+         * The default implementation returns NULL, which indicates that
+         * effects created by this Participant can't be copied.  Effect chains
+         * that contain such effects are applied by a single thread.
+         *
+         * @param state
+         *   The state of the effect to copy, as returned by getState().
+         *
+         * @returns
+         *   The copy, or NULL if the effect can't be copied.
+         */
+
+        virtual Effect *
+        cloneEffect(const QVariant &state) const;
+
         /**
          * Unlinks the Participant from the application.  After returning from
          * this method, the Context object will be destroyed.
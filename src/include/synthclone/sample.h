@@ -20,29 +20,95 @@
 #ifndef __SYNTHCLONE_SAMPLE_H__
 #define __SYNTHCLONE_SAMPLE_H__
 
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
 namespace synthclone {
 
+    class SampleDataDevice;
     class SampleInputStream;
     class SampleOutputStream;
 
     /**
-     * Contains sample data.  Sample data is kept in a file to conserve memory.
-     * To access the sample data, use the SampleInputStream class.  To write
-     * sample data, use the SampleOutputStream class.
+     * Contains sample data.  Sample data is usually kept in a file to conserve
+     * memory.  Intermediate data that never needs to touch the file system can
+     * be kept in memory instead.  To access the sample data, use the
+     * SampleInputStream class.  To write sample data, use the
+     * SampleOutputStream class.
      */
 
     class Sample: public QObject {
 
         Q_OBJECT
 
+        friend class SampleDataDevice;
         friend class SampleInputStream;
         friend class SampleOutputStream;
 
     public:
 
+        /**
+         * Mechanisms that can be used to copy the data of one Sample into
+         * another.  When a Sample is constructed from another Sample, the
+         * fastest mechanism available on the platform and filesystem is
+         * used.
+         */
+
+        enum CopyMechanism {
+
+            /**
+             * The Sample was not constructed as a copy of another Sample.
+             */
+
+            COPYMECHANISM_NONE = 0,
+
+            /**
+             * Data was read into memory and written back out.
+             */
+
+            COPYMECHANISM_READ_WRITE,
+
+            /**
+             * Data was copied by the kernel with `sendfile`.
+             */
+
+            COPYMECHANISM_SENDFILE,
+
+            /**
+             * Data was copied by the kernel or filesystem with
+             * `copy_file_range`.
+             */
+
+            COPYMECHANISM_COPY_FILE_RANGE,
+
+            /**
+             * The file was cloned with a reflink (`FICLONE`), so the copy
+             * shares its data blocks with the original until either is
+             * modified.
+             */
+
+            COPYMECHANISM_CLONE,
+
+            /**
+             * The file was hard-linked to the original.  Only used when
+             * setHardLinksEnabled() has been called with `true`.
+             */
+
+            COPYMECHANISM_HARD_LINK
+
+        };
+
+        /**
+         * Contains the places where sample contents can be stored.
+         */
+
+        enum Storage {
+            STORAGE_FILE = 0,
+            STORAGE_MEMORY
+        };
+
         /**
          * Initializes an empty sample object.  Sample contents are stored in a
          * file in the system's temporary directory.  This constructor should
@@ -79,6 +145,25 @@ namespace synthclone {
         explicit
         Sample(const QString &path, bool temporary=false, QObject *parent=0);
 
+        /**
+         * Initializes an empty sample object with the given storage.  If the
+         * storage is STORAGE_FILE, then sample contents are stored in a
+         * temporary file that's removed when the sample object is deleted.  If
+         * the storage is STORAGE_MEMORY, then sample contents are kept in
+         * memory and never touch the file system, unless writing them would
+         * exceed the memory budget.  In that case, the contents are moved to a
+         * temporary file, and the storage changes to STORAGE_FILE.
+         *
+         * @param storage
+         *   The storage to use for the sample contents.
+         *
+         * @param parent
+         *   The parent object of the new sample.
+         */
+
+        explicit
+        Sample(Storage storage, QObject *parent=0);
+
         /**
          * Initializes a sample object.  Sample contents are stored in a file
          * in the system's temporary directory.
@@ -126,16 +211,91 @@ namespace synthclone {
 
         ~Sample();
 
+        /**
+         * Gets a boolean indicating whether or not copies of file-backed
+         * samples may be hard links to the original file.
+         *
+         * @returns
+         *   The boolean.
+         */
+
+        static bool
+        areHardLinksEnabled();
+
+        /**
+         * Creates a device that reads the encoded contents of this sample,
+         * whether they're stored in memory or in a file.  The device is not
+         * opened.
+         *
+         * @param parent
+         *   The parent object of the device.
+         *
+         * @returns
+         *   The device.  The caller takes ownership of the device.
+         */
+
+        QIODevice *
+        createDataDevice(QObject *parent=0) const;
+
+        /**
+         * Gets the mechanism used to copy data into this Sample when it was
+         * constructed.
+         *
+         * @returns
+         *   The mechanism, or COPYMECHANISM_NONE if the Sample was not
+         *   constructed from another Sample.
+         */
+
+        CopyMechanism
+        getCopyMechanism() const;
+
+        /**
+         * Gets the maximum number of bytes that all samples with
+         * STORAGE_MEMORY may hold in memory at once.
+         *
+         * @returns
+         *   The memory budget.
+         *
+         * @sa
+         *   setMemoryBudget()
+         */
+
+        static qint64
+        getMemoryBudget();
+
+        /**
+         * Gets the number of bytes currently held in memory by samples with
+         * STORAGE_MEMORY.
+         *
+         * @returns
+         *   The memory usage.
+         */
+
+        static qint64
+        getMemoryUsage();
+
         /**
          * Gets the path to the file holding this sample.
          *
          * @returns
-         *   The path.
+         *   The path.  If the sample is stored in memory, then the path is
+         *   empty.
          */
 
         QString
         getPath() const;
 
+        /**
+         * Gets the storage used for the contents of this sample.
+         *
+         * @returns
+         *   The storage.  A sample created with STORAGE_MEMORY reports
+         *   STORAGE_FILE after it has been moved to disk.
+         */
+
+        Storage
+        getStorage() const;
+
         /**
          * Returns a boolean indicating whether or not the file referenced by
          * this object will be deleted when this object is destroyed.
@@ -147,6 +307,34 @@ namespace synthclone {
         bool
         isTemporary() const;
 
+        /**
+         * Sets whether or not copies of file-backed samples may be hard links
+         * to the original file.  Hard links are the cheapest way to copy a
+         * sample, but both samples then share the same file, so this should
+         * only be enabled when sample files are never rewritten in place.
+         * Hard links are disabled by default.
+         *
+         * @param enabled
+         *   Whether or not hard links are enabled.
+         */
+
+        static void
+        setHardLinksEnabled(bool enabled);
+
+        /**
+         * Sets the maximum number of bytes that all samples with
+         * STORAGE_MEMORY may hold in memory at once.  When writing to a sample
+         * would exceed the budget, the sample is moved to a temporary file.
+         * Lowering the budget doesn't move samples that are already in memory.
+         * The default budget is 256 MiB.
+         *
+         * @param budget
+         *   The memory budget.  A budget of 0 stores all samples in files.
+         */
+
+        static void
+        setMemoryBudget(qint64 budget);
+
     public slots:
 
         /**
@@ -174,13 +362,29 @@ namespace synthclone {
 
     private:
 
+        bool
+        copyFileData(const Sample &sample);
+
         void
         initializeData(const Sample &sample);
 
         void
         initializeTemporaryPath();
 
+        void
+        releaseMemory();
+
+        bool
+        reserveMemory(qint64 bytes);
+
+        void
+        spill();
+
+        CopyMechanism copyMechanism;
+        QByteArray data;
         QString path;
+        qint64 reservedMemory;
+        Storage storage;
         bool temporary;
 
     };
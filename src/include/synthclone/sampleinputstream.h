@@ -28,7 +28,9 @@ namespace synthclone {
     /**
      * Used to read sample data from a sample file.  The object uses the
      * excellent libsndfile in its implementation, which can be found at
-     * http://www.mega-nerd.com/libsndfile/.
+     * http://www.mega-nerd.com/libsndfile/.  Uncompressed WAV, AIFF, and
+     * Wave64 files are memory-mapped, so that seeking is cheap and files that
+     * are read often are shared through the page cache.
      */
 
     class SampleInputStream: public SampleStream {
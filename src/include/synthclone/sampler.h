@@ -20,6 +20,8 @@
 #ifndef __SYNTHCLONE_SAMPLER_H__
 #define __SYNTHCLONE_SAMPLER_H__
 
+#include <QtCore/QList>
+
 #include <synthclone/component.h>
 #include <synthclone/samplerjob.h>
 #include <synthclone/samplestream.h>
@@ -49,6 +51,177 @@ namespace synthclone {
         virtual void
         abortJob() = 0;
 
+        /**
+         * Gives the calling thread realtime scheduling at the priority
+         * returned by getRealtimePriority().  Samplers call this from the
+         * helper threads that service their audio callbacks, so that a busy
+         * application can't keep those threads from emptying the callbacks'
+         * ring buffers.  If the realtime priority is 0, then this method does
+         * nothing.
+         *
+         * @throws
+         *   Error if the thread can't be given realtime scheduling, which is
+         *   usually because the user doesn't have the privileges to do so.
+         *
+         * @sa
+         *   lockRealtimeMemory(), setRealtimePriority()
+         */
+
+        static void
+        acquireRealtimePriority();
+
+        /**
+         * Gets the realtime scheduling priority of sampler helper threads.
+         *
+         * @returns
+         *   The priority, from 1 to 99.  0 means that helper threads run with
+         *   normal scheduling.
+         *
+         * @sa
+         *   acquireRealtimePriority(), setRealtimePriority()
+         */
+
+        static int
+        getRealtimePriority();
+
+        /**
+         * Gets the amount of time that the signal must stay below the silence
+         * threshold before a sampler may stop capturing a release.
+         *
+         * @returns
+         *   The hold time, in seconds.
+         *
+         * @sa
+         *   getSilenceThreshold(), setSilenceHoldTime()
+         */
+
+        static float
+        getSilenceHoldTime();
+
+        /**
+         * Gets the amplitude below which a sampler treats the signal as
+         * silent when it captures a release.  If the threshold is greater
+         * than 0, then samplers that support silence detection record the
+         * release along with the sample when they run a
+         * SamplerJob::TYPE_SAMPLE job.  The release ends as soon as every
+         * channel has stayed below the threshold for the hold time, or when
+         * Zone::getReleaseTime() has passed, whichever comes first.  If the
+         * threshold is 0, then the release isn't recorded, and samplers wait
+         * for the full release time.
+         *
+         * @returns
+         *   The threshold, as a linear amplitude from 0 to 1.
+         *
+         * @sa
+         *   getSilenceHoldTime(), setSilenceThreshold()
+         */
+
+        static float
+        getSilenceThreshold();
+
+        /**
+         * Gets a boolean indicating whether or not zones on the given MIDI
+         * channel can be sampled in parallel with zones on other MIDI
+         * channels.  A sampler would return true if it records the audio
+         * for the given MIDI channel from inputs that are separate from the
+         * inputs used for other channels.  The default implementation
+         * returns false.
+         *
+         * @param channel
+         *   The MIDI channel, from 1 to 16.
+         *
+         * @returns
+         *   The boolean.
+         *
+         * @sa
+         *   startParallelJobs()
+         */
+
+        virtual bool
+        isParallelChannel(MIDIData channel) const;
+
+        /**
+         * Gets a boolean indicating whether or not the sampler can execute a
+         * sweep.  The default implementation returns false.
+         *
+         * @returns
+         *   The boolean.
+         *
+         * @sa
+         *   startSweep()
+         */
+
+        virtual bool
+        isSweepSupported() const;
+
+        /**
+         * Locks a buffer that's accessed from an audio callback into physical
+         * memory, faulting in its pages, so that the callback never waits for
+         * the buffer to be paged in.  If the realtime priority is 0, then this
+         * method does nothing.
+         *
+         * @param data
+         *   The start of the buffer.
+         *
+         * @param size
+         *   The size of the buffer, in bytes.
+         *
+         * @throws
+         *   Error if the buffer can't be locked.
+         *
+         * @sa
+         *   unlockRealtimeMemory()
+         */
+
+        static void
+        lockRealtimeMemory(void *data, size_t size);
+
+        /**
+         * Sets the realtime scheduling priority of sampler helper threads.
+         * Samplers also lock the buffers used by their audio callbacks into
+         * memory when the priority is set.  The default priority is 0.
+         *
+         * @param priority
+         *   The priority, from 1 to 99, or 0 to run helper threads with normal
+         *   scheduling.
+         *
+         * @sa
+         *   getRealtimePriority()
+         */
+
+        static void
+        setRealtimePriority(int priority);
+
+        /**
+         * Sets the amount of time that the signal must stay below the silence
+         * threshold before a sampler may stop capturing a release.  The
+         * default hold time is 0.1 seconds.
+         *
+         * @param time
+         *   The hold time, in seconds.
+         *
+         * @sa
+         *   getSilenceHoldTime()
+         */
+
+        static void
+        setSilenceHoldTime(float time);
+
+        /**
+         * Sets the amplitude below which a sampler treats the signal as
+         * silent when it captures a release.  The default threshold is 0,
+         * which disables silence detection.
+         *
+         * @param threshold
+         *   The threshold, as a linear amplitude from 0 to 1.
+         *
+         * @sa
+         *   getSilenceThreshold()
+         */
+
+        static void
+        setSilenceThreshold(float threshold);
+
         /**
          * Starts a new job.  Jobs should be run asynchronously, and should be
          * able to be aborted within a reasonable time interval.  How the job
@@ -134,6 +307,88 @@ namespace synthclone {
         virtual void
         startJob(const SamplerJob &job, SampleStream &stream) = 0;
 
+        /**
+         * Starts several sampling jobs at once.  Every job is run as if it
+         * were started with startJob(), except that all of the jobs start at
+         * the same time, and each job records from the inputs assigned to its
+         * zone's MIDI channel.  The zones of the jobs are on different MIDI
+         * channels, and isParallelChannel() returns true for each of them.
+         *
+         * The jobs are run asynchronously.  When every job is complete, or if
+         * the jobs are aborted or any job fails, the sampler emits
+         * jobCompleted(), jobAborted(), or jobError() respectively, exactly
+         * once for all of the jobs.  The jobs can be aborted with abortJob().
+         *
+         * The default implementation throws an Error.
+         *
+         * @param jobs
+         *   The jobs to run.  Every job is of type SamplerJob::TYPE_SAMPLE.
+         *   The list contains at least two jobs.
+         *
+         * @param streams
+         *   A SampleOutputStream for each job, in the same order as the jobs.
+         *   Use qobject_cast to cast the objects to the appropriate type.
+         */
+
+        virtual void
+        startParallelJobs(const QList<const SamplerJob *> &jobs,
+                          const QList<SampleStream *> &streams);
+
+        /**
+         * Starts a sweep.  A sweep samples several zones in one continuous
+         * recording, so that the per-job overhead of startJob() is paid once
+         * for the whole batch.
+         *
+         * Each zone occupies a span of the recording that is
+         * `sampleFrames + releaseFrames` long, where `sampleFrames` and
+         * `releaseFrames` are the zone's sample time and release time
+         * multiplied by the stream's sample rate and truncated to an integer.
+         * The first zone's span starts at frame 0, and each following zone's
+         * span starts where the previous span ends.  At the start of a span,
+         * the sampler sends the MIDI messages that it would send before
+         * sampling the zone with startJob().  At `sampleFrames`, it sends the
+         * note off message, and at the end of the span, it sends the all
+         * sound off and reset all controllers messages.  The sampler records
+         * every frame of every span, including the release, to the stream.
+         * The recording starts after the sampler's MIDI-to-audio latency, as
+         * the capture of a zone sampled with startJob() does, so every span
+         * of the recording starts when its zone's audio arrives.  The caller
+         * uses the span offsets to slice the recording.
+         *
+         * Sweeps are run asynchronously.  When the sweep is complete, aborted,
+         * or fails, the sampler emits jobCompleted(), jobAborted(), or
+         * jobError() respectively, exactly once for the whole sweep.  A sweep
+         * can be aborted with abortJob().
+         *
+         * This method is only called if isSweepSupported() returns true.  The
+         * default implementation throws an Error.
+         *
+         * @param jobs
+         *   The jobs to sample.  Every job is of type SamplerJob::TYPE_SAMPLE.
+         *   The list is not empty.
+         *
+         * @param stream
+         *   A SampleOutputStream that receives the recording.  Use
+         *   qobject_cast to cast the object to the appropriate type.
+         */
+
+        virtual void
+        startSweep(const QList<const SamplerJob *> &jobs,
+                   SampleStream &stream);
+
+        /**
+         * Unlocks a buffer that was locked with lockRealtimeMemory().
+         *
+         * @param data
+         *   The start of the buffer.
+         *
+         * @param size
+         *   The size of the buffer, in bytes.
+         */
+
+        static void
+        unlockRealtimeMemory(void *data, size_t size);
+
     signals:
 
         /**
@@ -160,6 +415,17 @@ namespace synthclone {
         void
         jobError(const QString &message);
 
+        /**
+         * Emitted right before jobCompleted() with the number of times the
+         * sampler's audio or MIDI buffers overflowed or underflowed while it
+         * was capturing audio for the job.  The session uses the count to
+         * decide whether or not the job's Sample should be acquired again.
+         * Samplers that can't detect xruns don't emit this signal.
+         */
+
+        void
+        jobXrunsCounted(int count);
+
     protected:
 
         /**
@@ -240,6 +240,18 @@ namespace synthclone {
         virtual const Sample *
         getWetSample() const = 0;
 
+        /**
+         * Gets the number of xruns (buffer overflows and underflows) that the
+         * Sampler reported while the dry Sample was being acquired.  A
+         * non-zero count indicates that the dry Sample may contain dropouts.
+         *
+         * @returns
+         *   The xrun count.
+         */
+
+        virtual int
+        getXrunCount() const = 0;
+
         /**
          * Gets a flag indicating whether or not this Zone object's dry Sample
          * is stale.  If a dry Sample is stale, it means that the parameters
@@ -543,6 +555,16 @@ namespace synthclone {
         void
         wetSampleStaleChanged(bool stale);
 
+        /**
+         * Emitted when the xrun count is changed.
+         *
+         * @param count
+         *   The new xrun count.
+         */
+
+        void
+        xrunCountChanged(int count);
+
     protected:
 
         /**
@@ -0,0 +1,121 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QtCore/QScopedArrayPointer>
+
+#include <synthclone/blockeffect.h>
+#include <synthclone/util.h>
+
+using synthclone::BlockEffect;
+
+BlockEffect::BlockEffect(const QString &name, QObject *parent):
+    Effect(name, parent)
+{
+    blockSize = 8192;
+}
+
+BlockEffect::~BlockEffect()
+{
+    // Empty
+}
+
+synthclone::SampleFrameCount
+BlockEffect::getBlockSize() const
+{
+    return blockSize;
+}
+
+BlockEffect::Direction
+BlockEffect::getDirection() const
+{
+    return DIRECTION_FORWARD;
+}
+
+void
+BlockEffect::prepareBlocks(const Zone &/*zone*/,
+                           SampleInputStream &/*inputStream*/,
+                           SampleFrameCount &/*startFrame*/,
+                           SampleFrameCount &/*frames*/)
+{
+    // Empty
+}
+
+void
+BlockEffect::process(const Zone &zone, SampleInputStream &inputStream,
+                     SampleOutputStream &outputStream)
+{
+    SampleChannelCount channels = inputStream.getChannels();
+    CONFIRM(channels == outputStream.getChannels(),
+            tr("the channel counts of the streams are not equal"));
+
+    reportProgress(0.0);
+    SampleFrameCount totalFrames = inputStream.getFrames();
+    SampleFrameCount startFrame = 0;
+    SampleFrameCount frames = totalFrames;
+    prepareBlocks(zone, inputStream, startFrame, frames);
+    CONFIRM((startFrame >= 0) && (frames >= 0) &&
+            ((startFrame + frames) <= totalFrames),
+            tr("'%1', '%2': invalid frame range").arg(startFrame).arg(frames));
+
+    QScopedArrayPointer<float> dataPtr(new float[blockSize * channels]);
+    float *data = dataPtr.data();
+    bool backward = getDirection() == DIRECTION_BACKWARD;
+    if (! backward) {
+        inputStream.seek(startFrame, SampleStream::OFFSET_START);
+    }
+    SampleFrameCount framesRead;
+    SampleFrameCount offset;
+    SampleFrameCount size;
+    for (SampleFrameCount processed = 0; processed < frames;
+         processed += size) {
+        size = qMin(blockSize, frames - processed);
+        if (backward) {
+            offset = frames - (processed + size);
+            inputStream.seek(startFrame + offset,
+                             SampleStream::OFFSET_START);
+        } else {
+            offset = processed;
+        }
+        framesRead = inputStream.read(data, size);
+        CONFIRM(framesRead == size,
+                tr("unexpected end of sample at frame '%1'").
+                arg(startFrame + offset + framesRead));
+        processBlock(data, offset, size, channels);
+        outputStream.write(data, size);
+        reportProgress(static_cast<float>(processed + size) /
+                       static_cast<float>(frames));
+    }
+    reportProgress(0.0);
+    emit statusChanged("");
+}
+
+void
+BlockEffect::processBlock(float * /*data*/, SampleFrameCount /*offset*/,
+                          SampleFrameCount /*frames*/,
+                          SampleChannelCount /*channels*/)
+{
+    // Empty
+}
+
+void
+BlockEffect::setBlockSize(SampleFrameCount size)
+{
+    CONFIRM(size > 0, tr("'%1': invalid block size").arg(size));
+    blockSize = size;
+}
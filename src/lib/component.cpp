@@ -17,13 +17,19 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <cmath>
+
 #include <synthclone/component.h>
+#include <synthclone/util.h>
 
 using synthclone::Component;
 
 Component::Component(const QString &name, QObject *parent):
     QObject(parent)
 {
+    lastProgress = -1.0;
+    maximumProgressRate = 30.0;
+    minimumProgressStep = 0.01;
     this->name = name;
 }
 
@@ -32,12 +38,59 @@ Component::~Component()
     // Empty
 }
 
+float
+Component::getMaximumProgressRate() const
+{
+    return maximumProgressRate;
+}
+
+float
+Component::getMinimumProgressStep() const
+{
+    return minimumProgressStep;
+}
+
 QString
 Component::getName() const
 {
     return name;
 }
 
+void
+Component::reportProgress(float progress)
+{
+    if (progress == lastProgress) {
+        return;
+    }
+    if ((progress != 0.0) && (progress != 1.0) && progressTimer.isValid()) {
+        if (std::fabs(progress - lastProgress) < minimumProgressStep) {
+            return;
+        }
+        if (progressTimer.elapsed() <
+            static_cast<qint64>(1000.0 / maximumProgressRate)) {
+            return;
+        }
+    }
+    lastProgress = progress;
+    progressTimer.start();
+    emit progressChanged(progress);
+}
+
+void
+Component::setMaximumProgressRate(float rate)
+{
+    CONFIRM(rate > 0.0, tr("'%1': invalid progress rate").arg(rate));
+    maximumProgressRate = rate;
+}
+
+void
+Component::setMinimumProgressStep(float step)
+{
+    CONFIRM((step >= 0.0) && (step <= 1.0),
+            tr("'%1': invalid progress step").arg(step));
+    minimumProgressStep = step;
+}
+
 void
 Component::setName(const QString &name)
 {
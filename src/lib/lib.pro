@@ -14,7 +14,10 @@ isEmpty(MAKEDIR) {
 
 DESTDIR = $${BUILDDIR}/$${SYNTHCLONE_LIBRARY_SUFFIX}
 HEADERS += closeeventfilter.h \
+    sampledatadevice.h \
     samplefile.h \
+    samplemapping.h \
+    ../include/synthclone/blockeffect.h \
     ../include/synthclone/component.h \
     ../include/synthclone/context.h \
     ../include/synthclone/designerview.h \
@@ -49,7 +52,8 @@ OBJECTS_DIR = $${MAKEDIR}/lib
 QT += uitools
 RCC_DIR = $${MAKEDIR}/lib
 RESOURCES += lib.qrc
-SOURCES += closeeventfilter.cpp \
+SOURCES += blockeffect.cpp \
+    closeeventfilter.cpp \
     component.cpp \
     context.cpp \
     designerview.cpp \
@@ -64,7 +68,9 @@ SOURCES += closeeventfilter.cpp \
     registration.cpp \
     sample.cpp \
     samplecopier.cpp \
+    sampledatadevice.cpp \
     samplefile.cpp \
+    samplemapping.cpp \
     sampleinputstream.cpp \
     sampleoutputstream.cpp \
     sampler.cpp \
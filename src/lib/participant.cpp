@@ -58,6 +58,12 @@ Participant::activate(Context &/*context*/, const QVariant &/*state*/)
     // Empty
 }
 
+synthclone::Effect *
+Participant::cloneEffect(const QVariant &/*state*/) const
+{
+    return 0;
+}
+
 void
 Participant::deactivate(Context &/*context*/)
 {
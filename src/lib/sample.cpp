@@ -17,33 +17,159 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(SYNTHCLONE_PLATFORM_UNIX) && defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QBuffer>
 #include <QtCore/QDebug>
 #include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
 #include <QtCore/QTemporaryFile>
 
 #include <synthclone/error.h>
 #include <synthclone/sample.h>
+#include <synthclone/util.h>
 
 using synthclone::Sample;
 
+// Largest amount of data handed to the kernel in a single copy call.
+static const qint64 KERNEL_COPY_CHUNK_SIZE = 64 * 1024 * 1024;
+
+// Size of the buffer used when data is copied through user space.
+static const qint64 READ_WRITE_CHUNK_SIZE = 1024 * 1024;
+
+static QAtomicInt hardLinksEnabled(0);
+
+static qint64 memoryBudget = 256 * 1024 * 1024;
+static QMutex memoryMutex;
+static qint64 memoryUsage = 0;
+
+#if defined(SYNTHCLONE_PLATFORM_UNIX) && defined(__linux__)
+
+static bool
+copyWithCopyFileRange(int source, int destination, qint64 size)
+{
+#ifdef __NR_copy_file_range
+    loff_t sourceOffset = 0;
+    loff_t destinationOffset = 0;
+    while (sourceOffset < size) {
+        long count = syscall(__NR_copy_file_range, source, &sourceOffset,
+                             destination, &destinationOffset,
+                             static_cast<size_t>
+                             (qMin(size - sourceOffset,
+                                   KERNEL_COPY_CHUNK_SIZE)), 0);
+        if (count <= 0) {
+            if ((count == -1) && (errno == EINTR)) {
+                continue;
+            }
+            return false;
+        }
+    }
+    return true;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(destination);
+    Q_UNUSED(size);
+    return false;
+#endif
+}
+
+static bool
+copyWithSendFile(int source, int destination, qint64 size)
+{
+    // `sendfile` writes at the current position of the destination.
+    if ((ftruncate(destination, 0) == -1) ||
+        (lseek(destination, 0, SEEK_SET) == -1)) {
+        return false;
+    }
+    off_t offset = 0;
+    while (offset < size) {
+        ssize_t count =
+            sendfile(destination, source, &offset,
+                     static_cast<size_t>(qMin(size - offset,
+                                              KERNEL_COPY_CHUNK_SIZE)));
+        if (count <= 0) {
+            if ((count == -1) && (errno == EINTR)) {
+                continue;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+cloneFile(int source, int destination)
+{
+#ifdef FICLONE
+    return ioctl(destination, FICLONE, source) == 0;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(destination);
+    return false;
+#endif
+}
+
+#endif
+
 Sample::Sample(bool temporary, QObject *parent):
     QObject(parent)
 {
+    copyMechanism = COPYMECHANISM_NONE;
+    reservedMemory = 0;
     initializeTemporaryPath();
+    storage = STORAGE_FILE;
     this->temporary = temporary;
 }
 
 Sample::Sample(const QString &path, bool temporary, QObject *parent):
     QObject(parent)
 {
+    copyMechanism = COPYMECHANISM_NONE;
+    reservedMemory = 0;
     this->path = path;
+    storage = STORAGE_FILE;
     this->temporary = temporary;
 }
 
+Sample::Sample(Storage storage, QObject *parent):
+    QObject(parent)
+{
+    copyMechanism = COPYMECHANISM_NONE;
+    reservedMemory = 0;
+    switch (storage) {
+    case STORAGE_FILE:
+        initializeTemporaryPath();
+        break;
+    case STORAGE_MEMORY:
+        break;
+    default:
+        CONFIRM(false, tr("'%1': invalid sample storage").arg(storage));
+    }
+    this->storage = storage;
+    temporary = true;
+}
+
 Sample::Sample(const Sample &sample, bool temporary, QObject *parent):
     QObject(parent)
 {
+    copyMechanism = COPYMECHANISM_NONE;
+    reservedMemory = 0;
     initializeTemporaryPath();
+    storage = STORAGE_FILE;
     initializeData(sample);
     this->temporary = temporary;
 }
@@ -52,13 +178,20 @@ Sample::Sample(const Sample &sample, const QString &path, bool temporary,
                QObject *parent):
     QObject(parent)
 {
+    copyMechanism = COPYMECHANISM_NONE;
+    reservedMemory = 0;
     this->path = path;
+    storage = STORAGE_FILE;
     initializeData(sample);
     this->temporary = temporary;
 }
 
 Sample::~Sample()
 {
+    if (storage == STORAGE_MEMORY) {
+        releaseMemory();
+        return;
+    }
     QFile file(path);
     if (temporary && file.exists()) {
         if (! file.remove()) {
@@ -68,12 +201,109 @@ Sample::~Sample()
     }
 }
 
+bool
+Sample::areHardLinksEnabled()
+{
+    return hardLinksEnabled.load();
+}
+
+bool
+Sample::copyFileData(const Sample &sample)
+{
+
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+    QByteArray destinationPath = QFile::encodeName(path);
+    QByteArray sourcePath = QFile::encodeName(sample.path);
+    if (hardLinksEnabled.load()) {
+        if (((unlink(destinationPath.constData()) == 0) ||
+             (errno == ENOENT)) &&
+            (link(sourcePath.constData(), destinationPath.constData()) == 0)) {
+            copyMechanism = COPYMECHANISM_HARD_LINK;
+            return true;
+        }
+    }
+
+#if defined(SYNTHCLONE_PLATFORM_UNIX) && defined(__linux__)
+    int source = open(sourcePath.constData(), O_RDONLY);
+    if (source == -1) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(source, &status) == -1) {
+        close(source);
+        return false;
+    }
+    int destination = open(destinationPath.constData(),
+                           O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (destination == -1) {
+        close(source);
+        return false;
+    }
+    qint64 size = static_cast<qint64>(status.st_size);
+    if (cloneFile(source, destination)) {
+        copyMechanism = COPYMECHANISM_CLONE;
+    } else if (copyWithCopyFileRange(source, destination, size)) {
+        copyMechanism = COPYMECHANISM_COPY_FILE_RANGE;
+    } else if (copyWithSendFile(source, destination, size)) {
+        copyMechanism = COPYMECHANISM_SENDFILE;
+    }
+    bool closed = close(destination) == 0;
+    close(source);
+    return closed && (copyMechanism != COPYMECHANISM_NONE);
+#else
+    return false;
+#endif
+
+#else
+    Q_UNUSED(sample);
+    return false;
+#endif
+
+}
+
+QIODevice *
+Sample::createDataDevice(QObject *parent) const
+{
+    if (storage == STORAGE_MEMORY) {
+        QBuffer *buffer = new QBuffer(parent);
+        buffer->setData(data);
+        return buffer;
+    }
+    return new QFile(path, parent);
+}
+
+Sample::CopyMechanism
+Sample::getCopyMechanism() const
+{
+    return copyMechanism;
+}
+
+qint64
+Sample::getMemoryBudget()
+{
+    QMutexLocker locker(&memoryMutex);
+    return memoryBudget;
+}
+
+qint64
+Sample::getMemoryUsage()
+{
+    QMutexLocker locker(&memoryMutex);
+    return memoryUsage;
+}
+
 QString
 Sample::getPath() const
 {
     return path;
 }
 
+Sample::Storage
+Sample::getStorage() const
+{
+    return storage;
+}
+
 void
 Sample::initializeData(const Sample &sample)
 {
@@ -81,11 +311,25 @@ Sample::initializeData(const Sample &sample)
     QString message;
     QFile sourceFile(sample.path);
 
+    if ((sample.storage == STORAGE_FILE) && copyFileData(sample)) {
+        return;
+    }
+    copyMechanism = COPYMECHANISM_READ_WRITE;
     if (! destinationFile.open(QFile::WriteOnly)) {
         message = tr("could not open '%1': %2").
             arg(path, destinationFile.errorString());
         throw Error(message);
     }
+    if (sample.storage == STORAGE_MEMORY) {
+        if (destinationFile.write(sample.data) != sample.data.size()) {
+            message = tr("could not write to '%1': %2").
+                arg(path, destinationFile.errorString());
+            destinationFile.close();
+            throw Error(message);
+        }
+        destinationFile.close();
+        return;
+    }
     if (! sourceFile.open(QFile::ReadOnly)) {
         destinationFile.close();
         message = tr("could not open '%1': %2").
@@ -94,11 +338,17 @@ Sample::initializeData(const Sample &sample)
     }
 
     for (;;) {
-        QByteArray data = sourceFile.read(8192);
+        QByteArray data = sourceFile.read(READ_WRITE_CHUNK_SIZE);
         if (data.isEmpty()) {
             break;
         }
-        destinationFile.write(data);
+        if (destinationFile.write(data) != data.size()) {
+            message = tr("could not write to '%1': %2").
+                arg(path, destinationFile.errorString());
+            destinationFile.close();
+            sourceFile.close();
+            throw Error(message);
+        }
     }
 
     destinationFile.close();
@@ -125,6 +375,40 @@ Sample::isTemporary() const
     return temporary;
 }
 
+void
+Sample::releaseMemory()
+{
+    QMutexLocker locker(&memoryMutex);
+    memoryUsage -= reservedMemory;
+    reservedMemory = 0;
+}
+
+bool
+Sample::reserveMemory(qint64 bytes)
+{
+    QMutexLocker locker(&memoryMutex);
+    if ((memoryUsage + bytes) > memoryBudget) {
+        return false;
+    }
+    memoryUsage += bytes;
+    reservedMemory += bytes;
+    return true;
+}
+
+void
+Sample::setHardLinksEnabled(bool enabled)
+{
+    hardLinksEnabled.store(enabled ? 1 : 0);
+}
+
+void
+Sample::setMemoryBudget(qint64 budget)
+{
+    CONFIRM(budget >= 0, tr("'%1': invalid memory budget").arg(budget));
+    QMutexLocker locker(&memoryMutex);
+    memoryBudget = budget;
+}
+
 void
 Sample::setTemporary(bool temporary)
 {
@@ -133,3 +417,29 @@ Sample::setTemporary(bool temporary)
         emit temporaryChanged(temporary);
     }
 }
+
+void
+Sample::spill()
+{
+    CONFIRM(storage == STORAGE_MEMORY, tr("sample is not stored in memory"));
+    initializeTemporaryPath();
+    QFile file(path);
+    QString message;
+    if (! file.open(QFile::WriteOnly)) {
+        message = tr("could not open '%1': %2").arg(path, file.errorString());
+        path.clear();
+        throw Error(message);
+    }
+    if (file.write(data) != data.size()) {
+        message = tr("could not write to '%1': %2").
+            arg(path, file.errorString());
+        file.close();
+        file.remove();
+        path.clear();
+        throw Error(message);
+    }
+    file.close();
+    data.clear();
+    releaseMemory();
+    storage = STORAGE_FILE;
+}
@@ -0,0 +1,148 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstring>
+#include <limits>
+
+#include <synthclone/error.h>
+
+#include "sampledatadevice.h"
+
+using synthclone::SampleDataDevice;
+
+SampleDataDevice::SampleDataDevice(Sample &sample, QObject *parent):
+    QIODevice(parent),
+    sample(sample)
+{
+    file = 0;
+}
+
+SampleDataDevice::~SampleDataDevice()
+{
+    // Empty
+}
+
+void
+SampleDataDevice::close()
+{
+    if (file) {
+        file->close();
+    }
+    QIODevice::close();
+}
+
+bool
+SampleDataDevice::open(OpenMode mode)
+{
+    if (sample.storage == Sample::STORAGE_MEMORY) {
+        if (mode & Truncate) {
+            sample.data.clear();
+            sample.releaseMemory();
+        }
+    } else {
+        file = new QFile(sample.path, this);
+        if (! file->open(mode)) {
+            setErrorString(file->errorString());
+            return false;
+        }
+    }
+
+    // Buffering is disabled so that the device can switch to a file in the
+    // middle of a write without losing buffered data.
+    return QIODevice::open(mode | Unbuffered);
+}
+
+qint64
+SampleDataDevice::readData(char *data, qint64 maxSize)
+{
+    if (file) {
+        return file->read(data, maxSize);
+    }
+    qint64 position = pos();
+    qint64 count = qMin(maxSize, size() - position);
+    if (count <= 0) {
+        return 0;
+    }
+    std::memcpy(data, sample.data.constData() + position,
+                static_cast<size_t>(count));
+    return count;
+}
+
+bool
+SampleDataDevice::seek(qint64 position)
+{
+    if (! QIODevice::seek(position)) {
+        return false;
+    }
+    return file ? file->seek(position) : true;
+}
+
+qint64
+SampleDataDevice::size() const
+{
+    return file ? file->size() : static_cast<qint64>(sample.data.size());
+}
+
+bool
+SampleDataDevice::spill()
+{
+    try {
+        sample.spill();
+    } catch (Error &e) {
+        setErrorString(e.getMessage());
+        return false;
+    }
+    file = new QFile(sample.path, this);
+    if (! (file->open(QIODevice::ReadWrite) && file->seek(pos()))) {
+        setErrorString(file->errorString());
+        return false;
+    }
+    return true;
+}
+
+qint64
+SampleDataDevice::writeData(const char *data, qint64 maxSize)
+{
+    if (! file) {
+        qint64 position = pos();
+        qint64 oldSize = sample.data.size();
+        qint64 newSize = position + maxSize;
+        // QByteArray sizes are limited to the range of 'int'.
+        if ((newSize <= oldSize) ||
+            ((newSize <= std::numeric_limits<int>::max()) &&
+             sample.reserveMemory(newSize - oldSize))) {
+            if (newSize > oldSize) {
+                sample.data.resize(static_cast<int>(newSize));
+
+                // Fill any gap left by seeking past the end of the data.
+                if (position > oldSize) {
+                    std::memset(sample.data.data() + oldSize, 0,
+                                static_cast<size_t>(position - oldSize));
+                }
+            }
+            std::memcpy(sample.data.data() + position, data,
+                        static_cast<size_t>(maxSize));
+            return maxSize;
+        }
+        if (! spill()) {
+            return -1;
+        }
+    }
+    return file->write(data, maxSize);
+}
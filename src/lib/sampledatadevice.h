@@ -0,0 +1,72 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __SYNTHCLONE_SAMPLEDATADEVICE_H__
+#define __SYNTHCLONE_SAMPLEDATADEVICE_H__
+
+#include <QtCore/QFile>
+
+#include <synthclone/sample.h>
+
+namespace synthclone {
+
+    class SampleDataDevice: public QIODevice {
+
+        Q_OBJECT
+
+    public:
+
+        explicit
+        SampleDataDevice(Sample &sample, QObject *parent=0);
+
+        ~SampleDataDevice();
+
+        void
+        close();
+
+        bool
+        open(OpenMode mode);
+
+        bool
+        seek(qint64 position);
+
+        qint64
+        size() const;
+
+    protected:
+
+        qint64
+        readData(char *data, qint64 maxSize);
+
+        qint64
+        writeData(const char *data, qint64 maxSize);
+
+    private:
+
+        bool
+        spill();
+
+        QFile *file;
+        Sample &sample;
+
+    };
+
+}
+
+#endif
@@ -28,32 +28,75 @@
 #include <synthclone/util.h>
 
 #include "samplefile.h"
+#include "samplemapping.h"
 
 using synthclone::SampleFile;
 
+// Static functions
+
+sf_count_t
+SampleFile::getDeviceLength(void *userData)
+{
+    return static_cast<sf_count_t>(static_cast<QIODevice *>(userData)->size());
+}
+
+sf_count_t
+SampleFile::readDevice(void *buffer, sf_count_t count, void *userData)
+{
+    qint64 bytesRead = static_cast<QIODevice *>(userData)->
+        read(static_cast<char *>(buffer), static_cast<qint64>(count));
+    return static_cast<sf_count_t>((bytesRead < 0) ? 0 : bytesRead);
+}
+
+sf_count_t
+SampleFile::seekDevice(sf_count_t offset, int whence, void *userData)
+{
+    QIODevice *device = static_cast<QIODevice *>(userData);
+    qint64 position;
+    switch (whence) {
+    case SEEK_CUR:
+        position = device->pos() + offset;
+        break;
+    case SEEK_END:
+        position = device->size() + offset;
+        break;
+    case SEEK_SET:
+    default:
+        position = offset;
+    }
+    if ((position < 0) || (! device->seek(position))) {
+        return -1;
+    }
+    return static_cast<sf_count_t>(position);
+}
+
+sf_count_t
+SampleFile::tellDevice(void *userData)
+{
+    return static_cast<sf_count_t>(static_cast<QIODevice *>(userData)->pos());
+}
+
+sf_count_t
+SampleFile::writeDevice(const void *buffer, sf_count_t count, void *userData)
+{
+    qint64 bytesWritten = static_cast<QIODevice *>(userData)->
+        write(static_cast<const char *>(buffer), static_cast<qint64>(count));
+    return static_cast<sf_count_t>((bytesWritten < 0) ? 0 : bytesWritten);
+}
+
+// Class definition
+
 SampleFile::SampleFile(const QString &path, QObject *parent):
     QObject(parent)
 {
-    info.format = 0;
-    QByteArray pathBytes = path.toLocal8Bit();
-    handle = sf_open(pathBytes.data(), SFM_READ, &info);
-    if (! handle) {
-        QString message = tr("could not open '%1' for reading: %2").arg(path).
-            arg(sf_strerror(0));
-        throw synthclone::Error(message);
-    }
-    closed = false;
-    framesWritten = false;
-    this->path = path;
-    totalFramesValid = false;
-    writeMode = false;
+    initializeReadMode(path, 0);
 }
 
 SampleFile::SampleFile(const QString &path, SampleRate sampleRate,
                        SampleChannelCount channels, QObject *parent):
     QObject(parent)
 {
-    initializeWriteMode(path, sampleRate, channels, SampleStream::TYPE_WAV,
+    initializeWriteMode(path, 0, sampleRate, channels, SampleStream::TYPE_WAV,
                         SampleStream::SUBTYPE_FLOAT,
                         SampleStream::ENDIANTYPE_FILE);
 }
@@ -64,7 +107,27 @@ SampleFile::SampleFile(const QString &path, SampleRate sampleRate,
                        SampleStream::EndianType endianType, QObject *parent):
     QObject(parent)
 {
-    initializeWriteMode(path, sampleRate, channels, type, subType, endianType);
+    initializeWriteMode(path, 0, sampleRate, channels, type, subType,
+                        endianType);
+}
+
+SampleFile::SampleFile(QIODevice *device, const QString &name,
+                       QObject *parent):
+    QObject(parent)
+{
+    CONFIRM(device, tr("device is set to NULL"));
+    initializeReadMode(name, device);
+}
+
+SampleFile::SampleFile(QIODevice *device, const QString &name,
+                       SampleRate sampleRate, SampleChannelCount channels,
+                       SampleStream::Type type, SampleStream::SubType subType,
+                       SampleStream::EndianType endianType, QObject *parent):
+    QObject(parent)
+{
+    CONFIRM(device, tr("device is set to NULL"));
+    initializeWriteMode(name, device, sampleRate, channels, type, subType,
+                        endianType);
 }
 
 SampleFile::~SampleFile()
@@ -92,6 +155,10 @@ SampleFile::close()
         }
         write(samples, 1);
     }
+    if (mapping) {
+        delete mapping;
+        mapping = 0;
+    }
     int result = sf_close(handle);
     if (result) {
         QString message = tr("could not close '%1': %2").arg(path).
@@ -132,6 +199,9 @@ SampleFile::getFrames()
     //
     // This implementation is inefficient.  We should really try to minimize the
     // amount of times we call this function.
+    if (mapping) {
+        return mapping->getFrames();
+    }
     if (! totalFramesValid) {
         synthclone::SampleFrameCount currentFrame =
             seek(0, SampleStream::OFFSET_CURRENT);
@@ -265,7 +335,67 @@ SampleFile::getType() const
 }
 
 void
-SampleFile::initializeWriteMode(const QString &path, SampleRate sampleRate,
+SampleFile::initializeReadMode(const QString &path, QIODevice *device)
+{
+    info.format = 0;
+    if (device) {
+        SF_VIRTUAL_IO virtualIO;
+        virtualIO.get_filelen = getDeviceLength;
+        virtualIO.read = readDevice;
+        virtualIO.seek = seekDevice;
+        virtualIO.tell = tellDevice;
+        virtualIO.write = writeDevice;
+        handle = sf_open_virtual(&virtualIO, SFM_READ, &info, device);
+    } else {
+        QByteArray pathBytes = path.toLocal8Bit();
+        handle = sf_open(pathBytes.data(), SFM_READ, &info);
+    }
+    if (! handle) {
+        QString message = tr("could not open '%1' for reading: %2").arg(path).
+            arg(sf_strerror(0));
+        throw synthclone::Error(message);
+    }
+    closed = false;
+    framesWritten = false;
+    mapping = 0;
+    this->path = path;
+    totalFramesValid = false;
+    writeMode = false;
+
+    // Uncompressed WAV, AIFF, and Wave64 files are read through a memory
+    // mapping, which turns reads into conversions from the page cache and
+    // seeks into pointer arithmetic.  libsndfile is still used to read the
+    // format information, and is used for reads if the file can't be mapped.
+    if (! device) {
+        switch (getType()) {
+        case SampleStream::TYPE_AIFF:
+        case SampleStream::TYPE_W64:
+        case SampleStream::TYPE_WAV:
+        case SampleStream::TYPE_WAVEX:
+            mapping = SampleMapping::create(path, getSubType(), getChannels(),
+                                            this);
+            if (mapping) {
+                // Don't trust the mapping if it disagrees with libsndfile.
+                sf_count_t frames = sf_seek(handle, 0, SEEK_END);
+                sf_seek(handle, 0, SEEK_SET);
+                if (static_cast<sf_count_t>(mapping->getFrames()) != frames) {
+                    qWarning() << tr("'%1': mapped frame count doesn't match "
+                                     "libsndfile; not using mapping").
+                        arg(path);
+                    delete mapping;
+                    mapping = 0;
+                }
+            }
+            break;
+        default:
+            ;
+        }
+    }
+}
+
+void
+SampleFile::initializeWriteMode(const QString &path, QIODevice *device,
+                                SampleRate sampleRate,
                                 SampleChannelCount channels,
                                 SampleStream::Type type,
                                 SampleStream::SubType subType,
@@ -450,8 +580,18 @@ SampleFile::initializeWriteMode(const QString &path, SampleRate sampleRate,
     if (! sf_format_check(&info)) {
         throw Error(tr("format is not supported"));
     }
-    QByteArray pathBytes = path.toLocal8Bit();
-    handle = sf_open(pathBytes.data(), SFM_WRITE, &info);
+    if (device) {
+        SF_VIRTUAL_IO virtualIO;
+        virtualIO.get_filelen = getDeviceLength;
+        virtualIO.read = readDevice;
+        virtualIO.seek = seekDevice;
+        virtualIO.tell = tellDevice;
+        virtualIO.write = writeDevice;
+        handle = sf_open_virtual(&virtualIO, SFM_WRITE, &info, device);
+    } else {
+        QByteArray pathBytes = path.toLocal8Bit();
+        handle = sf_open(pathBytes.data(), SFM_WRITE, &info);
+    }
     if (! handle) {
         QString message = tr("could not open '%1' for writing: %2").arg(path).
             arg(sf_strerror(0));
@@ -459,6 +599,7 @@ SampleFile::initializeWriteMode(const QString &path, SampleRate sampleRate,
     }
     closed = false;
     framesWritten = false;
+    mapping = 0;
     this->path = path;
     totalFramesValid = false;
     writeMode = true;
@@ -476,6 +617,9 @@ SampleFile::read(float *buffer, SampleFrameCount frames)
     CONFIRM(buffer, tr("buffer is set to NULL"));
     CONFIRM(frames > 0, tr("'%1': invalid frames value").arg(frames));
 
+    if (mapping) {
+        return mapping->read(buffer, frames);
+    }
     sf_count_t readFrames =
         sf_readf_float(handle, buffer, static_cast<sf_count_t>(frames));
     if (readFrames <= 0) {
@@ -492,6 +636,9 @@ SampleFile::read(float *buffer, SampleFrameCount frames)
 synthclone::SampleFrameCount
 SampleFile::seek(SampleFrameCount frames, SampleStream::Offset offset)
 {
+    if (mapping) {
+        return mapping->seek(frames, offset);
+    }
     int whence;
     switch (offset) {
     case SampleStream::OFFSET_CURRENT:
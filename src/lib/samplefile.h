@@ -22,10 +22,14 @@
 
 #include <sndfile.h>
 
+#include <QtCore/QIODevice>
+
 #include <synthclone/samplestream.h>
 
 namespace synthclone {
 
+    class SampleMapping;
+
     class SampleFile: public QObject {
 
         Q_OBJECT
@@ -43,6 +47,13 @@ namespace synthclone {
                    SampleStream::SubType subType,
                    SampleStream::EndianType endianType, QObject *parent=0);
 
+        SampleFile(QIODevice *device, const QString &name, QObject *parent=0);
+
+        SampleFile(QIODevice *device, const QString &name,
+                   SampleRate sampleRate, SampleChannelCount channels,
+                   SampleStream::Type type, SampleStream::SubType subType,
+                   SampleStream::EndianType endianType, QObject *parent=0);
+
         ~SampleFile();
 
         virtual void
@@ -80,9 +91,27 @@ namespace synthclone {
 
     private:
 
+        static sf_count_t
+        getDeviceLength(void *userData);
+
+        static sf_count_t
+        readDevice(void *buffer, sf_count_t count, void *userData);
+
+        static sf_count_t
+        seekDevice(sf_count_t offset, int whence, void *userData);
+
+        static sf_count_t
+        tellDevice(void *userData);
+
+        static sf_count_t
+        writeDevice(const void *buffer, sf_count_t count, void *userData);
+
+        void
+        initializeReadMode(const QString &path, QIODevice *device);
+
         void
-        initializeWriteMode(const QString &path, SampleRate sampleRate,
-                            SampleChannelCount channels,
+        initializeWriteMode(const QString &path, QIODevice *device,
+                            SampleRate sampleRate, SampleChannelCount channels,
                             SampleStream::Type type,
                             SampleStream::SubType subType,
                             SampleStream::EndianType endianType);
@@ -91,6 +120,7 @@ namespace synthclone {
         bool framesWritten;
         SNDFILE *handle;
         SF_INFO info;
+        SampleMapping *mapping;
         QString path;
         synthclone::SampleFrameCount totalFrames;
         bool totalFramesValid;
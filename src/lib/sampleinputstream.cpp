@@ -17,6 +17,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <QtCore/QBuffer>
+
 #include <synthclone/sampleinputstream.h>
 
 #include "samplefile.h"
@@ -26,7 +28,14 @@ using synthclone::SampleInputStream;
 SampleInputStream::SampleInputStream(const Sample &sample, QObject *parent):
     SampleStream(parent)
 {
-    file = new SampleFile(sample.getPath(), this);
+    if (sample.storage == Sample::STORAGE_MEMORY) {
+        QBuffer *buffer = new QBuffer(this);
+        buffer->setData(sample.data);
+        buffer->open(QIODevice::ReadOnly);
+        file = new SampleFile(buffer, tr("in-memory sample"), this);
+    } else {
+        file = new SampleFile(sample.getPath(), this);
+    }
 }
 
 SampleInputStream::~SampleInputStream()
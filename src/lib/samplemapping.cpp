@@ -0,0 +1,379 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstring>
+
+#include <QtCore/QScopedPointer>
+#include <QtCore/QtEndian>
+
+#include <synthclone/error.h>
+#include <synthclone/util.h>
+
+#include "samplemapping.h"
+
+using synthclone::SampleMapping;
+
+// Static functions
+
+template<typename T>
+static void
+convertFloats(const uchar *source, float *destination, qint64 count,
+              bool bigEndian)
+{
+    if (bigEndian == (Q_BYTE_ORDER == Q_BIG_ENDIAN)) {
+        for (qint64 i = 0; i < count; i++) {
+            T value;
+            std::memcpy(&value, source + (i * sizeof(T)), sizeof(T));
+            destination[i] = static_cast<float>(value);
+        }
+        return;
+    }
+    for (qint64 i = 0; i < count; i++) {
+        T value;
+        uchar bytes[sizeof(T)];
+        const uchar *sample = source + (i * sizeof(T));
+        for (size_t j = 0; j < sizeof(T); j++) {
+            bytes[j] = sample[(sizeof(T) - 1) - j];
+        }
+        std::memcpy(&value, bytes, sizeof(T));
+        destination[i] = static_cast<float>(value);
+    }
+}
+
+template<typename T>
+static void
+convertIntegers(const uchar *source, float *destination, qint64 count,
+                bool bigEndian, float scale)
+{
+    if (bigEndian) {
+        for (qint64 i = 0; i < count; i++) {
+            destination[i] = static_cast<float>
+                (qFromBigEndian<T>(source + (i * sizeof(T)))) * scale;
+        }
+    } else {
+        for (qint64 i = 0; i < count; i++) {
+            destination[i] = static_cast<float>
+                (qFromLittleEndian<T>(source + (i * sizeof(T)))) * scale;
+        }
+    }
+}
+
+static void
+convert24BitIntegers(const uchar *source, float *destination, qint64 count,
+                     bool bigEndian)
+{
+    const float scale = 1.0 / 8388608.0;
+    const uchar *sample = source;
+    if (bigEndian) {
+        for (qint64 i = 0; i < count; i++, sample += 3) {
+            qint32 value = (static_cast<qint32>(sample[0]) << 24) |
+                (static_cast<qint32>(sample[1]) << 16) |
+                (static_cast<qint32>(sample[2]) << 8);
+            destination[i] = static_cast<float>(value >> 8) * scale;
+        }
+    } else {
+        for (qint64 i = 0; i < count; i++, sample += 3) {
+            qint32 value = (static_cast<qint32>(sample[2]) << 24) |
+                (static_cast<qint32>(sample[1]) << 16) |
+                (static_cast<qint32>(sample[0]) << 8);
+            destination[i] = static_cast<float>(value >> 8) * scale;
+        }
+    }
+}
+
+SampleMapping *
+SampleMapping::create(const QString &path, SampleStream::SubType subType,
+                      SampleChannelCount channels, QObject *parent)
+{
+    int sampleSize = getSampleSize(subType);
+    if ((! sampleSize) || (channels < 1)) {
+        return 0;
+    }
+    QScopedPointer<QFile> file(new QFile(path));
+    if (! file->open(QFile::ReadOnly)) {
+        return 0;
+    }
+    qint64 size = file->size();
+    if (size < 12) {
+        return 0;
+    }
+
+    // The mapping is released when the file is destroyed, so returning early
+    // doesn't leak the mapping.
+    const uchar *data = file->map(0, size);
+    if (! data) {
+        return 0;
+    }
+    bool bigEndian = false;
+    bool found = false;
+    qint64 length = 0;
+    qint64 offset = 0;
+    if (! std::memcmp(data + 8, "WAVE", 4)) {
+        if (! std::memcmp(data, "RIFF", 4)) {
+            found = findWAVData(data, size, false, offset, length);
+        } else if (! std::memcmp(data, "RIFX", 4)) {
+            bigEndian = true;
+            found = findWAVData(data, size, true, offset, length);
+        }
+    } else if (! std::memcmp(data, "FORM", 4)) {
+        found = findAIFFData(data, size, offset, length, bigEndian);
+    } else if (! std::memcmp(data, "riff", 4)) {
+        found = findW64Data(data, size, offset, length);
+    }
+    if (! found) {
+        return 0;
+    }
+    length = qMin(length, size - offset);
+    SampleFrameCount frames = static_cast<SampleFrameCount>
+        (length / (static_cast<qint64>(sampleSize) * channels));
+    SampleMapping *mapping =
+        new SampleMapping(file.data(), data + offset, bigEndian, subType,
+                          channels, frames, parent);
+    file.take()->setParent(mapping);
+    return mapping;
+}
+
+bool
+SampleMapping::findAIFFData(const uchar *data, qint64 size, qint64 &offset,
+                            qint64 &length, bool &bigEndian)
+{
+    bool compressed;
+    if (! std::memcmp(data + 8, "AIFF", 4)) {
+        compressed = false;
+    } else if (! std::memcmp(data + 8, "AIFC", 4)) {
+        compressed = true;
+    } else {
+        return false;
+    }
+    bool formatFound = ! compressed;
+    bool soundFound = false;
+    bigEndian = true;
+    for (qint64 position = 12; (position + 8) <= size;) {
+        const uchar *chunk = data + position;
+        qint64 chunkSize = qFromBigEndian<quint32>(chunk + 4);
+        qint64 body = position + 8;
+        if ((! std::memcmp(chunk, "COMM", 4)) && compressed) {
+
+            // AIFC files name their compression type after the standard
+            // COMM fields.  Only uncompressed types can be mapped.
+            if ((chunkSize < 22) || ((body + 22) > size)) {
+                return false;
+            }
+            const uchar *compression = data + body + 18;
+            if ((! std::memcmp(compression, "NONE", 4)) ||
+                (! std::memcmp(compression, "twos", 4)) ||
+                (! std::memcmp(compression, "fl32", 4)) ||
+                (! std::memcmp(compression, "FL32", 4)) ||
+                (! std::memcmp(compression, "fl64", 4)) ||
+                (! std::memcmp(compression, "FL64", 4))) {
+                bigEndian = true;
+            } else if (! std::memcmp(compression, "sowt", 4)) {
+                bigEndian = false;
+            } else {
+                return false;
+            }
+            formatFound = true;
+        } else if (! std::memcmp(chunk, "SSND", 4)) {
+            if ((chunkSize < 8) || ((body + 8) > size)) {
+                return false;
+            }
+            qint64 dataOffset = qFromBigEndian<quint32>(data + body);
+            if (chunkSize < (8 + dataOffset)) {
+                return false;
+            }
+            offset = body + 8 + dataOffset;
+            length = chunkSize - (8 + dataOffset);
+            soundFound = true;
+        }
+        if (formatFound && soundFound) {
+            return offset <= size;
+        }
+        position = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+bool
+SampleMapping::findW64Data(const uchar *data, qint64 size, qint64 &offset,
+                           qint64 &length)
+{
+    // Wave64 chunk IDs are GUIDs that start with the matching RIFF chunk ID.
+    // Chunk sizes include the 24-byte chunk header, and chunks are aligned to
+    // 8 bytes.
+    if ((size < 40) || std::memcmp(data + 24, "wave", 4)) {
+        return false;
+    }
+    for (qint64 position = 40; (position + 24) <= size;) {
+        const uchar *chunk = data + position;
+        qint64 chunkSize = static_cast<qint64>(qFromLittleEndian<quint64>
+                                               (chunk + 16));
+        if (chunkSize < 24) {
+            return false;
+        }
+        if (! std::memcmp(chunk, "data", 4)) {
+            offset = position + 24;
+            length = chunkSize - 24;
+            return true;
+        }
+        position += (chunkSize + 7) & ~static_cast<qint64>(7);
+    }
+    return false;
+}
+
+bool
+SampleMapping::findWAVData(const uchar *data, qint64 size, bool bigEndian,
+                           qint64 &offset, qint64 &length)
+{
+    for (qint64 position = 12; (position + 8) <= size;) {
+        const uchar *chunk = data + position;
+        qint64 chunkSize = bigEndian ?
+            qFromBigEndian<quint32>(chunk + 4) :
+            qFromLittleEndian<quint32>(chunk + 4);
+        qint64 body = position + 8;
+        if (! std::memcmp(chunk, "data", 4)) {
+            offset = body;
+            length = chunkSize;
+            return true;
+        }
+        position = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+int
+SampleMapping::getSampleSize(SampleStream::SubType subType)
+{
+    switch (subType) {
+    case SampleStream::SUBTYPE_PCM_S8:
+    case SampleStream::SUBTYPE_PCM_U8:
+        return 1;
+    case SampleStream::SUBTYPE_PCM_16:
+        return 2;
+    case SampleStream::SUBTYPE_PCM_24:
+        return 3;
+    case SampleStream::SUBTYPE_PCM_32:
+    case SampleStream::SUBTYPE_FLOAT:
+        return 4;
+    case SampleStream::SUBTYPE_DOUBLE:
+        return 8;
+    default:
+        ;
+    }
+    return 0;
+}
+
+// Class definition
+
+SampleMapping::SampleMapping(QFile *file, const uchar *data, bool bigEndian,
+                             SampleStream::SubType subType,
+                             SampleChannelCount channels,
+                             SampleFrameCount frames, QObject *parent):
+    QObject(parent)
+{
+    this->bigEndian = bigEndian;
+    this->channels = channels;
+    this->data = data;
+    this->file = file;
+    frameSize = static_cast<qint64>(getSampleSize(subType)) * channels;
+    this->frames = frames;
+    position = 0;
+    this->subType = subType;
+}
+
+SampleMapping::~SampleMapping()
+{
+    // The file is a child of this object, and unmaps its data when it's
+    // destroyed.
+}
+
+synthclone::SampleFrameCount
+SampleMapping::getFrames() const
+{
+    return frames;
+}
+
+synthclone::SampleFrameCount
+SampleMapping::read(float *buffer, SampleFrameCount frames)
+{
+    SampleFrameCount count = qMin(frames, this->frames - position);
+    if (count <= 0) {
+        return 0;
+    }
+    const uchar *source = data + (position * frameSize);
+    qint64 samples = static_cast<qint64>(count) * channels;
+    switch (subType) {
+    case SampleStream::SUBTYPE_PCM_S8:
+        for (qint64 i = 0; i < samples; i++) {
+            buffer[i] = static_cast<float>(static_cast<qint8>(source[i])) /
+                128.0;
+        }
+        break;
+    case SampleStream::SUBTYPE_PCM_U8:
+        for (qint64 i = 0; i < samples; i++) {
+            buffer[i] = (static_cast<float>(source[i]) - 128.0) / 128.0;
+        }
+        break;
+    case SampleStream::SUBTYPE_PCM_16:
+        convertIntegers<qint16>(source, buffer, samples, bigEndian,
+                                1.0 / 32768.0);
+        break;
+    case SampleStream::SUBTYPE_PCM_24:
+        convert24BitIntegers(source, buffer, samples, bigEndian);
+        break;
+    case SampleStream::SUBTYPE_PCM_32:
+        convertIntegers<qint32>(source, buffer, samples, bigEndian,
+                                1.0 / 2147483648.0);
+        break;
+    case SampleStream::SUBTYPE_FLOAT:
+        convertFloats<float>(source, buffer, samples, bigEndian);
+        break;
+    case SampleStream::SUBTYPE_DOUBLE:
+        convertFloats<double>(source, buffer, samples, bigEndian);
+        break;
+    default:
+        CONFIRM(false, tr("'%1': unexpected sub-type").arg(subType));
+    }
+    position += count;
+    return count;
+}
+
+synthclone::SampleFrameCount
+SampleMapping::seek(SampleFrameCount frames, SampleStream::Offset offset)
+{
+    SampleFrameCount newPosition;
+    switch (offset) {
+    case SampleStream::OFFSET_CURRENT:
+        newPosition = position + frames;
+        break;
+    case SampleStream::OFFSET_END:
+        newPosition = this->frames + frames;
+        break;
+    case SampleStream::OFFSET_START:
+    default:
+        newPosition = frames;
+    }
+    if ((newPosition < 0) || (newPosition > this->frames)) {
+        QString message = tr("could not set file position in '%1': '%2' is "
+                             "out of range").
+            arg(file->fileName()).arg(newPosition);
+        throw Error(message);
+    }
+    position = newPosition;
+    return position;
+}
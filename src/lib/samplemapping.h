@@ -0,0 +1,85 @@
+/*
+ * libsynthclone - a plugin API for `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation; either version 2.1 of the License, or (at your
+ * option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __SYNTHCLONE_SAMPLEMAPPING_H__
+#define __SYNTHCLONE_SAMPLEMAPPING_H__
+
+#include <QtCore/QFile>
+
+#include <synthclone/samplestream.h>
+
+namespace synthclone {
+
+    class SampleMapping: public QObject {
+
+        Q_OBJECT
+
+    public:
+
+        static SampleMapping *
+        create(const QString &path, SampleStream::SubType subType,
+               SampleChannelCount channels, QObject *parent=0);
+
+        ~SampleMapping();
+
+        SampleFrameCount
+        getFrames() const;
+
+        SampleFrameCount
+        read(float *buffer, SampleFrameCount frames);
+
+        SampleFrameCount
+        seek(SampleFrameCount frames, SampleStream::Offset offset);
+
+    private:
+
+        SampleMapping(QFile *file, const uchar *data, bool bigEndian,
+                      SampleStream::SubType subType,
+                      SampleChannelCount channels, SampleFrameCount frames,
+                      QObject *parent);
+
+        static bool
+        findAIFFData(const uchar *data, qint64 size, qint64 &offset,
+                     qint64 &length, bool &bigEndian);
+
+        static bool
+        findW64Data(const uchar *data, qint64 size, qint64 &offset,
+                    qint64 &length);
+
+        static bool
+        findWAVData(const uchar *data, qint64 size, bool bigEndian,
+                    qint64 &offset, qint64 &length);
+
+        static int
+        getSampleSize(SampleStream::SubType subType);
+
+        bool bigEndian;
+        SampleChannelCount channels;
+        const uchar *data;
+        QFile *file;
+        qint64 frameSize;
+        SampleFrameCount frames;
+        SampleFrameCount position;
+        SampleStream::SubType subType;
+
+    };
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <synthclone/sampleoutputstream.h>
 
+#include "sampledatadevice.h"
 #include "samplefile.h"
 
 using synthclone::SampleOutputStream;
@@ -28,7 +29,15 @@ SampleOutputStream::SampleOutputStream(Sample &sample, SampleRate sampleRate,
                                        QObject *parent):
     SampleStream(parent)
 {
-    file = new SampleFile(sample.getPath(), sampleRate, channels, this);
+    if (sample.storage == Sample::STORAGE_MEMORY) {
+        SampleDataDevice *device = new SampleDataDevice(sample, this);
+        device->open(QIODevice::ReadWrite | QIODevice::Truncate);
+        file = new SampleFile(device, tr("in-memory sample"), sampleRate,
+                              channels, TYPE_WAV, SUBTYPE_FLOAT,
+                              ENDIANTYPE_FILE, this);
+    } else {
+        file = new SampleFile(sample.getPath(), sampleRate, channels, this);
+    }
 }
 
 SampleOutputStream::SampleOutputStream(Sample &sample, SampleRate sampleRate,
@@ -37,8 +46,15 @@ SampleOutputStream::SampleOutputStream(Sample &sample, SampleRate sampleRate,
                                        QObject *parent):
     SampleStream(parent)
 {
-    file = new SampleFile(sample.getPath(), sampleRate, channels, type, subType,
-                          endianType, this);
+    if (sample.storage == Sample::STORAGE_MEMORY) {
+        SampleDataDevice *device = new SampleDataDevice(sample, this);
+        device->open(QIODevice::ReadWrite | QIODevice::Truncate);
+        file = new SampleFile(device, tr("in-memory sample"), sampleRate,
+                              channels, type, subType, endianType, this);
+    } else {
+        file = new SampleFile(sample.getPath(), sampleRate, channels, type,
+                              subType, endianType, this);
+    }
 }
 
 SampleOutputStream::~SampleOutputStream()
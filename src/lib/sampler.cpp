@@ -17,10 +17,27 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+#include <cerrno>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#elif defined(SYNTHCLONE_PLATFORM_WIN32)
+#include <windows.h>
+#endif
+
+#include <synthclone/error.h>
 #include <synthclone/sampler.h>
+#include <synthclone/util.h>
 
 using synthclone::Sampler;
 
+static int realtimePriority = 0;
+static float silenceHoldTime = 0.1;
+static float silenceThreshold = 0.0;
+
 Sampler::Sampler(const QString &name, QObject *parent):
     Component(name, parent)
 {
@@ -31,3 +48,136 @@ Sampler::~Sampler()
 {
     // Empty
 }
+
+void
+Sampler::acquireRealtimePriority()
+{
+    if (! realtimePriority) {
+        return;
+    }
+
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+    struct sched_param param;
+    param.sched_priority =
+        qBound(sched_get_priority_min(SCHED_FIFO), realtimePriority,
+               sched_get_priority_max(SCHED_FIFO));
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result) {
+        throw Error(tr("failed to acquire realtime priority: %1").
+                    arg(strerror(result)));
+    }
+#elif defined(SYNTHCLONE_PLATFORM_WIN32)
+    if (! SetThreadPriority(GetCurrentThread(),
+                            THREAD_PRIORITY_TIME_CRITICAL)) {
+        throw Error(tr("failed to acquire realtime priority: error %1").
+                    arg(GetLastError()));
+    }
+#endif
+
+}
+
+int
+Sampler::getRealtimePriority()
+{
+    return realtimePriority;
+}
+
+float
+Sampler::getSilenceHoldTime()
+{
+    return silenceHoldTime;
+}
+
+float
+Sampler::getSilenceThreshold()
+{
+    return silenceThreshold;
+}
+
+bool
+Sampler::isParallelChannel(MIDIData /*channel*/) const
+{
+    return false;
+}
+
+bool
+Sampler::isSweepSupported() const
+{
+    return false;
+}
+
+void
+Sampler::lockRealtimeMemory(void *data, size_t size)
+{
+    if ((! realtimePriority) || (! size)) {
+        return;
+    }
+
+    // Locking the buffer faults in all of its pages.
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+    if (mlock(data, size)) {
+        throw Error(tr("failed to lock memory: %1").arg(strerror(errno)));
+    }
+#elif defined(SYNTHCLONE_PLATFORM_WIN32)
+    if (! VirtualLock(data, size)) {
+        throw Error(tr("failed to lock memory: error %1").
+                    arg(GetLastError()));
+    }
+#endif
+
+}
+
+void
+Sampler::setRealtimePriority(int priority)
+{
+    CONFIRM((priority >= 0) && (priority <= 99),
+            tr("'%1': invalid realtime priority").arg(priority));
+    realtimePriority = priority;
+}
+
+void
+Sampler::setSilenceHoldTime(float time)
+{
+    CONFIRM(time >= 0.0, tr("'%1': invalid silence hold time").arg(time));
+    silenceHoldTime = time;
+}
+
+void
+Sampler::setSilenceThreshold(float threshold)
+{
+    CONFIRM((threshold >= 0.0) && (threshold <= 1.0),
+            tr("'%1': invalid silence threshold").arg(threshold));
+    silenceThreshold = threshold;
+}
+
+void
+Sampler::startParallelJobs(const QList<const SamplerJob *> &/*jobs*/,
+                           const QList<SampleStream *> &/*streams*/)
+{
+    throw Error(tr("sampler does not support parallel jobs"));
+}
+
+void
+Sampler::startSweep(const QList<const SamplerJob *> &/*jobs*/,
+                    SampleStream &/*stream*/)
+{
+    throw Error(tr("sampler does not support sweeps"));
+}
+
+void
+Sampler::unlockRealtimeMemory(void *data, size_t size)
+{
+    if (! size) {
+        return;
+    }
+
+    // Unlocking memory that isn't locked is harmless, so this doesn't depend
+    // on the realtime priority, which may have changed since the memory was
+    // locked.
+#if defined(SYNTHCLONE_PLATFORM_MACX) || defined(SYNTHCLONE_PLATFORM_UNIX)
+    munlock(data, size);
+#elif defined(SYNTHCLONE_PLATFORM_WIN32)
+    VirtualUnlock(data, size);
+#endif
+
+}
@@ -22,21 +22,26 @@
 
 #include <QtCore/QDebug>
 
-#include <QtCore/QScopedArrayPointer>
-
-#include <synthclone/samplecopier.h>
-
 #include "effect.h"
 
 Effect::Effect(const QString &name, QObject *parent):
-    synthclone::Effect(name, parent)
+    synthclone::BlockEffect(name, parent)
 {
     fadeInEnabled = true;
+    fadeInFrames = 0;
+    fadeInGainRatio = 1.0;
     fadeInStartVolume = -64.0;
     fadeInTime = 0.01;
     fadeOutEnabled = true;
     fadeOutEndVolume = -64.0;
+    fadeOutFrames = 0;
+    fadeOutGainRatio = 1.0;
+    fadeOutStartFrame = 0;
     fadeOutTime = 0.01;
+
+    // Blocks outside of the fades are copied without being touched, so large
+    // blocks make the copy of the middle of the sample cheap.
+    setBlockSize(65536);
 }
 
 Effect::~Effect()
@@ -44,6 +49,48 @@ Effect::~Effect()
     // Empty
 }
 
+void
+Effect::applyGains(float *data, synthclone::SampleFrameCount frames,
+                   synthclone::SampleChannelCount channels) const
+{
+    const float *gainData = gains.constData();
+    synthclone::SampleFrameCount i;
+    switch (channels) {
+    case 1:
+        for (i = 0; i < frames; i++) {
+            data[i] *= gainData[i];
+        }
+        break;
+    case 2:
+        for (i = 0; i < frames; i++) {
+            data[i * 2] *= gainData[i];
+            data[(i * 2) + 1] *= gainData[i];
+        }
+        break;
+    default:
+        for (i = 0; i < frames; i++) {
+            float gain = gainData[i];
+            float *frame = data + (i * channels);
+            for (int j = 0; j < channels; j++) {
+                frame[j] *= gain;
+            }
+        }
+    }
+}
+
+void
+Effect::fillGains(double gain, double ratio,
+                  synthclone::SampleFrameCount frames)
+{
+    // The curve is re-anchored with an exact gain at the start of every
+    // block, so rounding errors can't accumulate across blocks.
+    float *gainData = gains.data();
+    for (synthclone::SampleFrameCount i = 0; i < frames; i++) {
+        gainData[i] = static_cast<float>(gain);
+        gain *= ratio;
+    }
+}
+
 float
 Effect::getAmplitude(float dBFS) const
 {
@@ -75,15 +122,6 @@ Effect::getFadeOutTime() const
     return fadeOutTime;
 }
 
-void
-Effect::handleCopyProgress(synthclone::SampleFrameCount current,
-                           synthclone::SampleFrameCount /*total*/)
-{
-    emit progressChanged(static_cast<float>(copyStartFrame + current) /
-                         static_cast<float>(copyTotalFrames));
-}
-
-
 bool
 Effect::isFadeInEnabled() const
 {
@@ -97,15 +135,15 @@ Effect::isFadeOutEnabled() const
 }
 
 void
-Effect::process(const synthclone::Zone &/*zone*/,
-                synthclone::SampleInputStream &inputStream,
-                synthclone::SampleOutputStream &outputStream)
+Effect::prepareBlocks(const synthclone::Zone &/*zone*/,
+                      synthclone::SampleInputStream &inputStream,
+                      synthclone::SampleFrameCount &/*startFrame*/,
+                      synthclone::SampleFrameCount &frames)
 {
-    synthclone::SampleFrameCount frames = inputStream.getFrames();
     float sampleRate = static_cast<float>(inputStream.getSampleRate());
-    synthclone::SampleFrameCount fadeInFrames = fadeInEnabled ?
+    fadeInFrames = fadeInEnabled ?
         static_cast<synthclone::SampleFrameCount>(fadeInTime * sampleRate) : 0;
-    synthclone::SampleFrameCount fadeOutFrames = fadeOutEnabled ?
+    fadeOutFrames = fadeOutEnabled ?
         static_cast<synthclone::SampleFrameCount>(fadeOutTime * sampleRate) : 0;
     synthclone::SampleFrameCount totalFadeFrames = fadeInFrames + fadeOutFrames;
 
@@ -129,80 +167,43 @@ Effect::process(const synthclone::Zone &/*zone*/,
         qDebug() << "\t fade out frames:" << fadeOutFrames;
 
     }
+    fadeOutStartFrame = frames - fadeOutFrames;
+
+    // Volume changes linearly in dB over each fade, so consecutive gains
+    // differ by a constant ratio.
+    fadeInGainRatio = fadeInFrames ?
+        std::pow(10.0, -fadeInStartVolume / (20.0 * fadeInFrames)) : 1.0;
+    fadeOutGainRatio = fadeOutFrames ?
+        std::pow(10.0, fadeOutEndVolume / (20.0 * fadeOutFrames)) : 1.0;
+    gains.resize(static_cast<int>(getBlockSize()));
+    emit statusChanged(tr("Fading sample ..."));
+}
 
-    synthclone::SampleChannelCount channels = inputStream.getChannels();
-    QScopedArrayPointer<float> audioDataPtr(new float[channels]);
-    float *audioData = audioDataPtr.data();
-    synthclone::SampleFrameCount currentFrame = 0;
-    synthclone::SampleFrameCount framesRead;
-    float volume;
-    if (fadeInFrames) {
-
-        qDebug() << "\tapplying fade in ...";
-
-        emit statusChanged(tr("Creating fade-in of sample ..."));
-        for (; currentFrame < fadeInFrames; currentFrame++) {
-            framesRead = inputStream.read(audioData, 1);
-            assert(framesRead == 1);
-            volume = getAmplitude(fadeInStartVolume *
-                                  (1.0 - (static_cast<float>(currentFrame + 1) /
-                                          static_cast<float>(fadeInFrames))));
-            for (int i = 0; i < channels; i++) {
-                audioData[i] *= volume;
-            }
-            outputStream.write(audioData, 1);
-            emit progressChanged(static_cast<float>(currentFrame + 1) /
-                                 static_cast<float>(frames));
-        }
-    }
-    synthclone::SampleFrameCount fadeOutStartFrame = frames - fadeOutFrames;
-    synthclone::SampleFrameCount copyFrames = fadeOutStartFrame - currentFrame;
-
-    qDebug() << "\tcopy frames:" << copyFrames;
-    qDebug() << "\tfade out start frame:" << fadeOutStartFrame;
-
-    if (copyFrames) {
-
-        qDebug() << "copying frames ...";
-
-        emit statusChanged(tr("Writing sample ..."));
-        copyStartFrame = currentFrame;
-        copyTotalFrames = frames;
-        synthclone::SampleCopier copier;
-        connect(&copier,
-                SIGNAL(copyProgress(synthclone::SampleFrameCount,
-                                    synthclone::SampleFrameCount)),
-                SLOT(handleCopyProgress(synthclone::SampleFrameCount,
-                                        synthclone::SampleFrameCount)),
-                Qt::DirectConnection);
-        copier.copy(inputStream, outputStream, copyFrames);
+void
+Effect::processBlock(float *data, synthclone::SampleFrameCount offset,
+                     synthclone::SampleFrameCount frames,
+                     synthclone::SampleChannelCount channels)
+{
+    synthclone::SampleFrameCount end = offset + frames;
+    synthclone::SampleFrameCount count;
+    if (offset < fadeInFrames) {
+        count = qMin(end, fadeInFrames) - offset;
+        fillGains(getAmplitude(fadeInStartVolume *
+                               (1.0 - (static_cast<float>(offset + 1) /
+                                       static_cast<float>(fadeInFrames)))),
+                  fadeInGainRatio, count);
+        applyGains(data, count, channels);
     }
-    currentFrame += copyFrames;
-    if (fadeOutFrames) {
-
-        qDebug() << "\tapplying fade out ...";
-
-        emit statusChanged(tr("Creating fade-out of sample ..."));
-        for (; currentFrame < frames; currentFrame++) {
-            framesRead = inputStream.read(audioData, 1);
-            assert(framesRead == 1);
-            volume = getAmplitude(fadeOutEndVolume *
-                                  (static_cast<float>(currentFrame + 1 -
-                                                      fadeOutStartFrame) /
-                                   static_cast<float>(fadeOutFrames)));
-            for (int i = 0; i < channels; i++) {
-                audioData[i] *= volume;
-            }
-            outputStream.write(audioData, 1);
-            emit progressChanged(static_cast<float>(currentFrame + 1) /
-                                 static_cast<float>(frames));
-        }
+    if (end > fadeOutStartFrame) {
+        synthclone::SampleFrameCount first = qMax(offset, fadeOutStartFrame);
+        count = end - first;
+        fillGains(getAmplitude(fadeOutEndVolume *
+                               (static_cast<float>(first + 1 -
+                                                   fadeOutStartFrame) /
+                                static_cast<float>(fadeOutFrames))),
+                  fadeOutGainRatio, count);
+        applyGains(data + ((first - offset) * channels), count, channels);
     }
-    emit progressChanged(0.0);
-    emit statusChanged("");
-
-    qDebug() << "/Effect::process";
-
 }
 
 void
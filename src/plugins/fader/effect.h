@@ -20,9 +20,11 @@
 #ifndef __EFFECT_H__
 #define __EFFECT_H__
 
-#include <synthclone/effect.h>
+#include <QtCore/QVector>
 
-class Effect: public synthclone::Effect {
+#include <synthclone/blockeffect.h>
+
+class Effect: public synthclone::BlockEffect {
 
     Q_OBJECT
 
@@ -51,11 +53,6 @@ public:
     bool
     isFadeOutEnabled() const;
 
-    void
-    process(const synthclone::Zone &zone,
-            synthclone::SampleInputStream &inputStream,
-            synthclone::SampleOutputStream &outputStream);
-
 public slots:
 
     void
@@ -96,25 +93,43 @@ signals:
     void
     fadeOutTimeChanged(float time);
 
-private slots:
+protected:
+
+    void
+    prepareBlocks(const synthclone::Zone &zone,
+                  synthclone::SampleInputStream &inputStream,
+                  synthclone::SampleFrameCount &startFrame,
+                  synthclone::SampleFrameCount &frames);
 
     void
-    handleCopyProgress(synthclone::SampleFrameCount current,
-                       synthclone::SampleFrameCount total);
+    processBlock(float *data, synthclone::SampleFrameCount offset,
+                 synthclone::SampleFrameCount frames,
+                 synthclone::SampleChannelCount channels);
 
 private:
 
+    void
+    applyGains(float *data, synthclone::SampleFrameCount frames,
+               synthclone::SampleChannelCount channels) const;
+
+    void
+    fillGains(double gain, double ratio, synthclone::SampleFrameCount frames);
+
     float
     getAmplitude(float dBFS) const;
 
-    synthclone::SampleFrameCount copyStartFrame;
-    synthclone::SampleFrameCount copyTotalFrames;
     bool fadeInEnabled;
+    synthclone::SampleFrameCount fadeInFrames;
+    double fadeInGainRatio;
     float fadeInStartVolume;
     float fadeInTime;
     bool fadeOutEnabled;
     float fadeOutEndVolume;
+    synthclone::SampleFrameCount fadeOutFrames;
+    double fadeOutGainRatio;
+    synthclone::SampleFrameCount fadeOutStartFrame;
     float fadeOutTime;
+    QVector<float> gains;
 
 };
 
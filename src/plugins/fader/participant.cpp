@@ -130,6 +130,14 @@ Participant::configureEffect(Effect *effect)
     effectView.setVisible(true);
 }
 
+synthclone::Effect *
+Participant::cloneEffect(const QVariant &state) const
+{
+    Effect *effect = new Effect(tr("Fader"));
+    restoreEffectState(effect, state);
+    return effect;
+}
+
 void
 Participant::deactivate(synthclone::Context &context)
 {
@@ -214,7 +222,12 @@ Participant::handleUnregistration(QObject *obj)
 void
 Participant::restoreEffect(const QVariant &state)
 {
-    Effect *effect = addEffect();
+    restoreEffectState(addEffect(), state);
+}
+
+void
+Participant::restoreEffectState(Effect *effect, const QVariant &state) const
+{
     const QVariantMap map = state.toMap();
     effect->setFadeInEnabled(map.value("fadeInEnabled", true).toBool());
     effect->setFadeInStartVolume
@@ -328,7 +328,14 @@ Participant::handleImportViewPathSelection(const QStringList &paths)
     importer.setPath(path);
     importView.setVisible(false);
     if (path.count()) {
-        importer.import();
+        context->beginZoneBatch();
+        try {
+            importer.import();
+        } catch (...) {
+            context->endZoneBatch();
+            throw;
+        }
+        context->endZoneBatch();
     }
 }
 
@@ -21,6 +21,7 @@
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QLocale>
+#include <QtCore/QScopedPointer>
 
 #include <synthclone/error.h>
 #include <synthclone/samplecopier.h>
@@ -44,7 +45,7 @@ Target::~Target()
 void
 Target::build(const QList<synthclone::Zone *> &zones)
 {
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     QString message;
     if (path.isEmpty()) {
         message = tr("the build path is not set");
@@ -77,7 +78,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
     int zoneCount = zones.count();
     QMultiMap<ZoneKey, const synthclone::Zone *> zoneMap;
     for (int i = 0; i < zoneCount; i++) {
-        emit progressChanged((static_cast<float>(i) / zoneCount) * 0.5);
+        reportProgress((static_cast<float>(i) / zoneCount) * 0.5);
         synthclone::Zone *zone = zones[i];
         const synthclone::Sample *sample = zone->getWetSample();
         if (! sample) {
@@ -91,7 +92,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
         }
         zoneMap.insert(ZoneKey(*zone), zone);
     }
-    emit progressChanged(0.5);
+    reportProgress(0.5);
 
     QList<ZoneKey> keys = zoneMap.uniqueKeys();
     int instrumentCount = keys.count();
@@ -126,7 +127,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
             ((static_cast<float>(i + 1) / instrumentCount) * 0.5) + 0.5;
         float difference = endProgress - startProgress;
 
-        emit progressChanged(startProgress);
+        reportProgress(startProgress);
         emit statusChanged(tr("Writing instrument %1 of %2 ...").
                            arg(locale.toString(i + 1),
                                locale.toString(instrumentCount)));
@@ -163,8 +164,8 @@ Target::build(const QList<synthclone::Zone *> &zones)
 
         // Write instrument layer data.
         for (int j = 0; j < layerCount - 1; j++) {
-            emit progressChanged(((static_cast<float>(j) / layerCount) *
-                                  difference) + startProgress);
+            reportProgress(((static_cast<float>(j) / layerCount) *
+                            difference) + startProgress);
             emit statusChanged(tr("Writing layer %1 of %2 for instrument %3 "
                                   "of %4 ...").
                                arg(locale.toString(j + 1),
@@ -195,14 +196,14 @@ Target::build(const QList<synthclone::Zone *> &zones)
                 writeLayer(archiveWriter, confWriter, i, j, lowVelocity,
                            highVelocity, currentZone);
             } catch (...) {
-                emit progressChanged(0.0);
+                reportProgress(0.0);
                 emit statusChanged("Idle.");
                 throw;
             }
             lowVelocity = highVelocity;
         }
-        emit progressChanged(((static_cast<float>(layerCount - 1) /
-                               layerCount) * difference) + startProgress);
+        reportProgress(((static_cast<float>(layerCount - 1) /
+                         layerCount) * difference) + startProgress);
         emit statusChanged(tr("Writing layer %1 of %2 for instrument %3 of "
                               "%4 ...").
                            arg(locale.toString(layerCount),
@@ -214,7 +215,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
             writeLayer(archiveWriter, confWriter, i, layerCount - 1,
                        lowVelocity, 1.0, zones[layerCount - 1]);
         } catch (...) {
-            emit progressChanged(0.0);
+            reportProgress(0.0);
             emit statusChanged("Idle.");
             throw;
         }
@@ -240,7 +241,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
         emit buildWarning(message);
     }
 
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     emit statusChanged("Idle.");
 }
 
@@ -451,7 +452,7 @@ Target::writeLayer(ArchiveWriter &archiveWriter, QXmlStreamWriter &confWriter,
         assert(sample);
     }
 
-    synthclone::Sample outSample;
+    synthclone::Sample outSample(synthclone::Sample::STORAGE_MEMORY);
     synthclone::SampleInputStream inputStream(*sample);
     synthclone::SampleChannelCount channels = inputStream.getChannels();
     synthclone::SampleOutputStream outputStream
@@ -462,21 +463,17 @@ Target::writeLayer(ArchiveWriter &archiveWriter, QXmlStreamWriter &confWriter,
     outputStream.close();
 
     // Write sample to archive.
-    QString path = outSample.getPath();
-    QFileInfo info(path);
-    assert(info.exists());
-    assert(info.isFile());
-    ArchiveHeader header(QString("%1/%2").arg(kitName, sampleName),
-                         info.size());
-    archiveWriter.writeHeader(header);
-    QFile file(path);
-    if (! file.open(QFile::ReadOnly)) {
-        QString message = tr("could not open '%1': %2").
-            arg(path, file.errorString());
+    QScopedPointer<QIODevice> device(outSample.createDataDevice());
+    if (! device->open(QIODevice::ReadOnly)) {
+        QString message = tr("could not open sample data: %1").
+            arg(device->errorString());
         throw synthclone::Error(message);
     }
+    ArchiveHeader header(QString("%1/%2").arg(kitName, sampleName),
+                         device->size());
+    archiveWriter.writeHeader(header);
     for (;;) {
-        QByteArray data = file.read(8192);
+        QByteArray data = device->read(8192);
         if (data.isEmpty()) {
             break;
         }
@@ -0,0 +1,320 @@
+/*
+ * libsynthclone_jack - JACK Audio Connection Kit sampler plugin for
+ * `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <cassert>
+#include <new>
+
+#include <synthclone/error.h>
+
+#include "diskthread.h"
+
+// Static data
+
+// The maximum number of frames transferred between the ring buffers and the
+// sample stream with one 'read' or 'write' call.
+static const jack_nframes_t TRANSFER_FRAMES = 4096;
+
+// Class definition
+
+DiskThread::DiskThread(QObject *parent):
+    QThread(parent),
+    failed(0),
+    mode(MODE_IDLE),
+    stopRequested(0),
+    terminating(0),
+    truncatedFrames(-1)
+{
+    // Empty
+}
+
+DiskThread::~DiskThread()
+{
+    if (isRunning()) {
+        terminating.storeRelease(1);
+        semaphore.post();
+        wait();
+    }
+    freeBuffers();
+}
+
+void
+DiskThread::allocateBuffers(synthclone::SampleChannelCount channels,
+                            jack_nframes_t bufferFrames)
+{
+    assert(mode.loadAcquire() == MODE_IDLE);
+    assert(channels);
+    assert(buffers.isEmpty());
+    size_t bufferSize = (static_cast<size_t>(bufferFrames) + 1) *
+        sizeof(jack_default_audio_sample_t);
+    for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+        jack_ringbuffer_t *buffer = jack_ringbuffer_create(bufferSize);
+        if (! buffer) {
+            freeBuffers();
+            throw std::bad_alloc();
+        }
+        buffers.append(buffer);
+
+        // Failing to lock the buffer isn't fatal; the realtime thread may
+        // just take a page fault or two.
+        jack_ringbuffer_mlock(buffer);
+    }
+    channelBuffer.resize(TRANSFER_FRAMES);
+    interleavedBuffer.resize(TRANSFER_FRAMES * channels);
+    errorMessage.clear();
+    failed.store(0);
+    stopRequested.store(0);
+    this->channels = channels;
+    transferredFrames = 0;
+    truncatedFrames.store(-1);
+}
+
+void
+DiskThread::beginTransfer(Mode mode, jack_nframes_t frames)
+{
+    totalFrames = frames;
+    if (transferredFrames == frames) {
+        idleSemaphore.release();
+        return;
+    }
+    if (! isRunning()) {
+        start();
+    }
+    this->mode.storeRelease(mode);
+    semaphore.post();
+}
+
+void
+DiskThread::commit()
+{
+    semaphore.post();
+}
+
+QString
+DiskThread::finish()
+{
+    idleSemaphore.acquire();
+    freeBuffers();
+    return errorMessage;
+}
+
+void
+DiskThread::freeBuffers()
+{
+    for (int i = buffers.count() - 1; i >= 0; i--) {
+        jack_ringbuffer_free(buffers[i]);
+    }
+    buffers.clear();
+}
+
+jack_nframes_t
+DiskThread::getReadSpace() const
+{
+    size_t space = jack_ringbuffer_read_space(buffers[0]);
+    for (int i = buffers.count() - 1; i > 0; i--) {
+        space = qMin(space, jack_ringbuffer_read_space(buffers[i]));
+    }
+    return static_cast<jack_nframes_t>
+        (space / sizeof(jack_default_audio_sample_t));
+}
+
+jack_nframes_t
+DiskThread::getTotalFrames() const
+{
+    int frames = truncatedFrames.loadAcquire();
+    return (frames < 0) ? totalFrames :
+        qMin(totalFrames, static_cast<jack_nframes_t>(frames));
+}
+
+jack_nframes_t
+DiskThread::getWriteSpace() const
+{
+    size_t space = jack_ringbuffer_write_space(buffers[0]);
+    for (int i = buffers.count() - 1; i > 0; i--) {
+        space = qMin(space, jack_ringbuffer_write_space(buffers[i]));
+    }
+    return static_cast<jack_nframes_t>
+        (space / sizeof(jack_default_audio_sample_t));
+}
+
+bool
+DiskThread::hasFailed() const
+{
+    return failed.loadAcquire();
+}
+
+void
+DiskThread::read(synthclone::SampleChannelCount channel,
+                 jack_default_audio_sample_t *data, jack_nframes_t frames)
+{
+    jack_ringbuffer_read(buffers[channel], reinterpret_cast<char *>(data),
+                         frames * sizeof(jack_default_audio_sample_t));
+}
+
+void
+DiskThread::readFrames(jack_nframes_t maximumFrames)
+{
+    float *channelData = channelBuffer.data();
+    float *interleavedData = interleavedBuffer.data();
+    while (transferredFrames < maximumFrames) {
+        jack_nframes_t count =
+            qMin(qMin(TRANSFER_FRAMES, maximumFrames - transferredFrames),
+                 getWriteSpace());
+        if (! count) {
+            break;
+        }
+        if (static_cast<jack_nframes_t>(inputStream->read(interleavedData,
+                                                          count)) != count) {
+            throw synthclone::Error(tr("sample ended before the expected "
+                                       "number of frames were read"));
+        }
+        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+            const float *source = interleavedData + i;
+            for (jack_nframes_t j = 0; j < count; j++) {
+                channelData[j] = *source;
+                source += channels;
+            }
+            jack_ringbuffer_write(buffers[i],
+                                  reinterpret_cast<const char *>(channelData),
+                                  count * sizeof(float));
+        }
+        transferredFrames += count;
+    }
+}
+
+void
+DiskThread::run()
+{
+    for (;;) {
+        semaphore.wait();
+        if (terminating.loadAcquire()) {
+            break;
+        }
+        if (mode.loadAcquire() != MODE_IDLE) {
+            transferFrames();
+        }
+    }
+}
+
+void
+DiskThread::startCapture(synthclone::SampleOutputStream *stream,
+                         synthclone::SampleChannelCount channels,
+                         jack_nframes_t frames, jack_nframes_t bufferFrames)
+{
+    allocateBuffers(channels, bufferFrames);
+    outputStream = stream;
+    beginTransfer(MODE_CAPTURE, frames);
+}
+
+void
+DiskThread::startPlayback(synthclone::SampleInputStream *stream,
+                          synthclone::SampleChannelCount channels,
+                          jack_nframes_t frames, jack_nframes_t bufferFrames,
+                          jack_nframes_t prefetchFrames)
+{
+    allocateBuffers(channels, bufferFrames);
+    inputStream = stream;
+
+    // Fill the start of the ring buffers on the calling thread so that the
+    // realtime thread has data as soon as playback begins.  The disk thread
+    // reads the remainder.
+    try {
+        readFrames(qMin(prefetchFrames, frames));
+    } catch (...) {
+        freeBuffers();
+        throw;
+    }
+    beginTransfer(MODE_PLAYBACK, frames);
+}
+
+QString
+DiskThread::stop()
+{
+    stopRequested.storeRelease(1);
+    semaphore.post();
+    return finish();
+}
+
+void
+DiskThread::transferFrames()
+{
+    bool stopped = stopRequested.loadAcquire();
+    if (! stopped) {
+        try {
+            if (mode.loadAcquire() == MODE_CAPTURE) {
+                writeFrames();
+            } else {
+                readFrames(totalFrames);
+            }
+        } catch (synthclone::Error &e) {
+            errorMessage = e.getMessage();
+            failed.storeRelease(1);
+            stopped = true;
+        }
+    }
+    if (stopped || (transferredFrames == getTotalFrames())) {
+        mode.storeRelease(MODE_IDLE);
+        idleSemaphore.release();
+    }
+}
+
+void
+DiskThread::truncate(jack_nframes_t frames)
+{
+    truncatedFrames.storeRelease(static_cast<int>(frames));
+    semaphore.post();
+}
+
+void
+DiskThread::write(synthclone::SampleChannelCount channel,
+                  const jack_default_audio_sample_t *data,
+                  jack_nframes_t frames)
+{
+    jack_ringbuffer_write(buffers[channel],
+                          reinterpret_cast<const char *>(data),
+                          frames * sizeof(jack_default_audio_sample_t));
+}
+
+void
+DiskThread::writeFrames()
+{
+    float *channelData = channelBuffer.data();
+    float *interleavedData = interleavedBuffer.data();
+    jack_nframes_t frames = getTotalFrames();
+    while (transferredFrames < frames) {
+        jack_nframes_t count =
+            qMin(qMin(TRANSFER_FRAMES, frames - transferredFrames),
+                 getReadSpace());
+        if (! count) {
+            break;
+        }
+        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+            jack_ringbuffer_read(buffers[i],
+                                 reinterpret_cast<char *>(channelData),
+                                 count * sizeof(float));
+            float *destination = interleavedData + i;
+            for (jack_nframes_t j = 0; j < count; j++) {
+                *destination = channelData[j];
+                destination += channels;
+            }
+        }
+        outputStream->write(interleavedData, count);
+        transferredFrames += count;
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * libsynthclone_jack - JACK Audio Connection Kit sampler plugin for
+ * `synthclone`
+ * Copyright (C) 2011 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __DISKTHREAD_H__
+#define __DISKTHREAD_H__
+
+#include <jack/jack.h>
+#include <jack/ringbuffer.h>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include <synthclone/sampleinputstream.h>
+#include <synthclone/sampleoutputstream.h>
+#include <synthclone/semaphore.h>
+
+class DiskThread: public QThread {
+
+    Q_OBJECT
+
+public:
+
+    explicit
+    DiskThread(QObject *parent=0);
+
+    ~DiskThread();
+
+    void
+    commit();
+
+    QString
+    finish();
+
+    jack_nframes_t
+    getReadSpace() const;
+
+    jack_nframes_t
+    getWriteSpace() const;
+
+    bool
+    hasFailed() const;
+
+    void
+    read(synthclone::SampleChannelCount channel,
+         jack_default_audio_sample_t *data, jack_nframes_t frames);
+
+    void
+    startCapture(synthclone::SampleOutputStream *stream,
+                 synthclone::SampleChannelCount channels,
+                 jack_nframes_t frames, jack_nframes_t bufferFrames);
+
+    void
+    startPlayback(synthclone::SampleInputStream *stream,
+                  synthclone::SampleChannelCount channels,
+                  jack_nframes_t frames, jack_nframes_t bufferFrames,
+                  jack_nframes_t prefetchFrames);
+
+    QString
+    stop();
+
+    void
+    truncate(jack_nframes_t frames);
+
+    void
+    write(synthclone::SampleChannelCount channel,
+          const jack_default_audio_sample_t *data, jack_nframes_t frames);
+
+protected:
+
+    void
+    run();
+
+private:
+
+    enum Mode {
+        MODE_CAPTURE,
+        MODE_IDLE,
+        MODE_PLAYBACK
+    };
+
+    void
+    allocateBuffers(synthclone::SampleChannelCount channels,
+                    jack_nframes_t bufferFrames);
+
+    void
+    beginTransfer(Mode mode, jack_nframes_t frames);
+
+    void
+    freeBuffers();
+
+    jack_nframes_t
+    getTotalFrames() const;
+
+    void
+    readFrames(jack_nframes_t maximumFrames);
+
+    void
+    transferFrames();
+
+    void
+    writeFrames();
+
+    QVector<jack_ringbuffer_t *> buffers;
+    synthclone::SampleChannelCount channels;
+    QVector<float> channelBuffer;
+    QString errorMessage;
+    QAtomicInt failed;
+    QSemaphore idleSemaphore;
+    synthclone::SampleInputStream *inputStream;
+    QVector<float> interleavedBuffer;
+    QAtomicInt mode;
+    synthclone::SampleOutputStream *outputStream;
+    synthclone::Semaphore semaphore;
+    QAtomicInt stopRequested;
+    QAtomicInt terminating;
+    jack_nframes_t totalFrames;
+    jack_nframes_t transferredFrames;
+    QAtomicInt truncatedFrames;
+
+};
+
+#endif
@@ -4,7 +4,8 @@ include(../plugins.pri)
 # Build
 ################################################################################
 
-HEADERS += eventthread.h \
+HEADERS += diskthread.h \
+    eventthread.h \
     participant.h \
     plugin.h \
     sampler.h \
@@ -14,7 +15,8 @@ MOC_DIR = $${MAKEDIR}/plugins/jack
 OBJECTS_DIR = $${MAKEDIR}/plugins/jack
 RCC_DIR = $${MAKEDIR}/plugins/jack
 RESOURCES += jack.qrc
-SOURCES += eventthread.cpp \
+SOURCES += diskthread.cpp \
+    eventthread.cpp \
     participant.cpp \
     plugin.cpp \
     sampler.cpp \
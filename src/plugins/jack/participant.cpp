@@ -18,6 +18,8 @@
  * Ave, Cambridge, MA 02139, USA.
  */
 
+#include <cassert>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 
@@ -102,6 +104,20 @@ Participant::addSampler(bool convertSampleRate)
                                         jack_session_event_t *)),
                     SLOT(handleSessionEvent(jack_client_t *,
                                             jack_session_event_t *)));
+            if (inputGroupCount.isValid()) {
+                sampler->setInputGroupCount(inputGroupCount.toInt());
+                inputGroupCount.clear();
+            }
+            connect(sampler, SIGNAL(latencyChanged()),
+                    context, SLOT(setSessionModified()));
+            if (latency.isValid()) {
+                sampler->setLatency(latency.toUInt());
+                latency.clear();
+            }
+            if (readAheadTime.isValid()) {
+                sampler->setReadAheadTime(readAheadTime.toFloat());
+                readAheadTime.clear();
+            }
             sampler->activate(context->getSampleChannelCount());
             context->setSampleRate(serverSampleRate);
             const synthclone::Registration &registration =
@@ -109,6 +125,19 @@ Participant::addSampler(bool convertSampleRate)
             connect(&registration, SIGNAL(unregistered(QObject *)),
                     SLOT(handleSamplerUnregistration(QObject *)));
             samplerPtr.take();
+
+            synthclone::MenuAction *action =
+                new synthclone::MenuAction
+                (tr("Measure Latency"),
+                 tr("Measure the delay between sending MIDI to the instrument "
+                    "and receiving its audio during the next sampling job"),
+                 sampler);
+            connect(action, SIGNAL(triggered()),
+                    sampler, SLOT(requestLatencyMeasurement()));
+            const synthclone::Registration &actionRegistration =
+                context->addMenuAction(action, sampler);
+            connect(&actionRegistration, SIGNAL(unregistered(QObject *)),
+                    SLOT(handleMenuActionUnregistration(QObject *)));
             sessionId.clear();
             return;
         }
@@ -127,9 +156,16 @@ Participant::deactivate(synthclone::Context &context)
 }
 
 QVariant
-Participant::getState(const synthclone::Sampler */*sampler*/) const
+Participant::getState(const synthclone::Sampler *sampler) const
 {
+    const Sampler *s = qobject_cast<const Sampler *>(sampler);
+    assert(s);
     QVariantMap map;
+    map.insert("inputGroupCount", s->getInputGroupCount());
+    if (s->isLatencyMeasured()) {
+        map.insert("latency", s->getLatency());
+    }
+    map.insert("readAheadTime", s->getReadAheadTime());
     if (! sessionId.isEmpty()) {
         map.insert("sessionId", sessionId);
     }
@@ -157,6 +193,12 @@ Participant::handleJACKSampleRateChange()
     }
 }
 
+void
+Participant::handleMenuActionUnregistration(QObject *obj)
+{
+    delete obj;
+}
+
 void
 Participant::handleSamplerAdditionRequest()
 {
@@ -216,6 +258,23 @@ Participant::handleSessionEvent(jack_client_t *client,
 void
 Participant::restoreSampler(const QVariant &state)
 {
-    sessionId = state.toMap().value("sessionId", QByteArray()).toByteArray();
+    const QVariantMap map = state.toMap();
+    sessionId = map.value("sessionId", QByteArray()).toByteArray();
+    inputGroupCount.clear();
+    latency.clear();
+    readAheadTime.clear();
+    bool success;
+    int count = map.value("inputGroupCount", "").toInt(&success);
+    if (success && (count >= 1) && (count <= 0x10)) {
+        inputGroupCount = count;
+    }
+    uint frames = map.value("latency", "").toUInt(&success);
+    if (success) {
+        latency = frames;
+    }
+    float time = map.value("readAheadTime", "").toFloat(&success);
+    if (success && (time > 0.0)) {
+        readAheadTime = time;
+    }
     addSampler(false);
 }
@@ -60,6 +60,9 @@ private slots:
     void
     handleJACKSampleRateChange();
 
+    void
+    handleMenuActionUnregistration(QObject *obj);
+
     void
     handleSamplerAdditionRequest();
 
@@ -88,6 +91,9 @@ private:
 
     synthclone::MenuAction addSamplerAction;
     synthclone::Context *context;
+    QVariant inputGroupCount;
+    QVariant latency;
+    QVariant readAheadTime;
     SampleRateChangeView sampleRateChangeView;
     QByteArray sessionId;
 
@@ -32,6 +32,7 @@
 #include <synthclone/error.h>
 #include <synthclone/sampleinputstream.h>
 #include <synthclone/sampleoutputstream.h>
+#include <synthclone/util.h>
 
 #include "sampler.h"
 
@@ -39,6 +40,8 @@
 
 static const char *ERROR_BACKEND =
     QT_TR_NOOP("A JACK server backend error has occurred");
+static const char *ERROR_CAPTURE_OVERRUN =
+    QT_TR_NOOP("Captured audio could not be written to disk fast enough");
 static const char *ERROR_CLIENT =
     QT_TR_NOOP("Unable to initialize client");
 static const char *ERROR_FAILURE =
@@ -47,12 +50,16 @@ static const char *ERROR_INTERNAL_CLIENT =
     QT_TR_NOOP("Unable to load internal client");
 static const char *ERROR_INVALID_OPTION =
     QT_TR_NOOP("Operation contained an invalid or unsupported option");
+static const char *ERROR_LATENCY_MEASUREMENT =
+    QT_TR_NOOP("No signal was detected while measuring latency");
 static const char *ERROR_MIDI_EVENT_RESERVE =
     QT_TR_NOOP("Failed to reserve event in JACK MIDI buffer");
 static const char *ERROR_NAME_NOT_UNIQUE =
     QT_TR_NOOP("The given client name is not unique");
 static const char *ERROR_NO_SUCH_CLIENT =
     QT_TR_NOOP("The requested client does not exist");
+static const char *ERROR_PLAYBACK_READ =
+    QT_TR_NOOP("Failed to read the sample from disk");
 static const char *ERROR_SAMPLE_RATE =
     QT_TR_NOOP("JACK's sample rate differs from the sample's sample rate");
 static const char *ERROR_SERVER_COMMUNICATION =
@@ -68,6 +75,28 @@ static const char *ERROR_VERSION =
 static const char *ERROR_ZOMBIE =
     QT_TR_NOOP("The JACK server has zombified this JACK client");
 
+// The number of seconds of captured audio that can be buffered between the
+// process callback and the disk thread.
+static const jack_nframes_t CAPTURE_BUFFER_SECONDS = 4;
+
+// The amplitude that marks a note's onset when latency is measured, unless a
+// silence threshold is set.
+static const float DEFAULT_ONSET_THRESHOLD = 0.001;
+
+// The default number of seconds of audio that the disk thread reads ahead of
+// playback.
+static const float DEFAULT_READ_AHEAD_TIME = 2.0;
+
+// The number of seconds to wait for a note's onset when latency is measured.
+static const float MAXIMUM_LATENCY_TIME = 1.0;
+
+// The number of MIDI channels, each of which can have its own group of input
+// ports.
+static const int MIDI_CHANNEL_COUNT = 0x10;
+
+// The number of seconds of audio read before playback begins.
+static const float PREFETCH_TIME = 0.25;
+
 struct ClientDestructor {
 
     static void
@@ -126,11 +155,22 @@ Sampler::handleShutdownEvent(jack_status_t code, const char *reason, void *ptr)
     sampler->handleShutdownEvent(code, reason);
 }
 
+int
+Sampler::handleXrunEvent(void *ptr)
+{
+    Sampler *sampler = static_cast<Sampler *>(ptr);
+    assert(sampler);
+    return sampler->handleXrunEvent();
+}
+
 // Class definition
 
 Sampler::Sampler(const QString &name, const char *sessionId, QObject *parent):
     synthclone::Sampler(name, parent),
-    eventThread(this)
+    eventThread(this),
+    sweepCaptureIndex(0),
+    sweepJobIndex(0),
+    sweepPhase(ZONEPHASE_START)
 {
     QByteArray jackNameByteArray = tr("synthclone").toLocal8Bit();
     const char *jackName = jackNameByteArray.constData();
@@ -180,9 +220,17 @@ Sampler::Sampler(const QString &name, const char *sessionId, QObject *parent):
     if (jack_set_session_callback(client, handleSessionEvent, this)) {
         throw synthclone::Error(tr("failed to set JACK session callback"));
     }
+    if (jack_set_xrun_callback(client, handleXrunEvent, this)) {
+        throw synthclone::Error(tr("failed to set JACK xrun callback"));
+    }
     jack_on_info_shutdown(client, handleShutdownEvent, this);
 
     active = false;
+    inputGroupCount = 1;
+    latency.storeRelease(0);
+    latencyMeasured.storeRelease(0);
+    latencyMeasurementRequested.storeRelease(0);
+    readAheadTime = DEFAULT_READ_AHEAD_TIME;
     clientPtr.take();
     commandBufferPtr.take();
     priorityEventBufferPtr.take();
@@ -209,6 +257,7 @@ Sampler::~Sampler()
     jack_ringbuffer_free(commandBuffer);
     jack_ringbuffer_free(priorityEventBuffer);
     jack_ringbuffer_free(processEventBuffer);
+    qDeleteAll(parallelDiskThreads);
 }
 
 void
@@ -228,6 +277,15 @@ Sampler::activate(synthclone::SampleChannelCount channels)
                                           channels);
         QScopedArrayPointer<jack_port_t *> inputPortsPtr(inputPorts);
 
+        // A MIDI channel with its own input group records from that group.
+        // The other channels share the first group.
+        channelInputPorts.fill(inputPorts, MIDI_CHANNEL_COUNT);
+        for (int i = 1; i < inputGroupCount; i++) {
+            channelInputPorts[i] =
+                initializeAudioPorts(tr("input-channel%1").arg(i + 1),
+                                     JackPortIsInput, channels);
+        }
+
         monitorPorts = initializeAudioPorts(tr("monitor"), JackPortIsOutput,
                                             channels);
         QScopedArrayPointer<jack_port_t *> monitorPortsPtr(monitorPorts);
@@ -254,14 +312,57 @@ Sampler::activate(synthclone::SampleChannelCount channels)
         monitorPortsPtr.take();
         outputPortsPtr.take();
     } catch (...) {
+        deleteInputGroupPorts();
         closePorts();
         throw;
     }
 }
 
+bool
+Sampler::captureReleaseTail(jack_nframes_t frames)
+{
+    // Nothing is captured once the job is being aborted or has failed; the
+    // release just runs out.
+    if (aborted || errorMessage) {
+        return false;
+    }
+    jack_nframes_t copyFrames =
+        qMin(frames, command.totalReleaseFrames - currentFrame);
+    if (diskThread.getWriteSpace() < copyFrames) {
+        errorMessage = ERROR_CAPTURE_OVERRUN;
+        return true;
+    }
+
+    // Find the last frame in this period where any channel reaches the
+    // threshold.  The signal has been silent since that frame.
+    float threshold = command.silenceThreshold;
+    jack_nframes_t loudFrames = 0;
+    for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+        const jack_default_audio_sample_t *buffer =
+            static_cast<jack_default_audio_sample_t *>
+            (jack_port_get_buffer(command.inputPorts[i], frames));
+        diskThread.write(i, buffer, copyFrames);
+        for (jack_nframes_t j = copyFrames; j > loudFrames; j--) {
+            if (fabsf(buffer[j - 1]) >= threshold) {
+                loudFrames = j;
+                break;
+            }
+        }
+    }
+    diskThread.commit();
+    silentFrames = loudFrames ? copyFrames - loudFrames :
+        silentFrames + copyFrames;
+    if (silentFrames < command.silenceHoldFrames) {
+        return false;
+    }
+    diskThread.truncate(command.totalSampleFrames + currentFrame + copyFrames);
+    return true;
+}
+
 void
 Sampler::clean()
 {
+    deleteInputGroupPorts();
     delete[] inputPorts;
     delete[] monitorPorts;
     delete[] outputPorts;
@@ -282,12 +383,42 @@ Sampler::closePorts()
     }
 }
 
+void
+Sampler::deleteInputGroupPorts()
+{
+    for (int i = channelInputPorts.count() - 1; i > 0; i--) {
+        if (channelInputPorts[i] != inputPorts) {
+            delete[] channelInputPorts[i];
+        }
+    }
+    channelInputPorts.clear();
+}
+
 synthclone::SampleChannelCount
 Sampler::getChannelCount() const
 {
     return channels;
 }
 
+jack_nframes_t
+Sampler::findOnset(jack_nframes_t frames)
+{
+    float threshold = command.onsetThreshold;
+    jack_nframes_t onset = frames;
+    for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+        const jack_default_audio_sample_t *buffer =
+            static_cast<jack_default_audio_sample_t *>
+            (jack_port_get_buffer(command.inputPorts[i], frames));
+        for (jack_nframes_t j = 0; j < onset; j++) {
+            if (fabsf(buffer[j]) >= threshold) {
+                onset = j;
+                break;
+            }
+        }
+    }
+    return onset;
+}
+
 const char *
 Sampler::getErrorMessage(jack_status_t status) const
 {
@@ -305,6 +436,47 @@ Sampler::getErrorMessage(jack_status_t status) const
         (status & JackFailure) ? ERROR_FAILURE : ERROR_UNKNOWN;
 }
 
+int
+Sampler::getInputGroupCount() const
+{
+    return inputGroupCount;
+}
+
+jack_port_t **
+Sampler::getInputPorts(const synthclone::Zone *zone) const
+{
+    return channelInputPorts[zone->getChannel() - 1];
+}
+
+jack_nframes_t
+Sampler::getLatency() const
+{
+    return latency.loadAcquire();
+}
+
+jack_nframes_t
+Sampler::getPortLatency(jack_port_t **inputPorts) const
+{
+    // MIDI events reach the instrument after the MIDI port's playback latency,
+    // and the instrument's audio reaches the input ports after their capture
+    // latency.
+    jack_latency_range_t range;
+    jack_port_get_latency_range(midiPort, JackPlaybackLatency, &range);
+    jack_nframes_t playbackLatency = range.max;
+    jack_nframes_t captureLatency = 0;
+    for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+        jack_port_get_latency_range(inputPorts[i], JackCaptureLatency, &range);
+        captureLatency = qMax(captureLatency, range.max);
+    }
+    return playbackLatency + captureLatency;
+}
+
+float
+Sampler::getReadAheadTime() const
+{
+    return readAheadTime;
+}
+
 synthclone::SampleRate
 Sampler::getSampleRate() const
 {
@@ -324,9 +496,7 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
 
     jack_nframes_t copyFrames;
     const synthclone::SamplerJob *job;
-    synthclone::MIDIData midiChannel;
     jack_nframes_t nextFrame;
-    float **sampleBuffers;
     jack_nframes_t totalFrames;
     bool writeSilence = true;
     const synthclone::Zone *zone;
@@ -344,6 +514,19 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
                 aborted = false;
                 currentFrame = 0;
                 errorMessage = 0;
+                xruns.storeRelease(0);
+                if (command.parallelJobCount) {
+                    parallelJobsRemaining = command.parallelJobCount;
+                    state = STATE_PARALLEL;
+                    goto parallel;
+                }
+                if (command.sweepJobCount) {
+                    sweepCaptureIndex = 0;
+                    sweepJobIndex = 0;
+                    sweepPhase = ZONEPHASE_START;
+                    state = STATE_SWEEP;
+                    goto sweep;
+                }
                 if (job->getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
                     state = STATE_SAMPLE_SEND_PRE_MIDI;
                     goto sampleSendPreMIDI;
@@ -366,34 +549,33 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
         if (state == STATE_ERROR) {
             goto error;
         }
-        nextFrame = currentFrame + frames;
-        sampleBuffers = command.sampleBuffers;
+        if (diskThread.hasFailed()) {
+            setProcessErrorState(ERROR_PLAYBACK_READ);
+            goto error;
+        }
         totalFrames = command.totalSampleFrames;
         writeSilence = false;
-        if (nextFrame >= totalFrames) {
-            copyFrames = totalFrames - currentFrame;
-            copySize = copyFrames * sizeof(jack_default_audio_sample_t);
-            for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-                jack_default_audio_sample_t *outputBuffer =
-                    static_cast<jack_default_audio_sample_t *>
-                    (jack_port_get_buffer(outputPorts[i], frames));
-                memcpy(outputBuffer, sampleBuffers[i] + currentFrame, copySize);
-                for (synthclone::SampleFrameCount j = copyFrames;
-                     j < totalFrames; j++) {
-                    outputBuffer[j] = 0.0;
-                }
-            }
+
+        // If the disk thread has fallen behind, play what's available and
+        // pad the period with silence.
+        copyFrames = qMin(qMin(frames, totalFrames - currentFrame),
+                          diskThread.getReadSpace());
+        copySize = (frames - copyFrames) * sizeof(jack_default_audio_sample_t);
+        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+            jack_default_audio_sample_t *outputBuffer =
+                static_cast<jack_default_audio_sample_t *>
+                (jack_port_get_buffer(outputPorts[i], frames));
+            diskThread.read(i, outputBuffer, copyFrames);
+            memset(outputBuffer + copyFrames, 0, copySize);
+        }
+        diskThread.commit();
+        currentFrame += copyFrames;
+        if (currentFrame == totalFrames) {
             sendProgressEvent(1.0);
             state = STATE_COMPLETED;
             goto completed;
         }
-        copySize = frames * sizeof(jack_default_audio_sample_t);
-        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-            memcpy(jack_port_get_buffer(outputPorts[i], frames),
-                   sampleBuffers[i] + currentFrame, copySize);
-        }
-        currentFrame = nextFrame;
-        sendProgressEvent(static_cast<float>(nextFrame) / totalFrames);
+        sendProgressEvent(static_cast<float>(currentFrame) / totalFrames);
         break;
 
     // Four states for executing 'sample' command.
@@ -406,44 +588,47 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
         if (state == STATE_ERROR) {
             goto error;
         }
-        zone = command.job->getZone();
-
-        {
-            using synthclone::Zone;
+        if (! sendZoneStartMessages(midiBuffer, command.job->getZone(), 0)) {
+            goto error;
+        }
+        captureOffset = 0;
+        state = STATE_SAMPLE_LATENCY;
+        break;
 
-            const Zone::ControlMap &controlValues = zone->getControlMap();
-            Zone::ControlMap::const_iterator end = controlValues.end();
-            midiChannel = zone->getChannel() - 1;
-            for (Zone::ControlMap::const_iterator iter = controlValues.begin();
-                 iter != end; iter++) {
-                if (! sendMIDIMessage(midiBuffer, 0xb0 | midiChannel,
-                                      iter.key(), iter.value())) {
-                    goto error;
-                }
-            }
-            synthclone::MIDIData note = zone->getNote();
-            if (! sendMIDIMessage(midiBuffer, 0x90 | midiChannel, note,
-                                  zone->getVelocity())) {
-                goto error;
-            }
-            synthclone::MIDIData pressure = zone->getChannelPressure();
-            if (pressure != synthclone::MIDI_VALUE_NOT_SET) {
-                if (! sendMIDIMessage(midiBuffer, 0xb0 | midiChannel,
-                                      pressure)) {
-                    goto error;
+    // Capture starts once the MIDI messages have reached the instrument and
+    // its audio has made it back to the input ports.
+    case STATE_SAMPLE_LATENCY:
+        updateCommandState();
+        switch (state) {
+        case STATE_ABORT:
+            aborted = true;
+            // Fallthrough on purpose.
+        case STATE_ERROR:
+            goto sampleSendNoteOff;
+        default:
+            ;
+        }
+        if (command.measureLatency) {
+            captureOffset = findOnset(frames);
+            if (captureOffset == frames) {
+                currentFrame += frames;
+                if (currentFrame >= command.latencyFrames) {
+                    setProcessErrorState(ERROR_LATENCY_MEASUREMENT);
+                    goto sampleSendNoteOff;
                 }
+                break;
             }
-            synthclone::MIDIData aftertouch = zone->getAftertouch();
-            if (aftertouch != synthclone::MIDI_VALUE_NOT_SET) {
-                if (! sendMIDIMessage(midiBuffer, 0xa0 | midiChannel, note,
-                                      aftertouch)) {
-                    goto error;
-                }
+            measuredLatency = currentFrame + captureOffset;
+        } else {
+            if ((command.latencyFrames - currentFrame) >= frames) {
+                currentFrame += frames;
+                break;
             }
+            captureOffset = command.latencyFrames - currentFrame;
         }
-        // XXX: Skip frames if there's latency.  How do we determine that?
+        currentFrame = 0;
         state = STATE_SAMPLE;
-        break;
+        // Fallthrough on purpose.
 
     case STATE_SAMPLE:
         updateCommandState();
@@ -456,36 +641,37 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
         default:
             ;
         }
-        nextFrame = currentFrame + frames;
-        sampleBuffers = command.sampleBuffers;
+        nextFrame = currentFrame + (frames - captureOffset);
         totalFrames = command.totalSampleFrames;
+        copyFrames = (nextFrame < totalFrames) ? frames - captureOffset :
+            totalFrames - currentFrame;
+        if (diskThread.getWriteSpace() < copyFrames) {
+            setProcessErrorState(ERROR_CAPTURE_OVERRUN);
+            goto sampleSendNoteOff;
+        }
+        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+            diskThread.write
+                (i, static_cast<jack_default_audio_sample_t *>
+                 (jack_port_get_buffer(command.inputPorts[i], frames)) +
+                 captureOffset, copyFrames);
+        }
+        diskThread.commit();
+        captureOffset = 0;
         if (nextFrame < totalFrames) {
-            copySize = frames * sizeof(jack_default_audio_sample_t);
-            for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-                memcpy(sampleBuffers[i] + currentFrame,
-                       jack_port_get_buffer(inputPorts[i], frames), copySize);
-            }
             currentFrame = nextFrame;
             sendProgressEvent(static_cast<float>(currentFrame) /
                               (totalFrames + command.totalReleaseFrames));
             break;
         }
-        copyFrames = totalFrames - currentFrame;
-        copySize = copyFrames * sizeof(jack_default_audio_sample_t);
-        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-            memcpy(sampleBuffers[i] + currentFrame,
-                   jack_port_get_buffer(inputPorts[i], frames), copySize);
-        }
         sendProgressEvent(static_cast<float>(totalFrames) /
                           (totalFrames + command.totalReleaseFrames));
     sampleSendNoteOff:
-        zone = command.job->getZone();
-        if (! sendMIDIMessage(midiBuffer, 0x80 | (zone->getChannel() - 1),
-                              zone->getNote(), zone->getVelocity())) {
+        if (! sendZoneNoteOffMessage(midiBuffer, command.job->getZone(), 0)) {
             state = STATE_ERROR;
             goto error;
         }
         currentFrame = 0;
+        silentFrames = 0;
         state = STATE_SAMPLE_RELEASE;
         break;
 
@@ -504,8 +690,12 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
             ;
         }
 
-        currentFrame += frames;
         totalFrames = command.totalReleaseFrames;
+        if ((command.silenceThreshold > 0.0) && captureReleaseTail(frames)) {
+            currentFrame = totalFrames;
+        } else {
+            currentFrame += frames;
+        }
         if (currentFrame < totalFrames) {
             jack_nframes_t totalSampleFrames = command.totalSampleFrames;
             sendProgressEvent((static_cast<float>(currentFrame) +
@@ -516,13 +706,7 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
         sendProgressEvent(1.0);
 
         // Send MIDI messages to turn sound off and reset controllers.
-        zone = command.job->getZone();
-        midiChannel = zone->getChannel() - 1;
-        if (! sendMIDIMessage(midiBuffer, 0xb0 | midiChannel, 0x78, 0)) {
-            state = STATE_ERROR;
-            goto error;
-        }
-        if (! sendMIDIMessage(midiBuffer, 0xb0 | midiChannel, 0x79, 0)) {
+        if (! sendZoneResetMessages(midiBuffer, command.job->getZone(), 0)) {
             state = STATE_ERROR;
             goto error;
         }
@@ -561,7 +745,104 @@ Sampler::handleProcessEvent(jack_nframes_t frames)
         }
         break;
 
+    // Execute 'sweep' command
+    case STATE_SWEEP:
+    sweep:
+        updateCommandState();
+        switch (state) {
+        case STATE_ABORT:
+            aborted = true;
+            // Fallthrough on purpose.
+        case STATE_ERROR:
+            goto sweepStop;
+        default:
+            ;
+        }
+        if (! processSweep(midiBuffer, frames)) {
+            goto sweepStop;
+        }
+        if ((sweepJobIndex < command.sweepJobCount) ||
+            (currentFrame < (command.latencyFrames +
+                             command.totalSampleFrames))) {
+            break;
+        }
+        state = STATE_COMPLETED;
+        goto completed;
+    sweepStop:
+
+        // Silence the zone that's sounding, if any.  If the MIDI buffer is
+        // full, there's nothing more that can be done.
+        if (sweepJobIndex < command.sweepJobCount) {
+            zone = command.sweepJobs[sweepJobIndex].zone;
+            switch (sweepPhase) {
+            case ZONEPHASE_NOTE_OFF:
+                sendZoneNoteOffMessage(midiBuffer, zone, 0);
+                // Fallthrough on purpose.
+            case ZONEPHASE_RESET:
+                sendZoneResetMessages(midiBuffer, zone, 0);
+                // Fallthrough on purpose.
+            default:
+                ;
+            }
+        }
+        if (errorMessage) {
+            state = STATE_ERROR;
+            goto error;
+        }
+        state = STATE_ABORT;
+        goto abort;
+
+    // Execute 'parallel' command
+    case STATE_PARALLEL:
+    parallel:
+        updateCommandState();
+        switch (state) {
+        case STATE_ABORT:
+            aborted = true;
+            // Fallthrough on purpose.
+        case STATE_ERROR:
+            goto parallelStop;
+        default:
+            ;
+        }
+        if (! processParallelJobs(midiBuffer, frames)) {
+            goto parallelStop;
+        }
+        if (parallelJobsRemaining ||
+            (currentFrame < (command.latencyFrames +
+                             command.totalSampleFrames))) {
+            break;
+        }
+        state = STATE_COMPLETED;
+        goto completed;
+    parallelStop:
+
+        // Silence the zones that are sounding.  Earlier events in this period
+        // may have been queued at later frames, so the messages are queued at
+        // the last frame.  If the MIDI buffer is full, there's nothing more
+        // that can be done.
+        for (int i = 0; i < command.parallelJobCount; i++) {
+            const ParallelJob &job = command.parallelJobs[i];
+            switch (job.phase) {
+            case ZONEPHASE_NOTE_OFF:
+                sendZoneNoteOffMessage(midiBuffer, job.zone, frames - 1);
+                // Fallthrough on purpose.
+            case ZONEPHASE_RESET:
+                sendZoneResetMessages(midiBuffer, job.zone, frames - 1);
+                // Fallthrough on purpose.
+            default:
+                ;
+            }
+        }
+        if (errorMessage) {
+            state = STATE_ERROR;
+            goto error;
+        }
+        state = STATE_ABORT;
+        goto abort;
+
     }
+    capturing.storeRelease(isCapturing());
     if (writeSilence) {
         void *firstBuffer = jack_port_get_buffer(outputPorts[0], frames);
         jack_default_audio_sample_t *firstSampleBuffer =
@@ -604,6 +885,17 @@ Sampler::handleShutdownEvent(jack_status_t status, const char */*reason*/)
     sendPriorityEvent(event);
 }
 
+int
+Sampler::handleXrunEvent()
+{
+    // Xruns are only counted while a job's audio is being captured.  The
+    // count is reported when the job completes.
+    if (capturing.loadAcquire()) {
+        xruns.fetchAndAddOrdered(1);
+    }
+    return 0;
+}
+
 jack_port_t **
 Sampler::initializeAudioPorts(const QString &prefix, JackPortFlags flags,
                               synthclone::SampleChannelCount channels)
@@ -621,11 +913,58 @@ Sampler::initializeAudioPorts(const QString &prefix, JackPortFlags flags,
     return ports;
 }
 
+void
+Sampler::initializeHelperThread()
+{
+    try {
+        acquireRealtimePriority();
+    } catch (synthclone::Error &e) {
+        QString message = tr("Realtime scheduling is unavailable: %1").
+            arg(e.getMessage());
+        qWarning() << message;
+        emit statusChanged(message);
+    }
+}
+
+bool
+Sampler::isCapturing() const
+{
+    switch (state) {
+    case STATE_PARALLEL:
+    case STATE_SAMPLE:
+    case STATE_SWEEP:
+        return true;
+    case STATE_SAMPLE_RELEASE:
+        return command.silenceThreshold > 0.0;
+    default:
+        ;
+    }
+    return false;
+}
+
+bool
+Sampler::isLatencyMeasured() const
+{
+    return static_cast<bool>(latencyMeasured.loadAcquire());
+}
+
+bool
+Sampler::isParallelChannel(synthclone::MIDIData channel) const
+{
+    return (inputGroupCount > 1) && (channel <= inputGroupCount);
+}
+
+bool
+Sampler::isSweepSupported() const
+{
+    return true;
+}
+
 void
 Sampler::monitorEvents()
 {
-    Command *command;
-    const synthclone::SamplerJob *job;
+    QString message;
+    initializeHelperThread();
     for (;;) {
         eventSemaphore.wait();
 
@@ -670,52 +1009,43 @@ Sampler::monitorEvents()
                              sizeof(ProcessEvent));
         switch (event.type) {
         case ProcessEvent::TYPE_ABORTED:
+            stopDiskThreads(event.data.command, false);
             idle = true;
             emit statusChanged(tr("Idle."));
             emit jobAborted();
-            emit progressChanged(0.0);
-            command = &(event.data.command);
+            reportProgress(0.0);
             break;
         case ProcessEvent::TYPE_COMPLETE:
-            command = &(event.data.command);
-            job = command->job;
-            if (job->getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
-                synthclone::SampleOutputStream *stream =
-                    qobject_cast<synthclone::SampleOutputStream *>
-                    (command->stream);
-                float **sampleBuffers = command->sampleBuffers;
-                float *streamBuffer = new float[channels];
-                for (jack_nframes_t i = 0; i < command->totalSampleFrames;
-                     i++) {
-                    for (synthclone::SampleChannelCount j = 0; j < channels;
-                         j++) {
-                        streamBuffer[j] = sampleBuffers[j][i];
-                    }
-                    stream->write(streamBuffer, 1);
-                }
-                delete[] streamBuffer;
+            message = stopDiskThreads(event.data.command, true);
+            if (message.isEmpty() && event.data.command.measureLatency) {
+                latency.storeRelease(measuredLatency);
+                latencyMeasured.storeRelease(1);
+                latencyMeasurementRequested.storeRelease(0);
+                emit latencyChanged();
             }
             idle = true;
             emit statusChanged(tr("Idle."));
-            emit jobCompleted();
-            emit progressChanged(0.0);
+            if (message.isEmpty()) {
+                emit jobXrunsCounted(xruns.fetchAndStoreOrdered(0));
+                emit jobCompleted();
+            } else {
+                emit jobError(message);
+            }
+            reportProgress(0.0);
             break;
         case ProcessEvent::TYPE_ERROR:
+            message = stopDiskThreads(event.data.error.command, false);
             idle = true;
             emit statusChanged(tr("Idle."));
-            emit jobError(event.data.error.message);
-            command = &(event.data.error.command);
+            emit jobError(message.isEmpty() ?
+                          QString(event.data.error.message) : message);
             break;
         case ProcessEvent::TYPE_PROGRESS:
-            emit progressChanged(event.data.progress);
+            reportProgress(event.data.progress);
             continue;
         default:
             assert(false);
         }
-        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-            delete[] command->sampleBuffers[i];
-        }
-        delete[] command->sampleBuffers;
     }
 }
 
@@ -731,6 +1061,197 @@ Sampler::openPort(const char *name, const char *type, JackPortFlags flags)
     return port;
 }
 
+bool
+Sampler::processParallelJobs(void *midiBuffer, jack_nframes_t frames)
+{
+    assert(command.parallelJobs);
+
+    // Each capture lags the MIDI events by the latency, so that it starts
+    // when its zone's audio reaches the input ports.
+    int count = command.parallelJobCount;
+    jack_nframes_t endFrame = currentFrame + frames;
+    ParallelJob *jobs = command.parallelJobs;
+    jack_nframes_t latencyFrames = command.latencyFrames;
+    int i;
+    for (i = 0; i < count; i++) {
+        ParallelJob &job = jobs[i];
+        jack_nframes_t captureFrame =
+            qBound(currentFrame, latencyFrames, endFrame);
+        jack_nframes_t lastCaptureFrame =
+            qBound(currentFrame, latencyFrames + job.captureFrames, endFrame);
+        if (captureFrame == lastCaptureFrame) {
+            continue;
+        }
+        DiskThread *thread = job.diskThread;
+        jack_nframes_t copyFrames = lastCaptureFrame - captureFrame;
+        if (thread->getWriteSpace() < copyFrames) {
+            setProcessErrorState(ERROR_CAPTURE_OVERRUN);
+            return false;
+        }
+        for (synthclone::SampleChannelCount j = 0; j < channels; j++) {
+            thread->write(j, static_cast<jack_default_audio_sample_t *>
+                          (jack_port_get_buffer(job.inputPorts[j], frames)) +
+                          (captureFrame - currentFrame), copyFrames);
+        }
+        thread->commit();
+    }
+
+    // JACK MIDI events have to be queued in time order, so the events that
+    // fall within this period are sent earliest first.  Every zone starts at
+    // frame 0.  An event at the very end of a zone is moved to the last frame
+    // of the period so the zone can finish in this period.
+    for (;;) {
+        ParallelJob *nextJob = 0;
+        jack_nframes_t nextFrame = 0;
+        for (i = 0; i < count; i++) {
+            ParallelJob &job = jobs[i];
+            jack_nframes_t frame;
+            switch (job.phase) {
+            case ZONEPHASE_START:
+                frame = 0;
+                break;
+            case ZONEPHASE_NOTE_OFF:
+                frame = job.sampleFrames;
+                if (frame >= endFrame) {
+                    continue;
+                }
+                break;
+            case ZONEPHASE_RESET:
+                frame = job.endFrame;
+                if (frame > endFrame) {
+                    continue;
+                }
+                break;
+            default:
+                continue;
+            }
+            if ((! nextJob) || (frame < nextFrame)) {
+                nextFrame = frame;
+                nextJob = &job;
+            }
+        }
+        if (! nextJob) {
+            break;
+        }
+        jack_nframes_t time = qMin(nextFrame - currentFrame, frames - 1);
+        switch (nextJob->phase) {
+        case ZONEPHASE_START:
+            if (! sendZoneStartMessages(midiBuffer, nextJob->zone, time)) {
+                return false;
+            }
+            nextJob->phase = ZONEPHASE_NOTE_OFF;
+            break;
+        case ZONEPHASE_NOTE_OFF:
+            if (! sendZoneNoteOffMessage(midiBuffer, nextJob->zone, time)) {
+                return false;
+            }
+            nextJob->phase = ZONEPHASE_RESET;
+            break;
+        default:
+            if (! sendZoneResetMessages(midiBuffer, nextJob->zone, time)) {
+                return false;
+            }
+            nextJob->phase = ZONEPHASE_DONE;
+            parallelJobsRemaining--;
+        }
+    }
+
+    jack_nframes_t totalFrames = latencyFrames + command.totalSampleFrames;
+    currentFrame = endFrame;
+    sendProgressEvent(totalFrames ? static_cast<float>
+                      (qMin(currentFrame, totalFrames)) / totalFrames : 1.0);
+    return true;
+}
+
+bool
+Sampler::processSweep(void *midiBuffer, jack_nframes_t frames)
+{
+    assert(command.sweepJobs);
+
+    // The recording lags the MIDI events by the latency, so that each span of
+    // the recording starts when its zone's audio reaches the input ports.
+    jack_nframes_t endFrame = currentFrame + frames;
+    jack_nframes_t latencyFrames = command.latencyFrames;
+    jack_nframes_t totalFrames = latencyFrames + command.totalSampleFrames;
+    jack_nframes_t captureFrame =
+        qBound(currentFrame, latencyFrames, endFrame);
+    jack_nframes_t lastCaptureFrame =
+        qBound(currentFrame, totalFrames, endFrame);
+    if (diskThread.getWriteSpace() < (lastCaptureFrame - captureFrame)) {
+        setProcessErrorState(ERROR_CAPTURE_OVERRUN);
+        return false;
+    }
+
+    // Each span is recorded from the input ports for its zone's MIDI channel.
+    while (captureFrame < lastCaptureFrame) {
+        jack_nframes_t recordFrame = captureFrame - latencyFrames;
+        while (command.sweepJobs[sweepCaptureIndex].endFrame <= recordFrame) {
+            sweepCaptureIndex++;
+        }
+        const SweepJob &job = command.sweepJobs[sweepCaptureIndex];
+        jack_nframes_t offset = captureFrame - currentFrame;
+        jack_nframes_t spanFrames =
+            qMin(lastCaptureFrame - latencyFrames, job.endFrame) - recordFrame;
+        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
+            diskThread.write(i, static_cast<jack_default_audio_sample_t *>
+                             (jack_port_get_buffer(job.inputPorts[i], frames)) +
+                             offset, spanFrames);
+        }
+        captureFrame += spanFrames;
+    }
+    diskThread.commit();
+
+    // Send every MIDI event that falls within this period at its exact frame
+    // offset.  An event at the very end of the sweep is moved to the last
+    // frame of the period so the sweep can finish in this period.
+    while (sweepJobIndex < command.sweepJobCount) {
+        const SweepJob &job = command.sweepJobs[sweepJobIndex];
+        if (sweepPhase == ZONEPHASE_START) {
+            if (job.startFrame >= endFrame) {
+                break;
+            }
+            if (! sendZoneStartMessages(midiBuffer, job.zone,
+                                        job.startFrame - currentFrame)) {
+                return false;
+            }
+            sweepPhase = ZONEPHASE_NOTE_OFF;
+        }
+        if (sweepPhase == ZONEPHASE_NOTE_OFF) {
+            if (job.noteOffFrame >= endFrame) {
+                break;
+            }
+            if (! sendZoneNoteOffMessage(midiBuffer, job.zone,
+                                         job.noteOffFrame - currentFrame)) {
+                return false;
+            }
+            sweepPhase = ZONEPHASE_RESET;
+        }
+        if (job.endFrame > endFrame) {
+            break;
+        }
+        if (! sendZoneResetMessages(midiBuffer, job.zone,
+                                    qMin(job.endFrame - currentFrame,
+                                         frames - 1))) {
+            return false;
+        }
+        sweepJobIndex++;
+        sweepPhase = ZONEPHASE_START;
+    }
+
+    currentFrame = endFrame;
+    sendProgressEvent(totalFrames ? static_cast<float>(lastCaptureFrame) /
+                      totalFrames : 1.0);
+    return true;
+}
+
+void
+Sampler::requestLatencyMeasurement()
+{
+    latencyMeasurementRequested.storeRelease(1);
+    emit statusChanged(tr("Latency will be measured during the next sampling "
+                          "job."));
+}
+
 void
 Sampler::sendCommand(const Command &command)
 {
@@ -755,7 +1276,8 @@ Sampler::sendJobFinalizationEvent(ProcessEvent::Type type)
 }
 
 bool
-Sampler::sendMIDIMessage(void *midiBuffer, synthclone::MIDIData status,
+Sampler::sendMIDIMessage(void *midiBuffer, jack_nframes_t time,
+                         synthclone::MIDIData status,
                          synthclone::MIDIData data1, synthclone::MIDIData data2)
 {
     assert(data1 < 0x80);
@@ -766,7 +1288,8 @@ Sampler::sendMIDIMessage(void *midiBuffer, synthclone::MIDIData status,
         assert(data2 < 0x80);
         size = 3;
     }
-    jack_midi_data_t *event = jack_midi_event_reserve(midiBuffer, 0, size);
+    jack_midi_data_t *event =
+        jack_midi_event_reserve(midiBuffer, time, size);
     if (! event) {
         jack_midi_clear_buffer(midiBuffer);
         setProcessErrorState(ERROR_MIDI_EVENT_RESERVE);
@@ -823,6 +1346,86 @@ Sampler::sendProgressEvent(float progress)
     sendProcessEvent(event);
 }
 
+void
+Sampler::setInputGroupCount(int count)
+{
+    CONFIRM(! active, tr("input groups can't be changed while active"));
+    CONFIRM((count >= 1) && (count <= MIDI_CHANNEL_COUNT),
+            tr("'%1': invalid input group count").arg(count));
+    inputGroupCount = count;
+}
+
+void
+Sampler::setLatency(jack_nframes_t latency)
+{
+    this->latency.storeRelease(latency);
+    latencyMeasured.storeRelease(1);
+}
+
+void
+Sampler::setReadAheadTime(float readAheadTime)
+{
+    CONFIRM(readAheadTime > 0.0, tr("'%1': invalid read-ahead time").
+            arg(readAheadTime));
+    this->readAheadTime = readAheadTime;
+}
+
+bool
+Sampler::sendZoneNoteOffMessage(void *midiBuffer,
+                                const synthclone::Zone *zone,
+                                jack_nframes_t time)
+{
+    return sendMIDIMessage(midiBuffer, time, 0x80 | (zone->getChannel() - 1),
+                           zone->getNote(), zone->getVelocity());
+}
+
+bool
+Sampler::sendZoneResetMessages(void *midiBuffer, const synthclone::Zone *zone,
+                               jack_nframes_t time)
+{
+    synthclone::MIDIData midiChannel = zone->getChannel() - 1;
+    return sendMIDIMessage(midiBuffer, time, 0xb0 | midiChannel, 0x78, 0) &&
+        sendMIDIMessage(midiBuffer, time, 0xb0 | midiChannel, 0x79, 0);
+}
+
+bool
+Sampler::sendZoneStartMessages(void *midiBuffer, const synthclone::Zone *zone,
+                               jack_nframes_t time)
+{
+    using synthclone::Zone;
+
+    const Zone::ControlMap &controlValues = zone->getControlMap();
+    Zone::ControlMap::const_iterator end = controlValues.end();
+    synthclone::MIDIData midiChannel = zone->getChannel() - 1;
+    for (Zone::ControlMap::const_iterator iter = controlValues.begin();
+         iter != end; iter++) {
+        if (! sendMIDIMessage(midiBuffer, time, 0xb0 | midiChannel,
+                              iter.key(), iter.value())) {
+            return false;
+        }
+    }
+    synthclone::MIDIData note = zone->getNote();
+    if (! sendMIDIMessage(midiBuffer, time, 0x90 | midiChannel, note,
+                          zone->getVelocity())) {
+        return false;
+    }
+    synthclone::MIDIData pressure = zone->getChannelPressure();
+    if (pressure != synthclone::MIDI_VALUE_NOT_SET) {
+        if (! sendMIDIMessage(midiBuffer, time, 0xb0 | midiChannel,
+                              pressure)) {
+            return false;
+        }
+    }
+    synthclone::MIDIData aftertouch = zone->getAftertouch();
+    if (aftertouch != synthclone::MIDI_VALUE_NOT_SET) {
+        if (! sendMIDIMessage(midiBuffer, time, 0xa0 | midiChannel, note,
+                              aftertouch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 Sampler::setProcessErrorState(const char *message)
 {
@@ -837,50 +1440,232 @@ Sampler::startJob(const synthclone::SamplerJob &job,
     assert(idle);
     assert(stream.getChannels() == channels);
     assert(stream.getSampleRate() == getSampleRate());
+    jack_nframes_t bufferFrames;
     Command command;
-    jack_default_audio_sample_t **sampleBuffers;
     jack_nframes_t sampleFrames;
     jack_nframes_t sampleRate = static_cast<jack_nframes_t>
         (stream.getSampleRate());
     const synthclone::Zone *zone = job.getZone();
+    command.inputPorts = getInputPorts(zone);
+    command.latencyFrames = 0;
+    command.measureLatency = false;
+    command.onsetThreshold = 0.0;
+    command.silenceHoldFrames = static_cast<jack_nframes_t>
+        (getSilenceHoldTime() * sampleRate);
+    command.silenceThreshold = getSilenceThreshold();
     if (job.getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
         jack_nframes_t releaseFrames = static_cast<jack_nframes_t>
             (zone->getReleaseTime() * sampleRate);
         sampleFrames = static_cast<jack_nframes_t>
             (zone->getSampleTime() * sampleRate);
-        sampleBuffers = new jack_default_audio_sample_t *[channels];
-        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-            sampleBuffers[i] = new jack_default_audio_sample_t[sampleFrames];
+
+        // A measurement waits for the note's onset.  Otherwise, the measured
+        // latency is skipped, or the latency reported by JACK if there's no
+        // measurement.
+        command.measureLatency =
+            static_cast<bool>(latencyMeasurementRequested.loadAcquire());
+        if (command.measureLatency) {
+            command.latencyFrames = static_cast<jack_nframes_t>
+                (MAXIMUM_LATENCY_TIME * sampleRate);
+        } else {
+            command.latencyFrames = isLatencyMeasured() ? getLatency() :
+                getPortLatency(command.inputPorts);
         }
+        float threshold = getSilenceThreshold();
+        command.onsetThreshold = (threshold > 0.0) ? threshold :
+            DEFAULT_ONSET_THRESHOLD;
+
+        // When silence detection is on, the release is captured as well, and
+        // the capture is truncated once the release falls silent.
+        jack_nframes_t captureFrames = sampleFrames;
+        if (command.silenceThreshold > 0.0) {
+            captureFrames += releaseFrames;
+        }
+        bufferFrames =
+            qMax(static_cast<jack_nframes_t>(1),
+                 qMin(captureFrames, sampleRate * CAPTURE_BUFFER_SECONDS));
+        diskThread.startCapture
+            (qobject_cast<synthclone::SampleOutputStream *>(&stream),
+             channels, captureFrames, bufferFrames);
         emit statusChanged(tr("Sampling ..."));
         command.totalReleaseFrames = releaseFrames;
     } else {
         sampleFrames = static_cast<jack_nframes_t>(stream.getFrames());
-        sampleBuffers = new jack_default_audio_sample_t *[channels];
-        for (synthclone::SampleChannelCount i = 0; i < channels; i++) {
-            sampleBuffers[i] = new jack_default_audio_sample_t[sampleFrames];
-        }
-        synthclone::SampleInputStream *inputStream =
-            qobject_cast<synthclone::SampleInputStream *>(&stream);
-        float *buffer = new float[channels];
-        for (synthclone::SampleFrameCount i = 0; i < sampleFrames; i++) {
-            synthclone::SampleFrameCount count = inputStream->read(buffer, 1);
-            assert(count == 1);
-            for (synthclone::SampleChannelCount j = 0; j < channels; j++) {
-                sampleBuffers[j][i] = buffer[j];
-            }
-        }
-        delete[] buffer;
+        bufferFrames = static_cast<jack_nframes_t>(readAheadTime * sampleRate);
+        bufferFrames = qMax(static_cast<jack_nframes_t>(1),
+                            qMin(sampleFrames, bufferFrames));
+        diskThread.startPlayback
+            (qobject_cast<synthclone::SampleInputStream *>(&stream),
+             channels, sampleFrames, bufferFrames,
+             static_cast<jack_nframes_t>(PREFETCH_TIME * sampleRate));
         emit statusChanged(tr("Playing sample ..."));
     }
     command.job = &job;
-    command.sampleBuffers = sampleBuffers;
+    command.parallelJobCount = 0;
+    command.parallelJobs = 0;
     command.stream = &stream;
+    command.sweepJobCount = 0;
+    command.sweepJobs = 0;
     command.totalSampleFrames = sampleFrames;
     idle = false;
     sendCommand(command);
 }
 
+void
+Sampler::startParallelJobs(const QList<const synthclone::SamplerJob *> &jobs,
+                           const QList<synthclone::SampleStream *> &streams)
+{
+    assert(idle);
+    assert(jobs.count() >= 2);
+    assert(jobs.count() == streams.count());
+    jack_nframes_t sampleRate = jack_get_sample_rate(client);
+    int count = jobs.count();
+    while (parallelDiskThreads.count() < (count - 1)) {
+        parallelDiskThreads.append(new DiskThread());
+    }
+    parallelJobs.resize(count);
+    jack_nframes_t totalFrames = 0;
+    for (int i = 0; i < count; i++) {
+        synthclone::SampleStream *stream = streams[i];
+        assert(stream->getChannels() == channels);
+        assert(stream->getSampleRate() == getSampleRate());
+        const synthclone::Zone *zone = jobs[i]->getZone();
+        assert(isParallelChannel(zone->getChannel()));
+        ParallelJob &job = parallelJobs[i];
+        job.diskThread = i ? parallelDiskThreads[i - 1] : &diskThread;
+        job.inputPorts = getInputPorts(zone);
+        job.phase = ZONEPHASE_START;
+        job.sampleFrames = static_cast<jack_nframes_t>
+            (zone->getSampleTime() * sampleRate);
+        job.endFrame = job.sampleFrames + static_cast<jack_nframes_t>
+            (zone->getReleaseTime() * sampleRate);
+        job.zone = zone;
+        totalFrames = qMax(totalFrames, job.endFrame);
+
+        // Parallel jobs capture the whole release when silence detection is
+        // on, but don't stop early.
+        job.captureFrames = (getSilenceThreshold() > 0.0) ? job.endFrame :
+            job.sampleFrames;
+        jack_nframes_t bufferFrames =
+            qMax(static_cast<jack_nframes_t>(1),
+                 qMin(job.captureFrames, sampleRate * CAPTURE_BUFFER_SECONDS));
+        job.diskThread->startCapture
+            (qobject_cast<synthclone::SampleOutputStream *>(stream), channels,
+             job.captureFrames, bufferFrames);
+    }
+
+    // The captures start after the measured latency, or the longest latency
+    // reported by JACK for the zones' input ports if there's no measurement.
+    // A pending measurement waits for the next single sampling job.
+    jack_nframes_t latencyFrames = 0;
+    if (isLatencyMeasured()) {
+        latencyFrames = getLatency();
+    } else {
+        for (int i = 0; i < count; i++) {
+            latencyFrames = qMax(latencyFrames,
+                                 getPortLatency(parallelJobs[i].inputPorts));
+        }
+    }
+    emit statusChanged(tr("Sampling %1 zones in parallel ...").arg(count));
+
+    Command command;
+    command.inputPorts = 0;
+    command.job = jobs[0];
+    command.latencyFrames = latencyFrames;
+    command.measureLatency = false;
+    command.onsetThreshold = 0.0;
+    command.parallelJobCount = count;
+    command.parallelJobs = parallelJobs.data();
+    command.silenceHoldFrames = 0;
+    command.silenceThreshold = 0.0;
+    command.stream = streams[0];
+    command.sweepJobCount = 0;
+    command.sweepJobs = 0;
+    command.totalReleaseFrames = 0;
+    command.totalSampleFrames = totalFrames;
+    idle = false;
+    sendCommand(command);
+}
+
+void
+Sampler::startSweep(const QList<const synthclone::SamplerJob *> &jobs,
+                    synthclone::SampleStream &stream)
+{
+    assert(idle);
+    assert(! jobs.isEmpty());
+    assert(stream.getChannels() == channels);
+    assert(stream.getSampleRate() == getSampleRate());
+    jack_nframes_t sampleRate = static_cast<jack_nframes_t>
+        (stream.getSampleRate());
+    int count = jobs.count();
+    sweepJobs.resize(count);
+    jack_nframes_t totalFrames = 0;
+    for (int i = 0; i < count; i++) {
+        const synthclone::Zone *zone = jobs[i]->getZone();
+        SweepJob &job = sweepJobs[i];
+        job.inputPorts = getInputPorts(zone);
+        job.zone = zone;
+        job.startFrame = totalFrames;
+        job.noteOffFrame = totalFrames + static_cast<jack_nframes_t>
+            (zone->getSampleTime() * sampleRate);
+        job.endFrame = job.noteOffFrame + static_cast<jack_nframes_t>
+            (zone->getReleaseTime() * sampleRate);
+        totalFrames = job.endFrame;
+    }
+
+    // The recording starts after the measured latency, or the longest latency
+    // reported by JACK for the zones' input ports if there's no measurement.
+    // A pending measurement waits for the next single sampling job.
+    jack_nframes_t latencyFrames = 0;
+    if (isLatencyMeasured()) {
+        latencyFrames = getLatency();
+    } else {
+        for (int i = 0; i < count; i++) {
+            latencyFrames = qMax(latencyFrames,
+                                 getPortLatency(sweepJobs[i].inputPorts));
+        }
+    }
+    jack_nframes_t bufferFrames =
+        qMax(static_cast<jack_nframes_t>(1),
+             qMin(totalFrames, sampleRate * CAPTURE_BUFFER_SECONDS));
+    diskThread.startCapture
+        (qobject_cast<synthclone::SampleOutputStream *>(&stream), channels,
+         totalFrames, bufferFrames);
+    emit statusChanged(tr("Sampling %1 zones ...").arg(count));
+
+    Command command;
+    command.inputPorts = 0;
+    command.job = jobs[0];
+    command.latencyFrames = latencyFrames;
+    command.measureLatency = false;
+    command.onsetThreshold = 0.0;
+    command.parallelJobCount = 0;
+    command.parallelJobs = 0;
+    command.silenceHoldFrames = 0;
+    command.silenceThreshold = 0.0;
+    command.stream = &stream;
+    command.sweepJobCount = count;
+    command.sweepJobs = sweepJobs.constData();
+    command.totalReleaseFrames = 0;
+    command.totalSampleFrames = totalFrames;
+    idle = false;
+    sendCommand(command);
+}
+
+QString
+Sampler::stopDiskThreads(const Command &command, bool finish)
+{
+    QString message = finish ? diskThread.finish() : diskThread.stop();
+    for (int i = 1; i < command.parallelJobCount; i++) {
+        DiskThread *thread = parallelDiskThreads[i - 1];
+        QString threadMessage = finish ? thread->finish() : thread->stop();
+        if (message.isEmpty()) {
+            message = threadMessage;
+        }
+    }
+    return message;
+}
+
 void
 Sampler::updateCommandState()
 {
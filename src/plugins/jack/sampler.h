@@ -25,12 +25,15 @@
 #include <jack/ringbuffer.h>
 #include <jack/session.h>
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QDir>
 #include <QtCore/QMutex>
+#include <QtCore/QVector>
 
 #include <synthclone/sampler.h>
 #include <synthclone/semaphore.h>
 
+#include "diskthread.h"
 #include "eventthread.h"
 
 class Sampler: public synthclone::Sampler {
@@ -58,18 +61,61 @@ public:
     synthclone::SampleChannelCount
     getChannelCount() const;
 
+    int
+    getInputGroupCount() const;
+
+    jack_nframes_t
+    getLatency() const;
+
+    float
+    getReadAheadTime() const;
+
     synthclone::SampleRate
     getSampleRate() const;
 
+    bool
+    isLatencyMeasured() const;
+
+    bool
+    isParallelChannel(synthclone::MIDIData channel) const;
+
+    bool
+    isSweepSupported() const;
+
+    void
+    setInputGroupCount(int count);
+
+    void
+    setLatency(jack_nframes_t latency);
+
+    void
+    setReadAheadTime(float readAheadTime);
+
     void
     startJob(const synthclone::SamplerJob &job,
              synthclone::SampleStream &stream);
 
+    void
+    startParallelJobs(const QList<const synthclone::SamplerJob *> &jobs,
+                      const QList<synthclone::SampleStream *> &streams);
+
+    void
+    startSweep(const QList<const synthclone::SamplerJob *> &jobs,
+               synthclone::SampleStream &stream);
+
+public slots:
+
+    void
+    requestLatencyMeasurement();
+
 signals:
 
     void
     fatalError(const QString &message);
 
+    void
+    latencyChanged();
+
     void
     sampleRateChanged();
 
@@ -78,10 +124,44 @@ signals:
 
 private:
 
+    enum ZonePhase {
+        ZONEPHASE_DONE,
+        ZONEPHASE_NOTE_OFF,
+        ZONEPHASE_RESET,
+        ZONEPHASE_START
+    };
+
+    struct ParallelJob {
+        jack_nframes_t captureFrames;
+        DiskThread *diskThread;
+        jack_nframes_t endFrame;
+        jack_port_t **inputPorts;
+        ZonePhase phase;
+        jack_nframes_t sampleFrames;
+        const synthclone::Zone *zone;
+    };
+
+    struct SweepJob {
+        jack_nframes_t endFrame;
+        jack_port_t **inputPorts;
+        jack_nframes_t noteOffFrame;
+        jack_nframes_t startFrame;
+        const synthclone::Zone *zone;
+    };
+
     struct Command {
+        jack_port_t **inputPorts;
         const synthclone::SamplerJob *job;
-        jack_default_audio_sample_t **sampleBuffers;
+        jack_nframes_t latencyFrames;
+        bool measureLatency;
+        float onsetThreshold;
+        int parallelJobCount;
+        ParallelJob *parallelJobs;
+        jack_nframes_t silenceHoldFrames;
+        float silenceThreshold;
         synthclone::SampleStream *stream;
+        int sweepJobCount;
+        const SweepJob *sweepJobs;
         jack_nframes_t totalReleaseFrames;
         jack_nframes_t totalSampleFrames;
     };
@@ -130,10 +210,13 @@ private:
         STATE_COMPLETED,
         STATE_ERROR,
         STATE_IDLE,
+        STATE_PARALLEL,
         STATE_PLAY,
         STATE_SAMPLE,
+        STATE_SAMPLE_LATENCY,
         STATE_SAMPLE_SEND_PRE_MIDI,
-        STATE_SAMPLE_RELEASE
+        STATE_SAMPLE_RELEASE,
+        STATE_SWEEP
     };
 
     // Static wrappers
@@ -150,8 +233,14 @@ private:
     static void
     handleShutdownEvent(jack_status_t code, const char *reason, void *ptr);
 
+    static int
+    handleXrunEvent(void *ptr);
+
     // Members
 
+    bool
+    captureReleaseTail(jack_nframes_t frames);
+
     void
     clean();
 
@@ -161,9 +250,21 @@ private:
     void
     closePorts();
 
+    void
+    deleteInputGroupPorts();
+
+    jack_nframes_t
+    findOnset(jack_nframes_t frames);
+
     const char *
     getErrorMessage(jack_status_t status) const;
 
+    jack_port_t **
+    getInputPorts(const synthclone::Zone *zone) const;
+
+    jack_nframes_t
+    getPortLatency(jack_port_t **inputPorts) const;
+
     int
     handleProcessEvent(jack_nframes_t frames);
 
@@ -176,10 +277,19 @@ private:
     void
     handleShutdownEvent(jack_status_t code, const char *reason);
 
+    int
+    handleXrunEvent();
+
     jack_port_t **
     initializeAudioPorts(const QString &prefix, JackPortFlags flags,
                          synthclone::SampleChannelCount channels);
 
+    void
+    initializeHelperThread();
+
+    bool
+    isCapturing() const;
+
     bool
     isCommandAborted();
 
@@ -189,6 +299,12 @@ private:
     jack_port_t *
     openPort(const char *name, const char *type, JackPortFlags flags);
 
+    bool
+    processParallelJobs(void *midiBuffer, jack_nframes_t frames);
+
+    bool
+    processSweep(void *midiBuffer, jack_nframes_t frames);
+
     void
     sendCommand(const Command &command);
 
@@ -196,7 +312,8 @@ private:
     sendJobFinalizationEvent(ProcessEvent::Type type);
 
     bool
-    sendMIDIMessage(void *midiBuffer, synthclone::MIDIData status,
+    sendMIDIMessage(void *midiBuffer, jack_nframes_t time,
+                    synthclone::MIDIData status,
                     synthclone::MIDIData data1,
                     synthclone::MIDIData data2=synthclone::MIDI_VALUE_NOT_SET);
 
@@ -212,33 +329,69 @@ private:
     void
     sendProgressEvent(float progress);
 
+    bool
+    sendZoneNoteOffMessage(void *midiBuffer, const synthclone::Zone *zone,
+                           jack_nframes_t time);
+
+    bool
+    sendZoneResetMessages(void *midiBuffer, const synthclone::Zone *zone,
+                          jack_nframes_t time);
+
+    bool
+    sendZoneStartMessages(void *midiBuffer, const synthclone::Zone *zone,
+                          jack_nframes_t time);
+
     void
     setProcessErrorState(const char *message);
 
+    QString
+    stopDiskThreads(const Command &command, bool finish);
+
     void
     updateCommandState();
 
     bool aborted;
     volatile bool active;
     QMutex activeMutex;
+    jack_nframes_t captureOffset;
+    QAtomicInt capturing;
+    QVector<jack_port_t **> channelInputPorts;
     synthclone::SampleChannelCount channels;
     jack_client_t *client;
     Command command;
     jack_ringbuffer_t *commandBuffer;
     jack_nframes_t currentFrame;
+    DiskThread diskThread;
     const char *errorMessage;
     synthclone::Semaphore eventSemaphore;
     EventThread eventThread;
     bool idle;
+    int inputGroupCount;
     jack_port_t **inputPorts;
+    // The latency state is read by the main thread and updated by the event
+    // thread when a measurement completes.
+    QAtomicInteger<jack_nframes_t> latency;
+    QAtomicInt latencyMeasured;
+    QAtomicInt latencyMeasurementRequested;
+    jack_nframes_t measuredLatency;
     jack_port_t *midiPort;
     jack_port_t **monitorPorts;
     jack_port_t **outputPorts;
+    QList<DiskThread *> parallelDiskThreads;
+    QVector<ParallelJob> parallelJobs;
+    int parallelJobsRemaining;
     jack_ringbuffer_t *priorityEventBuffer;
     jack_ringbuffer_t *processEventBuffer;
     int progress;
+    float readAheadTime;
     QList<jack_port_t *> registeredPorts;
+    jack_nframes_t silentFrames;
     State state;
+    int sweepCaptureIndex;
+    int sweepJobIndex;
+    QVector<SweepJob> sweepJobs;
+    ZonePhase sweepPhase;
+    QAtomicInt xruns;
 
 };
 
@@ -355,24 +355,24 @@ Effect::process(const synthclone::Zone &/*zone*/,
         synthclone::SampleFrameCount framesProcessed = 0;
         for (; (totalFrames - framesProcessed) > 65536;
              framesProcessed += 65536) {
-            emit progressChanged(static_cast<float>(framesProcessed) /
-                                 static_cast<float>(totalFrames));
+            reportProgress(static_cast<float>(framesProcessed) /
+                           static_cast<float>(totalFrames));
             runInstances(inputStream, outputStream, sampleStreamData, 65536);
         }
         assert(framesProcessed != totalFrames);
-        emit progressChanged(static_cast<float>(framesProcessed) /
-                             static_cast<float>(totalFrames));
+        reportProgress(static_cast<float>(framesProcessed) /
+                       static_cast<float>(totalFrames));
         runInstances(inputStream, outputStream, sampleStreamData,
                      totalFrames - framesProcessed);
     }
-    emit progressChanged(1.0);
+    reportProgress(1.0);
 
     emit statusChanged(tr("Deactivating LV2 instances ..."));
     for (int i = 0; i < instanceCount; i++) {
         instances[i]->deactivate();
     }
 
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     emit statusChanged("");
 }
 
@@ -0,0 +1,185 @@
+/*
+ * libsynthclone_portmedia - PortAudio/PortMIDI sampler plugin for `synthclone`
+ * Copyright (C) 2012 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <cassert>
+
+#include <synthclone/error.h>
+
+#include "diskthread.h"
+
+// Static data
+
+// The maximum number of frames written to the sample stream with one 'write'
+// call.
+static const synthclone::SampleFrameCount TRANSFER_FRAMES = 4096;
+
+// Class definition
+
+DiskThread::DiskThread(QObject *parent):
+    QThread(parent),
+    capturing(0),
+    stopRequested(0),
+    terminating(0),
+    truncatedFrames(-1)
+{
+    buffer = 0;
+}
+
+DiskThread::~DiskThread()
+{
+    if (isRunning()) {
+        terminating.storeRelease(1);
+        semaphore.post();
+        wait();
+    }
+    freeBuffer();
+}
+
+void
+DiskThread::commit()
+{
+    semaphore.post();
+}
+
+QString
+DiskThread::finish()
+{
+    idleSemaphore.acquire();
+    freeBuffer();
+    return errorMessage;
+}
+
+void
+DiskThread::freeBuffer()
+{
+    delete buffer;
+    buffer = 0;
+}
+
+RingBuffer<float> *
+DiskThread::getBuffer()
+{
+    return buffer;
+}
+
+synthclone::SampleFrameCount
+DiskThread::getTotalFrames() const
+{
+    int frames = truncatedFrames.loadAcquire();
+    return (frames < 0) ? totalFrames :
+        qMin(totalFrames, static_cast<synthclone::SampleFrameCount>(frames));
+}
+
+void
+DiskThread::run()
+{
+    for (;;) {
+        semaphore.wait();
+        if (terminating.loadAcquire()) {
+            break;
+        }
+        if (! capturing.loadAcquire()) {
+            continue;
+        }
+        bool stopped = stopRequested.loadAcquire();
+        if (! stopped) {
+            try {
+                writeFrames();
+            } catch (synthclone::Error &e) {
+                errorMessage = e.getMessage();
+                stopped = true;
+            }
+        }
+        if (stopped || (transferredFrames == getTotalFrames())) {
+            capturing.storeRelease(0);
+            idleSemaphore.release();
+        }
+    }
+}
+
+void
+DiskThread::startCapture(synthclone::SampleOutputStream *stream,
+                         synthclone::SampleChannelCount channels,
+                         synthclone::SampleFrameCount frames,
+                         synthclone::SampleFrameCount bufferFrames)
+{
+    assert(! capturing.loadAcquire());
+    assert(! buffer);
+    assert(channels);
+    assert(bufferFrames > 0);
+    buffer = new RingBuffer<float>(static_cast<size_t>(bufferFrames) *
+                                   channels);
+    try {
+        buffer->lock();
+    } catch (synthclone::Error &e) {
+        qWarning("%s", qPrintable(e.getMessage()));
+    }
+    errorMessage.clear();
+    interleavedBuffer.resize(TRANSFER_FRAMES * channels);
+    stopRequested.store(0);
+    this->channels = channels;
+    this->stream = stream;
+    totalFrames = frames;
+    transferredFrames = 0;
+    truncatedFrames.store(-1);
+    if (! frames) {
+        idleSemaphore.release();
+        return;
+    }
+    if (! isRunning()) {
+        start();
+    }
+    capturing.storeRelease(1);
+}
+
+QString
+DiskThread::stop()
+{
+    stopRequested.storeRelease(1);
+    semaphore.post();
+    return finish();
+}
+
+void
+DiskThread::truncate(synthclone::SampleFrameCount frames)
+{
+    truncatedFrames.storeRelease(static_cast<int>(frames));
+    semaphore.post();
+}
+
+void
+DiskThread::writeFrames()
+{
+    float *interleavedData = interleavedBuffer.data();
+    synthclone::SampleFrameCount frames = getTotalFrames();
+    while (transferredFrames < frames) {
+        synthclone::SampleFrameCount available =
+            static_cast<synthclone::SampleFrameCount>
+            (buffer->getReadAvailable() / channels);
+        synthclone::SampleFrameCount count =
+            qMin(qMin(TRANSFER_FRAMES, frames - transferredFrames),
+                 available);
+        if (! count) {
+            break;
+        }
+        buffer->read(interleavedData, static_cast<size_t>(count) * channels);
+        stream->write(interleavedData, count);
+        transferredFrames += count;
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * libsynthclone_portmedia - PortAudio/PortMIDI sampler plugin for `synthclone`
+ * Copyright (C) 2012 Devin Anderson
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
+ * Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __DISKTHREAD_H__
+#define __DISKTHREAD_H__
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include <synthclone/sampleoutputstream.h>
+#include <synthclone/semaphore.h>
+
+#include "ringbuffer.h"
+
+class DiskThread: public QThread {
+
+    Q_OBJECT
+
+public:
+
+    explicit
+    DiskThread(QObject *parent=0);
+
+    ~DiskThread();
+
+    void
+    commit();
+
+    QString
+    finish();
+
+    RingBuffer<float> *
+    getBuffer();
+
+    void
+    startCapture(synthclone::SampleOutputStream *stream,
+                 synthclone::SampleChannelCount channels,
+                 synthclone::SampleFrameCount frames,
+                 synthclone::SampleFrameCount bufferFrames);
+
+    QString
+    stop();
+
+    void
+    truncate(synthclone::SampleFrameCount frames);
+
+protected:
+
+    void
+    run();
+
+private:
+
+    void
+    freeBuffer();
+
+    synthclone::SampleFrameCount
+    getTotalFrames() const;
+
+    void
+    writeFrames();
+
+    RingBuffer<float> *buffer;
+    QAtomicInt capturing;
+    synthclone::SampleChannelCount channels;
+    QString errorMessage;
+    QSemaphore idleSemaphore;
+    QVector<float> interleavedBuffer;
+    synthclone::Semaphore semaphore;
+    QAtomicInt stopRequested;
+    synthclone::SampleOutputStream *stream;
+    QAtomicInt terminating;
+    synthclone::SampleFrameCount totalFrames;
+    synthclone::SampleFrameCount transferredFrames;
+    QAtomicInt truncatedFrames;
+
+};
+
+#endif
@@ -28,7 +28,11 @@
 Participant::Participant(QObject *parent):
     synthclone::Participant(tr("Port Media"), 0, 0, 1, "Devin Anderson",
                             tr("Sampling via PortAudio/PortMIDI"), parent),
-    addSamplerAction(tr("PortMedia Sampler"))
+    addSamplerAction(tr("PortMedia Sampler")),
+    measureLatencyAction(tr("Measure Latency"),
+                         tr("Measure the delay between sending MIDI to the "
+                            "instrument and receiving its audio during the "
+                            "next sampling job"))
 {
     connect(&addSamplerAction, SIGNAL(triggered()),
             SLOT(handleAddSamplerActionTrigger()));
@@ -120,6 +124,8 @@ Participant::activate(synthclone::Context &context, const QVariant &/*state*/)
             sampler, SLOT(setAudioOutputDeviceIndex(int)));
     connect(&samplerView, SIGNAL(midiDeviceChangeRequest(int)),
             sampler, SLOT(setMIDIDeviceIndex(int)));
+    connect(&measureLatencyAction, SIGNAL(triggered()),
+            sampler, SLOT(requestLatencyMeasurement()));
     connect(&samplerView, SIGNAL(nameChangeRequest(const QString &)),
 	    sampler, SLOT(setName(const QString &)));
 
@@ -167,6 +173,8 @@ Participant::activate(synthclone::Context &context, const QVariant &/*state*/)
     connect(sampler, SIGNAL(nameChanged(const QString &)),
             &samplerView, SLOT(setName(const QString &)));
 
+    connect(sampler, SIGNAL(latencyChanged()),
+            &context, SLOT(setSessionModified()));
     connect(sampler, SIGNAL(midiError(const QString &)),
             SLOT(handleMIDIError(const QString &)));
     connect(sampler, SIGNAL(sampleRateChanged(synthclone::SampleRate)),
@@ -195,6 +203,7 @@ Participant::addSampler()
         context->addSampler(sampler);
     connect(&registration, SIGNAL(unregistered(QObject *)),
             SLOT(handleSamplerUnregistration(QObject *)));
+    context->addMenuAction(&measureLatencyAction, sampler);
     return true;
 }
 
@@ -253,6 +262,10 @@ Participant::getState(const synthclone::Sampler *sampler) const
     map["midiDeviceIndex"] = index;
     map["midiDeviceName"] = s->getMIDIDeviceName(index);
 
+    if (s->isLatencyMeasured()) {
+        map["latency"] = static_cast<qlonglong>(s->getLatency());
+    }
+
     return map;
 }
 
@@ -332,6 +345,7 @@ Participant::restoreSampler(const QVariant &state)
     synthclone::SampleChannelCount deviceChannelCount;
     QStringList errorMessages;
     int index;
+    qlonglong latency;
     QLocale locale = QLocale::system();
     const QVariantMap map = state.toMap();
     QString name;
@@ -537,6 +551,11 @@ findMIDIDevice:
     errorMessages.append(tr("could not find PortMIDI device '%1'").arg(name));
 
 checkErrors:
+    value = map.value("latency", "");
+    latency = value.toLongLong(&success);
+    if (success && (latency >= 0)) {
+        sampler->setLatency(static_cast<synthclone::SampleFrameCount>(latency));
+    }
     count = errorMessages.count();
     if (! count) {
         addSampler();
@@ -81,6 +81,7 @@ private:
 
     synthclone::MenuAction addSamplerAction;
     synthclone::Context *context;
+    synthclone::MenuAction measureLatencyAction;
     Sampler *sampler;
     SamplerView samplerView;
 
@@ -5,6 +5,7 @@ include(../plugins.pri)
 ################################################################################
 
 HEADERS += channelmapdelegate.h \
+    diskthread.h \
     eventthread.h \
     midithread.h \
     participant.h \
@@ -20,6 +21,7 @@ OBJECTS_DIR = $${MAKEDIR}/plugins/portmedia
 RCC_DIR = $${MAKEDIR}/plugins/portmedia
 RESOURCES += portmedia.qrc
 SOURCES += channelmapdelegate.cpp \
+    diskthread.cpp \
     eventthread.cpp \
     midithread.cpp \
     participant.cpp \
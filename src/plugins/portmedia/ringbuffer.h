@@ -24,6 +24,8 @@
 #include <cstdlib>
 #include <new>
 
+#include <synthclone/sampler.h>
+
 #include "portaudio/pa_ringbuffer.h"
 
 template<typename T>
@@ -44,10 +46,12 @@ public:
         }
         assert(realCount);
 
-        data = malloc(sizeof(T) * realCount);
+        dataSize = sizeof(T) * realCount;
+        data = malloc(dataSize);
         if (! data) {
             throw std::bad_alloc();
         }
+        locked = false;
         ring_buffer_size_t result = PaUtil_InitializeRingBuffer
             (&ringBuffer, sizeof(T), realCount, data);
         assert(result != -1);
@@ -55,15 +59,57 @@ public:
 
     ~RingBuffer()
     {
+        if (locked) {
+            synthclone::Sampler::unlockRealtimeMemory(data, dataSize);
+        }
         free(data);
     }
 
+    void
+    advanceWriteIndex(size_t count)
+    {
+        PaUtil_AdvanceRingBufferWriteIndex
+            (&ringBuffer, static_cast<ring_buffer_size_t>(count));
+    }
+
     void
     flush()
     {
         PaUtil_FlushRingBuffer(&ringBuffer);
     }
 
+    size_t
+    getReadAvailable() const
+    {
+        return static_cast<size_t>
+            (PaUtil_GetRingBufferReadAvailable(&ringBuffer));
+    }
+
+    size_t
+    getWriteAvailable() const
+    {
+        return static_cast<size_t>
+            (PaUtil_GetRingBufferWriteAvailable(&ringBuffer));
+    }
+
+    size_t
+    getWriteRegions(size_t count, T *&data1, size_t &size1, T *&data2,
+                    size_t &size2)
+    {
+        void *ptr1;
+        void *ptr2;
+        ring_buffer_size_t count1;
+        ring_buffer_size_t count2;
+        ring_buffer_size_t result = PaUtil_GetRingBufferWriteRegions
+            (&ringBuffer, static_cast<ring_buffer_size_t>(count), &ptr1,
+             &count1, &ptr2, &count2);
+        data1 = static_cast<T *>(ptr1);
+        data2 = static_cast<T *>(ptr2);
+        size1 = static_cast<size_t>(count1);
+        size2 = static_cast<size_t>(count2);
+        return static_cast<size_t>(result);
+    }
+
     bool
     isReadable() const
     {
@@ -78,21 +124,47 @@ public:
             (PaUtil_GetRingBufferWriteAvailable(&ringBuffer));
     }
 
+    void
+    lock()
+    {
+        assert(! locked);
+        synthclone::Sampler::lockRealtimeMemory(data, dataSize);
+        locked = true;
+    }
+
     bool
     read(T &obj)
     {
         return static_cast<bool>(PaUtil_ReadRingBuffer(&ringBuffer, &obj, 1));
     }
 
+    size_t
+    read(T *objs, size_t count)
+    {
+        return static_cast<size_t>
+            (PaUtil_ReadRingBuffer(&ringBuffer, objs,
+                                   static_cast<ring_buffer_size_t>(count)));
+    }
+
     bool
     write(const T &obj)
     {
         return static_cast<bool>(PaUtil_WriteRingBuffer(&ringBuffer, &obj, 1));
     }
 
+    size_t
+    write(const T *objs, size_t count)
+    {
+        return static_cast<size_t>
+            (PaUtil_WriteRingBuffer(&ringBuffer, objs,
+                                    static_cast<ring_buffer_size_t>(count)));
+    }
+
 private:
 
     void *data;
+    size_t dataSize;
+    bool locked;
     PaUtilRingBuffer ringBuffer;
 
 };
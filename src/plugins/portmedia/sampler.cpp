@@ -29,20 +29,50 @@
 
 #include "sampler.h"
 
+static const char *ERROR_CAPTURE_OVERRUN =
+    "Captured audio could not be written to disk fast enough";
+static const char *ERROR_LATENCY_MEASUREMENT =
+    "No signal was detected while measuring latency";
 static const char *ERROR_MIDI_BUFFER = "The MIDI ringbuffer is full";
 
+// The number of seconds of captured audio that can be buffered between the
+// audio callback and the disk thread.
+static const synthclone::SampleFrameCount CAPTURE_BUFFER_SECONDS = 4;
+
+// The number of milliseconds, beyond the input latency of the audio stream,
+// that the MIDI thread has to write a message to PortMidi before the message
+// is due.
+static const PmTimestamp MIDI_SCHEDULING_TIME = 20;
+
+// The amplitude that marks a note's onset when latency is measured, unless a
+// silence threshold is set.
+static const float DEFAULT_ONSET_THRESHOLD = 0.001;
+
+// The number of seconds to wait for a note's onset when latency is measured.
+static const float MAXIMUM_LATENCY_TIME = 1.0;
+
 // Callbacks
 
+PmTimestamp
+Sampler::getMIDITime(void *userData)
+{
+    Sampler *sampler = static_cast<Sampler *>(userData);
+    assert(sampler);
+    return static_cast<PmTimestamp>
+        (Pa_GetStreamTime(sampler->audioStream) * 1000.0);
+}
+
 int
 Sampler::handleProcessEvent(const void *input, void *output,
                             unsigned long frames,
-                            const PaStreamCallbackTimeInfo */*timeInfo*/,
+                            const PaStreamCallbackTimeInfo *timeInfo,
                             PaStreamCallbackFlags statusFlags, void *userData)
 {
     Sampler *sampler = static_cast<Sampler *>(userData);
     assert(sampler);
     return sampler->handleProcessEvent(static_cast<const float *>(input),
                                        static_cast<float *>(output), frames,
+                                       timeInfo->inputBufferAdcTime,
                                        statusFlags);
 }
 
@@ -55,7 +85,9 @@ Sampler::Sampler(const QString &name, synthclone::SampleChannelCount channels,
     eventBuffer(64),
     eventThread(this),
     midiBuffer(64),
-    midiThread(this)
+    midiThread(this),
+    sweepJobIndex(0),
+    sweepPhase(SWEEPPHASE_START)
 {
     assert(channels >= synthclone::SAMPLE_CHANNEL_COUNT_MINIMUM);
     assert((sampleRate == synthclone::SAMPLE_RATE_NOT_SET) ||
@@ -207,6 +239,8 @@ Sampler::Sampler(const QString &name, synthclone::SampleChannelCount channels,
     audioStream = 0;
     command.job = 0;
     command.sampleBuffer = 0;
+    command.silenceHoldFrames = 0;
+    command.silenceThreshold = 0.0;
     command.stream = 0;
     command.totalReleaseFrames = 0;
     command.totalSampleFrames = 0;
@@ -214,6 +248,9 @@ Sampler::Sampler(const QString &name, synthclone::SampleChannelCount channels,
     errorMessage = 0;
     idle = true;
     midiStream = 0;
+    latency.storeRelease(0);
+    latencyMeasured.storeRelease(0);
+    latencyMeasurementRequested.storeRelease(0);
     progress = 0;
     state = STATE_IDLE;
 }
@@ -256,49 +293,56 @@ Sampler::activate()
     eventBuffer.flush();
     midiBuffer.flush();
 
-    PmError pmError = Pm_OpenOutput(&midiStream,
-                                    midiDevices[midiDeviceIndex].id, 0, 0, 0,
-                                    0, 0);
-    if (pmError != pmNoError) {
-        throw synthclone::Error(tr("failed to open MIDI stream: %1").
-                                arg(Pm_GetErrorText(pmError)));
+    PaStreamParameters inputParameters;
+    const AudioDeviceData &inputData = getAudioInputDeviceData();
+    const PaDeviceInfo *info = inputData.info;
+    int inputChannels = info->maxInputChannels;
+    inputParameters.channelCount = inputChannels;
+    inputParameters.device = inputData.index;
+    inputParameters.hostApiSpecificStreamInfo = 0;
+    inputParameters.sampleFormat = paFloat32;
+    inputParameters.suggestedLatency = info->defaultHighInputLatency;
+
+    // If the sample rate isn't set, then take the sample rate from the given
+    // default sample rate for the input device.
+    synthclone::SampleRate streamSampleRate = sampleRate;
+    if (sampleRate == synthclone::SAMPLE_RATE_NOT_SET) {
+        streamSampleRate = static_cast<synthclone::SampleRate>
+            (info->defaultSampleRate);
+    }
+
+    PaStreamParameters outputParameters;
+    const AudioDeviceData &outputData = getAudioOutputDeviceData();
+    info = outputData.info;
+    int outputChannels = info->maxOutputChannels;
+    outputParameters.channelCount = outputChannels;
+    outputParameters.device = outputData.index;
+    outputParameters.hostApiSpecificStreamInfo = 0;
+    outputParameters.sampleFormat = paFloat32;
+    outputParameters.suggestedLatency = info->defaultHighOutputLatency;
+
+    PaError paError = Pa_OpenStream(&audioStream, &inputParameters,
+                                    &outputParameters, streamSampleRate,
+                                    paFramesPerBufferUnspecified, paNoFlag,
+                                    handleProcessEvent, this);
+    if (paError != paNoError) {
+        throw synthclone::Error(tr("failed to open audio stream: %1").
+                                arg(Pa_GetErrorText(paError)));
     }
     try {
-        PaStreamParameters inputParameters;
-        const AudioDeviceData &inputData = getAudioInputDeviceData();
-        const PaDeviceInfo *info = inputData.info;
-        int inputChannels = info->maxInputChannels;
-        inputParameters.channelCount = inputChannels;
-        inputParameters.device = inputData.index;
-        inputParameters.hostApiSpecificStreamInfo = 0;
-        inputParameters.sampleFormat = paFloat32;
-        inputParameters.suggestedLatency = info->defaultHighInputLatency;
-
-        // If the sample rate isn't set, then take the sample rate from the
-        // given default sample rate for the input device.
-        synthclone::SampleRate streamSampleRate = sampleRate;
-        if (sampleRate == synthclone::SAMPLE_RATE_NOT_SET) {
-            streamSampleRate = static_cast<synthclone::SampleRate>
-                (info->defaultSampleRate);
-        }
 
-        PaStreamParameters outputParameters;
-        const AudioDeviceData &outputData = getAudioOutputDeviceData();
-        info = outputData.info;
-        int outputChannels = info->maxOutputChannels;
-        outputParameters.channelCount = outputChannels;
-        outputParameters.device = outputData.index;
-        outputParameters.hostApiSpecificStreamInfo = 0;
-        outputParameters.sampleFormat = paFloat32;
-        outputParameters.suggestedLatency = info->defaultHighOutputLatency;
-
-        PaError paError = Pa_OpenStream(&audioStream, &inputParameters,
-                                        &outputParameters, streamSampleRate,
-                                        paFramesPerBufferUnspecified, paNoFlag,
-                                        handleProcessEvent, this);
-        if (paError != paNoError) {
-            throw synthclone::Error(tr("failed to open audio stream: %1").
-                                    arg(Pa_GetErrorText(paError)));
+        // MIDI messages are timestamped with the capture time of an input
+        // frame and delivered by PortMidi a fixed latency later, which has to
+        // cover the input latency of the audio stream.
+        const PaStreamInfo *streamInfo = Pa_GetStreamInfo(audioStream);
+        midiLatency = static_cast<PmTimestamp>
+            (ceil(streamInfo->inputLatency * 1000.0)) + MIDI_SCHEDULING_TIME;
+        PmError pmError = Pm_OpenOutput(&midiStream,
+                                        midiDevices[midiDeviceIndex].id, 0, 0,
+                                        getMIDITime, this, midiLatency);
+        if (pmError != pmNoError) {
+            throw synthclone::Error(tr("failed to open MIDI stream: %1").
+                                    arg(Pm_GetErrorText(pmError)));
         }
         try {
             idle = true;
@@ -315,19 +359,60 @@ Sampler::activate()
             }
 
             eventThread.start();
-            midiThread.start();
+            midiThread.start(QThread::TimeCriticalPriority);
             active = true;
 
         } catch (...) {
-            Pa_CloseStream(audioStream);
+            Pm_Close(midiStream);
             throw;
         }
     } catch (...) {
-        Pm_Close(midiStream);
+        Pa_CloseStream(audioStream);
         throw;
     }
 }
 
+bool
+Sampler::captureReleaseTail(const float *input, float *output,
+                            unsigned long frames)
+{
+    // Nothing is captured once the job is being aborted or has failed; the
+    // release just runs out.
+    if (aborted || errorMessage) {
+        return false;
+    }
+    synthclone::SampleFrameCount copyFrames =
+        qMin(static_cast<synthclone::SampleFrameCount>(frames),
+             command.totalReleaseFrames - currentFrame);
+    if (! recordData(input, output, copyFrames)) {
+        errorMessage = ERROR_CAPTURE_OVERRUN;
+        return true;
+    }
+    diskThread.commit();
+
+    // Find the last frame in this period where any channel reaches the
+    // threshold.  The signal has been silent since that frame.
+    float threshold = command.silenceThreshold;
+    synthclone::SampleFrameCount loudFrames = 0;
+    for (synthclone::SampleFrameCount i = copyFrames; i && (! loudFrames);
+         i--) {
+        const float *frame = input + ((i - 1) * audioInputDeviceChannelCount);
+        for (synthclone::SampleChannelCount j = 0; j < channels; j++) {
+            if (fabsf(frame[audioInputChannelIndices[j]]) >= threshold) {
+                loudFrames = i;
+                break;
+            }
+        }
+    }
+    silentFrames = loudFrames ? copyFrames - loudFrames :
+        silentFrames + copyFrames;
+    if (silentFrames < command.silenceHoldFrames) {
+        return false;
+    }
+    diskThread.truncate(command.totalSampleFrames + currentFrame + copyFrames);
+    return true;
+}
+
 void
 Sampler::copyData(const float *input, float *output, unsigned long totalFrames,
                   unsigned long startFrame)
@@ -352,7 +437,6 @@ Sampler::deactivate()
 {
     // Stop audio processing
     Pa_StopStream(audioStream);
-    Pa_CloseStream(audioStream);
 
     // Send signals to terminate threads
     eventSemaphore.post();
@@ -362,8 +446,10 @@ Sampler::deactivate()
     eventThread.wait();
     midiThread.wait();
 
-    // Now, the MIDI stream can be closed
+    // Now, the MIDI stream can be closed.  The audio stream is closed last, as
+    // it provides the MIDI stream's clock.
     Pm_Close(midiStream);
+    Pa_CloseStream(audioStream);
     active = false;
 }
 
@@ -411,6 +497,23 @@ Sampler::getAudioInputDeviceCount() const
     return audioAPIs[audioAPIIndex].inputDevices.count();
 }
 
+synthclone::SampleFrameCount
+Sampler::findOnset(const float *input, unsigned long frames) const
+{
+    float threshold = command.onsetThreshold;
+    synthclone::SampleFrameCount total =
+        static_cast<synthclone::SampleFrameCount>(frames);
+    for (synthclone::SampleFrameCount i = 0; i < total; i++) {
+        const float *frame = input + (i * audioInputDeviceChannelCount);
+        for (synthclone::SampleChannelCount j = 0; j < channels; j++) {
+            if (fabsf(frame[audioInputChannelIndices[j]]) >= threshold) {
+                return i;
+            }
+        }
+    }
+    return total;
+}
+
 const Sampler::AudioDeviceData &
 Sampler::getAudioInputDeviceData() const
 {
@@ -496,6 +599,12 @@ Sampler::getChannels() const
     return channels;
 }
 
+synthclone::SampleFrameCount
+Sampler::getLatency() const
+{
+    return latency.loadAcquire();
+}
+
 int
 Sampler::getMIDIDeviceCount() const
 {
@@ -515,6 +624,15 @@ Sampler::getMIDIDeviceName(int index) const
     return midiDevices[index].info->name;
 }
 
+synthclone::SampleFrameCount
+Sampler::getPortLatency() const
+{
+    // The start messages are delivered by PortMidi a fixed latency after the
+    // capture time of the frame that the latency is counted from.
+    return static_cast<synthclone::SampleFrameCount>
+        ((static_cast<double>(midiLatency) * sampleRate) / 1000.0);
+}
+
 synthclone::SampleRate
 Sampler::getSampleRate() const
 {
@@ -523,15 +641,16 @@ Sampler::getSampleRate() const
 
 int
 Sampler::handleProcessEvent(const float *input, float *output,
-                            unsigned long frames,
+                            unsigned long frames, PaTime time,
                             PaStreamCallbackFlags statusFlags)
 {
     bool genericCopy = true;
     const synthclone::SamplerJob *job;
-    synthclone::MIDIData midiChannel;
     synthclone::SampleFrameCount processedFrames;
     const synthclone::Zone *zone;
 
+    periodTime = time;
+
     if (statusFlags & paInputOverflow) {
         sendSimpleEvent(Event::TYPE_INPUT_OVERFLOW);
     }
@@ -545,6 +664,14 @@ Sampler::handleProcessEvent(const float *input, float *output,
         sendSimpleEvent(Event::TYPE_OUTPUT_UNDERFLOW);
     }
 
+    // Xruns are only counted while a job's audio is being captured.  The
+    // count is reported when the job completes.
+    if ((statusFlags & (paInputOverflow | paInputUnderflow |
+                        paOutputOverflow | paOutputUnderflow)) &&
+        isCapturing()) {
+        xruns.fetchAndAddOrdered(1);
+    }
+
     switch (state) {
 
     // Waiting for commands
@@ -557,6 +684,13 @@ Sampler::handleProcessEvent(const float *input, float *output,
                 aborted = false;
                 currentFrame = 0;
                 errorMessage = 0;
+                xruns.storeRelease(0);
+                if (command.sweepJobCount) {
+                    sweepJobIndex = 0;
+                    sweepPhase = SWEEPPHASE_START;
+                    state = STATE_SWEEP;
+                    goto sweep;
+                }
                 if (job->getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
                     state = STATE_SAMPLE_SEND_PRE_MIDI;
                     goto sampleSendPreMIDI;
@@ -601,41 +735,50 @@ Sampler::handleProcessEvent(const float *input, float *output,
         if (state == STATE_ERROR) {
             goto error;
         }
-        zone = command.job->getZone();
-
-        {
-            using synthclone::Zone;
-
-            const Zone::ControlMap &controlValues = zone->getControlMap();
-            Zone::ControlMap::const_iterator end = controlValues.end();
-            midiChannel = zone->getChannel() - 1;
-            for (Zone::ControlMap::const_iterator iter = controlValues.begin();
-                 iter != end; iter++) {
-                if (! sendMIDIMessage(0xb0 | midiChannel, iter.key(),
-                                      iter.value())) {
-                    goto error;
-                }
-            }
-            synthclone::MIDIData note = zone->getNote();
-            if (! sendMIDIMessage(0x90 | midiChannel, note,
-                                  zone->getVelocity())) {
-                goto error;
-            }
-            synthclone::MIDIData pressure = zone->getChannelPressure();
-            if (pressure != synthclone::MIDI_VALUE_NOT_SET) {
-                if (! sendMIDIMessage(0xb0 | midiChannel, pressure)) {
-                    goto error;
+        // The messages are timed from the first frame of the next period, which
+        // is where the latency is counted from.
+        if (! sendZoneStartMessages(command.job->getZone(), frames)) {
+            goto error;
+        }
+        captureOffset = 0;
+        state = STATE_SAMPLE_LATENCY;
+        break;
+
+    // Capture starts once the MIDI messages have reached the instrument and
+    // its audio has made it back to the input device.
+    case STATE_SAMPLE_LATENCY:
+        updateCommandState();
+        switch (state) {
+        case STATE_ABORT:
+            aborted = true;
+            // Fallthrough on purpose.
+        case STATE_ERROR:
+            goto sampleSendNoteOff;
+        default:
+            ;
+        }
+        if (command.measureLatency) {
+            captureOffset = findOnset(input, frames);
+            if (static_cast<unsigned long>(captureOffset) == frames) {
+                currentFrame += frames;
+                if (currentFrame >= command.latencyFrames) {
+                    setErrorState(ERROR_LATENCY_MEASUREMENT);
+                    goto sampleSendNoteOff;
                 }
+                break;
             }
-            synthclone::MIDIData aftertouch = zone->getAftertouch();
-            if (aftertouch != synthclone::MIDI_VALUE_NOT_SET) {
-                if (! sendMIDIMessage(0xa0 | midiChannel, note, aftertouch)) {
-                    goto error;
-                }
+            measuredLatency = currentFrame + captureOffset;
+        } else {
+            if (static_cast<unsigned long>(command.latencyFrames -
+                                           currentFrame) >= frames) {
+                currentFrame += frames;
+                break;
             }
+            captureOffset = command.latencyFrames - currentFrame;
         }
+        currentFrame = 0;
         state = STATE_SAMPLE;
-        break;
+        // Fallthrough on purpose.
 
     case STATE_SAMPLE:
         updateCommandState();
@@ -648,10 +791,24 @@ Sampler::handleProcessEvent(const float *input, float *output,
         default:
             ;
         }
+        processedFrames =
+            qMin(static_cast<synthclone::SampleFrameCount>(frames) -
+                 captureOffset, command.totalSampleFrames - currentFrame);
+        if (! recordData(input + (captureOffset *
+                                  audioInputDeviceChannelCount),
+                         output + (captureOffset *
+                                   audioOutputDeviceChannelCount),
+                         processedFrames)) {
+            setErrorState(ERROR_CAPTURE_OVERRUN);
+            goto sampleSendNoteOff;
+        }
+        diskThread.commit();
+        copyData(input, output, captureOffset, 0);
         genericCopy = false;
-        processedFrames = recordData(input, output, frames);
+        currentFrame += processedFrames;
+        processedFrames += captureOffset;
+        captureOffset = 0;
         if (static_cast<unsigned long>(processedFrames) >= frames) {
-            currentFrame += frames;
             sendProgressEvent(static_cast<float>(currentFrame) /
                               (command.totalSampleFrames +
                                command.totalReleaseFrames));
@@ -662,13 +819,12 @@ Sampler::handleProcessEvent(const float *input, float *output,
                           (command.totalSampleFrames +
                            command.totalReleaseFrames));
     sampleSendNoteOff:
-        zone = command.job->getZone();
-        if (! sendMIDIMessage(0x80 | (zone->getChannel() - 1), zone->getNote(),
-                              zone->getVelocity())) {
+        if (! sendZoneNoteOffMessage(command.job->getZone(), 0)) {
             state = STATE_ERROR;
             goto error;
         }
         currentFrame = 0;
+        silentFrames = 0;
         state = STATE_SAMPLE_RELEASE;
         break;
 
@@ -686,7 +842,12 @@ Sampler::handleProcessEvent(const float *input, float *output,
         default:
             ;
         }
-        currentFrame += frames;
+        if ((command.silenceThreshold > 0.0) &&
+            captureReleaseTail(input, output, frames)) {
+            currentFrame = command.totalReleaseFrames;
+        } else {
+            currentFrame += frames;
+        }
         if (currentFrame < command.totalReleaseFrames) {
             copyData(input, output, frames, 0);
             synthclone::SampleFrameCount totalSampleFrames =
@@ -700,13 +861,7 @@ Sampler::handleProcessEvent(const float *input, float *output,
         sendProgressEvent(1.0);
 
         // Send MIDI messages to turn sound off and reset controllers.
-        zone = command.job->getZone();
-        midiChannel = zone->getChannel() - 1;
-        if (! sendMIDIMessage(0xb0 | midiChannel, 0x78, 0)) {
-            state = STATE_ERROR;
-            goto error;
-        }
-        if (! sendMIDIMessage(0xb0 | midiChannel, 0x79, 0)) {
+        if (! sendZoneResetMessages(command.job->getZone(), 0)) {
             state = STATE_ERROR;
             goto error;
         }
@@ -744,6 +899,54 @@ Sampler::handleProcessEvent(const float *input, float *output,
             goto idle;
         }
         break;
+
+    // Execute 'sweep' command
+    case STATE_SWEEP:
+    sweep:
+        updateCommandState();
+        switch (state) {
+        case STATE_ABORT:
+            aborted = true;
+            // Fallthrough on purpose.
+        case STATE_ERROR:
+            goto sweepStop;
+        default:
+            ;
+        }
+        if (! processSweep(input, output, frames)) {
+            goto sweepStop;
+        }
+        genericCopy = false;
+        if ((sweepJobIndex < command.sweepJobCount) ||
+            (currentFrame < (command.latencyFrames +
+                             command.totalSampleFrames))) {
+            break;
+        }
+        state = STATE_COMPLETED;
+        goto completed;
+    sweepStop:
+
+        // Silence the zone that's sounding, if any.  If the MIDI buffer is
+        // full, there's nothing more that can be done.
+        if (sweepJobIndex < command.sweepJobCount) {
+            zone = command.sweepJobs[sweepJobIndex].zone;
+            switch (sweepPhase) {
+            case SWEEPPHASE_NOTE_OFF:
+                sendZoneNoteOffMessage(zone, 0);
+                // Fallthrough on purpose.
+            case SWEEPPHASE_RESET:
+                sendZoneResetMessages(zone, 0);
+                // Fallthrough on purpose.
+            default:
+                ;
+            }
+        }
+        if (errorMessage) {
+            state = STATE_ERROR;
+            goto error;
+        }
+        state = STATE_ABORT;
+        goto abort;
     }
     if (genericCopy) {
         copyData(input, output, frames, 0);
@@ -751,6 +954,19 @@ Sampler::handleProcessEvent(const float *input, float *output,
     return paContinue;
 }
 
+void
+Sampler::initializeHelperThread()
+{
+    try {
+        acquireRealtimePriority();
+    } catch (synthclone::Error &e) {
+        QString message = tr("Realtime scheduling is unavailable: %1").
+            arg(e.getMessage());
+        qWarning() << message;
+        emit statusChanged(message);
+    }
+}
+
 void
 Sampler::initializeOutputFrame(float *output,
                                synthclone::SampleFrameCount offset)
@@ -767,9 +983,37 @@ Sampler::isActive() const
     return active;
 }
 
+bool
+Sampler::isCapturing() const
+{
+    switch (state) {
+    case STATE_SAMPLE:
+    case STATE_SWEEP:
+        return true;
+    case STATE_SAMPLE_RELEASE:
+        return command.silenceThreshold > 0.0;
+    default:
+        ;
+    }
+    return false;
+}
+
+bool
+Sampler::isLatencyMeasured() const
+{
+    return static_cast<bool>(latencyMeasured.loadAcquire());
+}
+
+bool
+Sampler::isSweepSupported() const
+{
+    return true;
+}
+
 void
 Sampler::monitorEvents()
 {
+    initializeHelperThread();
     for (;;) {
         eventSemaphore.wait();
         if (! eventBuffer.isReadable()) {
@@ -778,35 +1022,51 @@ Sampler::monitorEvents()
         Command *command;
         Event event;
         const synthclone::SamplerJob *job;
+        QString message;
         eventBuffer.read(event);
         switch (event.type) {
         case Event::TYPE_ABORTED:
+            command = &(event.data.command);
+            if (command->job->getType() ==
+                synthclone::SamplerJob::TYPE_SAMPLE) {
+                diskThread.stop();
+            }
             idle = true;
             emit statusChanged(tr("Idle."));
             emit jobAborted();
-            emit progressChanged(0.0);
-            command = &(event.data.command);
+            reportProgress(0.0);
             break;
         case Event::TYPE_COMPLETE:
             command = &(event.data.command);
             job = command->job;
             if (job->getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
-                synthclone::SampleOutputStream *stream =
-                    qobject_cast<synthclone::SampleOutputStream *>
-                    (command->stream);
-                float *sampleBuffer = command->sampleBuffer;
-                stream->write(sampleBuffer, command->totalSampleFrames);
+                message = diskThread.finish();
+            }
+            if (message.isEmpty() && command->measureLatency) {
+                latency.storeRelease(measuredLatency);
+                latencyMeasured.storeRelease(1);
+                latencyMeasurementRequested.storeRelease(0);
+                emit latencyChanged();
             }
             idle = true;
             emit statusChanged(tr("Idle."));
-            emit jobCompleted();
-            emit progressChanged(0.0);
+            if (message.isEmpty()) {
+                emit jobXrunsCounted(xruns.fetchAndStoreOrdered(0));
+                emit jobCompleted();
+            } else {
+                emit jobError(message);
+            }
+            reportProgress(0.0);
             break;
         case Event::TYPE_ERROR:
+            command = &(event.data.error.command);
+            if (command->job->getType() ==
+                synthclone::SamplerJob::TYPE_SAMPLE) {
+                diskThread.stop();
+            }
             idle = true;
             emit statusChanged(tr("Idle."));
             emit jobError(event.data.error.message);
-            command = &(event.data.error.command);
             break;
         case Event::TYPE_INPUT_OVERFLOW:
             qWarning() << "PortMedia input overflow detected.";
@@ -821,7 +1081,7 @@ Sampler::monitorEvents()
             qWarning() << "PortMedia output underflow detected.";
             continue;
         case Event::TYPE_PROGRESS:
-            emit progressChanged(event.data.progress);
+            reportProgress(event.data.progress);
             continue;
         default:
             assert(false);
@@ -855,46 +1115,130 @@ Sampler::playData(const float *input, float *output, unsigned long totalFrames)
     return copyFrames;
 }
 
-synthclone::SampleFrameCount
+bool
+Sampler::processSweep(const float *input, float *output, unsigned long frames)
+{
+    assert(command.sweepJobs);
+
+    // The recording lags the MIDI events by the latency, so that each span of
+    // the recording starts when its zone's audio reaches the input device.
+    synthclone::SampleFrameCount endFrame = currentFrame + frames;
+    synthclone::SampleFrameCount latencyFrames = command.latencyFrames;
+    synthclone::SampleFrameCount totalFrames =
+        latencyFrames + command.totalSampleFrames;
+    synthclone::SampleFrameCount firstFrame =
+        qBound(currentFrame, latencyFrames, endFrame) - currentFrame;
+    synthclone::SampleFrameCount lastFrame =
+        qBound(currentFrame, totalFrames, endFrame) - currentFrame;
+    copyData(input, output, firstFrame, 0);
+    if (! recordData(input + (firstFrame * audioInputDeviceChannelCount),
+                     output + (firstFrame * audioOutputDeviceChannelCount),
+                     lastFrame - firstFrame)) {
+        setErrorState(ERROR_CAPTURE_OVERRUN);
+        return false;
+    }
+    diskThread.commit();
+    copyData(input, output, frames, lastFrame);
+
+    // Every event that falls within this period is timestamped with the
+    // capture time of its frame.
+    while (sweepJobIndex < command.sweepJobCount) {
+        const SweepJob &job = command.sweepJobs[sweepJobIndex];
+        if (sweepPhase == SWEEPPHASE_START) {
+            if (job.startFrame >= endFrame) {
+                break;
+            }
+            if (! sendZoneStartMessages(job.zone,
+                                        job.startFrame - currentFrame)) {
+                return false;
+            }
+            sweepPhase = SWEEPPHASE_NOTE_OFF;
+        }
+        if (sweepPhase == SWEEPPHASE_NOTE_OFF) {
+            if (job.noteOffFrame >= endFrame) {
+                break;
+            }
+            if (! sendZoneNoteOffMessage(job.zone,
+                                         job.noteOffFrame - currentFrame)) {
+                return false;
+            }
+            sweepPhase = SWEEPPHASE_RESET;
+        }
+        if (job.endFrame > endFrame) {
+            break;
+        }
+        if (! sendZoneResetMessages(job.zone, job.endFrame - currentFrame)) {
+            return false;
+        }
+        sweepJobIndex++;
+        sweepPhase = SWEEPPHASE_START;
+    }
+
+    sendProgressEvent(totalFrames ?
+                      static_cast<float>(currentFrame + lastFrame) /
+                      totalFrames : 1.0);
+    currentFrame = endFrame;
+    return true;
+}
+
+bool
 Sampler::recordData(const float *input, float *output,
-                    unsigned long totalFrames)
+                    synthclone::SampleFrameCount frames)
 {
-    synthclone::SampleFrameCount nextFrame = currentFrame + totalFrames;
-    float *sampleBuffer = command.sampleBuffer;
-    synthclone::SampleFrameCount totalSampleFrames = command.totalSampleFrames;
-    synthclone::SampleFrameCount copyFrames = nextFrame >= totalSampleFrames ?
-        totalSampleFrames - currentFrame : totalFrames;
-    for (synthclone::SampleFrameCount i = 0; i < copyFrames; i++) {
-        synthclone::SampleFrameCount inputOffset =
-            audioInputDeviceChannelCount * i;
-        synthclone::SampleFrameCount outputOffset =
-            audioOutputDeviceChannelCount * i;
-        synthclone::SampleFrameCount sampleOffset =
-            (currentFrame + i) * channels;
-        initializeOutputFrame(output, outputOffset);
+    RingBuffer<float> *buffer = diskThread.getBuffer();
+    size_t count = static_cast<size_t>(frames) * channels;
+    if (buffer->getWriteAvailable() < count) {
+        return false;
+    }
+    float *data1;
+    float *data2;
+    size_t size1;
+    size_t size2;
+    buffer->getWriteRegions(count, data1, size1, data2, size2);
+
+    // The write region may wrap around the end of the ring buffer in the
+    // middle of a frame, so the destination is tracked per sample.
+    float *sampleData = data1;
+    size_t remaining = size1;
+    for (synthclone::SampleFrameCount i = 0; i < frames; i++) {
+        initializeOutputFrame(output, 0);
         for (synthclone::SampleChannelCount j = 0; j < channels; j++) {
-            float n = input[inputOffset + audioInputChannelIndices[j]];
-            sampleBuffer[sampleOffset + j] = n;
-            output[outputOffset + audioOutputChannelIndices[j]] += n;
+            float n = input[audioInputChannelIndices[j]];
+            output[audioOutputChannelIndices[j]] += n;
+            *sampleData++ = n;
+            if (! --remaining) {
+                sampleData = data2;
+                remaining = size2;
+            }
         }
+        input += audioInputDeviceChannelCount;
+        output += audioOutputDeviceChannelCount;
     }
-    return copyFrames;
+    buffer->advanceWriteIndex(count);
+    return true;
 }
 
 void
-Sampler::runMIDI()
+Sampler::requestLatencyMeasurement()
 {
+    latencyMeasurementRequested.storeRelease(1);
+    emit statusChanged(tr("Latency will be measured during the next sampling "
+                          "job."));
+}
 
-    // XXX: Acquire realtime priority.
-
+void
+Sampler::runMIDI()
+{
+    initializeHelperThread();
     for (;;) {
         midiSemaphore.wait();
         if (! midiBuffer.isReadable()) {
             break;
         }
-        PmMessage message;
-        midiBuffer.read(message);
-        PmError pmError = Pm_WriteShort(midiStream, 0, message);
+        PmEvent event;
+        midiBuffer.read(event);
+        PmError pmError = Pm_WriteShort(midiStream, event.timestamp,
+                                        event.message);
         if (pmError != pmNoError) {
             QString s(Pm_GetErrorText(pmError));
             emit midiError(s);
@@ -945,7 +1289,8 @@ Sampler::sendJobFinalizationEvent(Event::Type type)
 }
 
 bool
-Sampler::sendMIDIMessage(synthclone::MIDIData status,
+Sampler::sendMIDIMessage(synthclone::SampleFrameCount time,
+                         synthclone::MIDIData status,
                          synthclone::MIDIData data1,
                          synthclone::MIDIData data2)
 {
@@ -954,14 +1299,17 @@ Sampler::sendMIDIMessage(synthclone::MIDIData status,
         return false;
     }
     assert(data1 < 0x80);
-    PmMessage message;
+    PmEvent event;
     if (data2 == synthclone::MIDI_VALUE_NOT_SET) {
-        message = Pm_Message(status, data1, 0);
+        event.message = Pm_Message(status, data1, 0);
     } else {
         assert(data2 < 0x80);
-        message = Pm_Message(status, data1, data2);
+        event.message = Pm_Message(status, data1, data2);
     }
-    bool sent = midiBuffer.write(message);
+    event.timestamp = static_cast<PmTimestamp>
+        (floor(((periodTime + (static_cast<double>(time) / sampleRate)) *
+                1000.0) + 0.5));
+    bool sent = midiBuffer.write(event);
     assert(sent);
     midiSemaphore.post();
     return true;
@@ -984,6 +1332,59 @@ Sampler::sendSimpleEvent(Event::Type type)
     return sendEvent(event);
 }
 
+bool
+Sampler::sendZoneNoteOffMessage(const synthclone::Zone *zone,
+                                synthclone::SampleFrameCount time)
+{
+    return sendMIDIMessage(time, 0x80 | (zone->getChannel() - 1),
+                           zone->getNote(), zone->getVelocity());
+}
+
+bool
+Sampler::sendZoneResetMessages(const synthclone::Zone *zone,
+                               synthclone::SampleFrameCount time)
+{
+    synthclone::MIDIData midiChannel = zone->getChannel() - 1;
+    return sendMIDIMessage(time, 0xb0 | midiChannel, 0x78, 0) &&
+        sendMIDIMessage(time, 0xb0 | midiChannel, 0x79, 0);
+}
+
+bool
+Sampler::sendZoneStartMessages(const synthclone::Zone *zone,
+                               synthclone::SampleFrameCount time)
+{
+    using synthclone::Zone;
+
+    const Zone::ControlMap &controlValues = zone->getControlMap();
+    Zone::ControlMap::const_iterator end = controlValues.end();
+    synthclone::MIDIData midiChannel = zone->getChannel() - 1;
+    for (Zone::ControlMap::const_iterator iter = controlValues.begin();
+         iter != end; iter++) {
+        if (! sendMIDIMessage(time, 0xb0 | midiChannel, iter.key(),
+                              iter.value())) {
+            return false;
+        }
+    }
+    synthclone::MIDIData note = zone->getNote();
+    if (! sendMIDIMessage(time, 0x90 | midiChannel, note,
+                          zone->getVelocity())) {
+        return false;
+    }
+    synthclone::MIDIData pressure = zone->getChannelPressure();
+    if (pressure != synthclone::MIDI_VALUE_NOT_SET) {
+        if (! sendMIDIMessage(time, 0xb0 | midiChannel, pressure)) {
+            return false;
+        }
+    }
+    synthclone::MIDIData aftertouch = zone->getAftertouch();
+    if (aftertouch != synthclone::MIDI_VALUE_NOT_SET) {
+        if (! sendMIDIMessage(time, 0xa0 | midiChannel, note, aftertouch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 Sampler::setAudioAPIIndex(int index)
 {
@@ -1141,6 +1542,13 @@ Sampler::setErrorState(const char *message)
     state = STATE_ERROR;
 }
 
+void
+Sampler::setLatency(synthclone::SampleFrameCount latency)
+{
+    this->latency.storeRelease(latency);
+    latencyMeasured.storeRelease(1);
+}
+
 void
 Sampler::setMIDIDeviceIndex(int index)
 {
@@ -1176,11 +1584,46 @@ Sampler::startJob(const synthclone::SamplerJob &job,
     synthclone::SampleFrameCount sampleFrames;
     synthclone::SampleRate sampleRate = stream.getSampleRate();
     const synthclone::Zone *zone = job.getZone();
+    command.latencyFrames = 0;
+    command.measureLatency = false;
+    command.onsetThreshold = 0.0;
+    command.silenceHoldFrames = getSilenceHoldTime() * sampleRate;
+    command.silenceThreshold = getSilenceThreshold();
     if (job.getType() == synthclone::SamplerJob::TYPE_SAMPLE) {
         synthclone::SampleFrameCount releaseFrames =
             zone->getReleaseTime() * sampleRate;
         sampleFrames = zone->getSampleTime() * sampleRate;
-        sampleBuffer = new float[channels * sampleFrames];
+
+        // A measurement waits for the note's onset.  Otherwise, the measured
+        // latency is skipped, or the input latency reported by PortAudio if
+        // there's no measurement.
+        command.measureLatency =
+            static_cast<bool>(latencyMeasurementRequested.loadAcquire());
+        if (command.measureLatency) {
+            command.latencyFrames = MAXIMUM_LATENCY_TIME * sampleRate;
+        } else {
+            command.latencyFrames = isLatencyMeasured() ? getLatency() :
+                getPortLatency();
+        }
+        float threshold = getSilenceThreshold();
+        command.onsetThreshold = (threshold > 0.0) ? threshold :
+            DEFAULT_ONSET_THRESHOLD;
+
+        // When silence detection is on, the release is captured as well, and
+        // the capture is truncated once the release falls silent.
+        synthclone::SampleFrameCount captureFrames = sampleFrames;
+        if (command.silenceThreshold > 0.0) {
+            captureFrames += releaseFrames;
+        }
+        synthclone::SampleFrameCount bufferFrames =
+            qMax(static_cast<synthclone::SampleFrameCount>(1),
+                 qMin(captureFrames,
+                      static_cast<synthclone::SampleFrameCount>
+                      (sampleRate * CAPTURE_BUFFER_SECONDS)));
+        diskThread.startCapture
+            (qobject_cast<synthclone::SampleOutputStream *>(&stream),
+             channels, captureFrames, bufferFrames);
+        sampleBuffer = 0;
         emit statusChanged(tr("Sampling ..."));
         command.totalReleaseFrames = releaseFrames;
     } else {
@@ -1196,11 +1639,69 @@ Sampler::startJob(const synthclone::SamplerJob &job,
     command.job = &job;
     command.sampleBuffer = sampleBuffer;
     command.stream = &stream;
+    command.sweepJobCount = 0;
+    command.sweepJobs = 0;
     command.totalSampleFrames = sampleFrames;
     idle = false;
     sendCommand(command);
 }
 
+void
+Sampler::startSweep(const QList<const synthclone::SamplerJob *> &jobs,
+                    synthclone::SampleStream &stream)
+{
+    assert(idle);
+    assert(! jobs.isEmpty());
+    assert(stream.getChannels() == channels);
+    assert(stream.getSampleRate() == sampleRate);
+    int count = jobs.count();
+    sweepJobs.resize(count);
+    synthclone::SampleFrameCount totalFrames = 0;
+    for (int i = 0; i < count; i++) {
+        const synthclone::Zone *zone = jobs[i]->getZone();
+        SweepJob &job = sweepJobs[i];
+        job.zone = zone;
+        job.startFrame = totalFrames;
+        job.noteOffFrame = totalFrames + static_cast<synthclone::SampleFrameCount>
+            (zone->getSampleTime() * sampleRate);
+        job.endFrame = job.noteOffFrame +
+            static_cast<synthclone::SampleFrameCount>
+            (zone->getReleaseTime() * sampleRate);
+        totalFrames = job.endFrame;
+    }
+
+    // The recording starts after the measured latency, or the input latency
+    // reported by PortAudio if there's no measurement.  A pending measurement
+    // waits for the next single sampling job.
+    synthclone::SampleFrameCount latencyFrames =
+        isLatencyMeasured() ? getLatency() : getPortLatency();
+    synthclone::SampleFrameCount bufferFrames =
+        qMax(static_cast<synthclone::SampleFrameCount>(1),
+             qMin(totalFrames,
+                  static_cast<synthclone::SampleFrameCount>
+                  (sampleRate * CAPTURE_BUFFER_SECONDS)));
+    diskThread.startCapture
+        (qobject_cast<synthclone::SampleOutputStream *>(&stream), channels,
+         totalFrames, bufferFrames);
+    emit statusChanged(tr("Sampling %1 zones ...").arg(count));
+
+    Command command;
+    command.job = jobs[0];
+    command.latencyFrames = latencyFrames;
+    command.measureLatency = false;
+    command.onsetThreshold = 0.0;
+    command.sampleBuffer = 0;
+    command.silenceHoldFrames = 0;
+    command.silenceThreshold = 0.0;
+    command.stream = &stream;
+    command.sweepJobCount = count;
+    command.sweepJobs = sweepJobs.constData();
+    command.totalReleaseFrames = 0;
+    command.totalSampleFrames = totalFrames;
+    idle = false;
+    sendCommand(command);
+}
+
 void
 Sampler::updateCommandState()
 {
@@ -23,11 +23,14 @@
 #include <portaudio.h>
 #include <portmidi.h>
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QList>
+#include <QtCore/QVector>
 
 #include <synthclone/sampler.h>
 #include <synthclone/semaphore.h>
 
+#include "diskthread.h"
 #include "eventthread.h"
 #include "midithread.h"
 #include "ringbuffer.h"
@@ -104,6 +107,9 @@ public:
     synthclone::SampleChannelCount
     getChannels() const;
 
+    synthclone::SampleFrameCount
+    getLatency() const;
+
     int
     getMIDIDeviceCount() const;
 
@@ -119,8 +125,17 @@ public:
     bool
     isActive() const;
 
+    bool
+    isLatencyMeasured() const;
+
+    bool
+    isSweepSupported() const;
+
 public slots:
 
+    void
+    requestLatencyMeasurement();
+
     void
     setAudioAPIIndex(int index);
 
@@ -141,6 +156,9 @@ public slots:
     void
     setChannels(synthclone::SampleChannelCount channels);
 
+    void
+    setLatency(synthclone::SampleFrameCount latency);
+
     void
     setMIDIDeviceIndex(int index);
 
@@ -151,6 +169,10 @@ public slots:
     startJob(const synthclone::SamplerJob &job,
              synthclone::SampleStream &stream);
 
+    void
+    startSweep(const QList<const synthclone::SamplerJob *> &jobs,
+               synthclone::SampleStream &stream);
+
 signals:
 
     void
@@ -185,6 +207,9 @@ signals:
     void
     channelsChanged(synthclone::SampleChannelCount channels);
 
+    void
+    latencyChanged();
+
     void
     midiDeviceIndexChanged(int index);
 
@@ -221,10 +246,24 @@ private:
 
     typedef QList<MIDIDeviceData> MIDIDeviceDataList;
 
+    struct SweepJob {
+        synthclone::SampleFrameCount endFrame;
+        synthclone::SampleFrameCount noteOffFrame;
+        synthclone::SampleFrameCount startFrame;
+        const synthclone::Zone *zone;
+    };
+
     struct Command {
         const synthclone::SamplerJob *job;
+        synthclone::SampleFrameCount latencyFrames;
+        bool measureLatency;
+        float onsetThreshold;
         float *sampleBuffer;
+        synthclone::SampleFrameCount silenceHoldFrames;
+        float silenceThreshold;
         synthclone::SampleStream *stream;
+        int sweepJobCount;
+        const SweepJob *sweepJobs;
         synthclone::SampleFrameCount totalReleaseFrames;
         synthclone::SampleFrameCount totalSampleFrames;
     };
@@ -261,12 +300,23 @@ private:
         STATE_IDLE,
         STATE_PLAY,
         STATE_SAMPLE,
+        STATE_SAMPLE_LATENCY,
         STATE_SAMPLE_SEND_PRE_MIDI,
-        STATE_SAMPLE_RELEASE
+        STATE_SAMPLE_RELEASE,
+        STATE_SWEEP
+    };
+
+    enum SweepPhase {
+        SWEEPPHASE_NOTE_OFF,
+        SWEEPPHASE_RESET,
+        SWEEPPHASE_START
     };
 
     // Static wrappers
 
+    static PmTimestamp
+    getMIDITime(void *userData);
+
     static int
     handleProcessEvent(const void *input, void *output, unsigned long frames,
                        const PaStreamCallbackTimeInfo *timeInfo,
@@ -274,10 +324,17 @@ private:
 
     // Members
 
+    bool
+    captureReleaseTail(const float *input, float *output,
+                       unsigned long frames);
+
     void
     copyData(const float *input, float *output, unsigned long totalFrames,
              unsigned long startFrame=0);
 
+    synthclone::SampleFrameCount
+    findOnset(const float *input, unsigned long frames) const;
+
     const AudioDeviceData &
     getAudioInputDeviceData() const;
 
@@ -290,21 +347,34 @@ private:
     const AudioDeviceData &
     getAudioOutputDeviceData(int index) const;
 
+    synthclone::SampleFrameCount
+    getPortLatency() const;
+
     int
     handleProcessEvent(const float *input, float *output, unsigned long frames,
-                       PaStreamCallbackFlags statusFlags);
+                       PaTime time, PaStreamCallbackFlags statusFlags);
+
+    void
+    initializeHelperThread();
 
     void
     initializeOutputFrame(float *output, synthclone::SampleFrameCount offset);
 
+    bool
+    isCapturing() const;
+
     void
     monitorEvents();
 
     synthclone::SampleFrameCount
     playData(const float *input, float *output, unsigned long totalFrames);
 
-    synthclone::SampleFrameCount
-    recordData(const float *input, float *output, unsigned long totalFrames);
+    bool
+    processSweep(const float *input, float *output, unsigned long frames);
+
+    bool
+    recordData(const float *input, float *output,
+               synthclone::SampleFrameCount frames);
 
     void
     runMIDI();
@@ -322,7 +392,8 @@ private:
     sendJobFinalizationEvent(Event::Type type);
 
     bool
-    sendMIDIMessage(synthclone::MIDIData status, synthclone::MIDIData data1,
+    sendMIDIMessage(synthclone::SampleFrameCount time,
+                    synthclone::MIDIData status, synthclone::MIDIData data1,
                     synthclone::MIDIData data2=synthclone::MIDI_VALUE_NOT_SET);
 
     void
@@ -331,6 +402,18 @@ private:
     bool
     sendSimpleEvent(Event::Type type);
 
+    bool
+    sendZoneNoteOffMessage(const synthclone::Zone *zone,
+                           synthclone::SampleFrameCount time);
+
+    bool
+    sendZoneResetMessages(const synthclone::Zone *zone,
+                          synthclone::SampleFrameCount time);
+
+    bool
+    sendZoneStartMessages(const synthclone::Zone *zone,
+                          synthclone::SampleFrameCount time);
+
     void
     setErrorState(const char *message);
 
@@ -348,24 +431,39 @@ private:
     synthclone::SampleChannelCount audioOutputDeviceChannelCount;
     int audioOutputDeviceIndex;
     PaStream *audioStream;
+    synthclone::SampleFrameCount captureOffset;
     synthclone::SampleChannelCount channels;
     Command command;
     RingBuffer<Command> commandBuffer;
     synthclone::SampleFrameCount currentFrame;
+    DiskThread diskThread;
     const char *errorMessage;
     RingBuffer<Event> eventBuffer;
     synthclone::Semaphore eventSemaphore;
     EventThread eventThread;
     bool idle;
-    RingBuffer<PmMessage> midiBuffer;
+    // The latency state is read by the main thread and updated by the event
+    // thread when a measurement completes.
+    QAtomicInteger<synthclone::SampleFrameCount> latency;
+    QAtomicInt latencyMeasured;
+    QAtomicInt latencyMeasurementRequested;
+    synthclone::SampleFrameCount measuredLatency;
+    RingBuffer<PmEvent> midiBuffer;
     MIDIDeviceDataList midiDevices;
     int midiDeviceIndex;
+    PmTimestamp midiLatency;
     synthclone::Semaphore midiSemaphore;
     PortMidiStream *midiStream;
     MIDIThread midiThread;
+    PaTime periodTime;
     int progress;
     synthclone::SampleRate sampleRate;
+    synthclone::SampleFrameCount silentFrames;
     State state;
+    int sweepJobIndex;
+    QVector<SweepJob> sweepJobs;
+    SweepPhase sweepPhase;
+    QAtomicInt xruns;
 
 };
 
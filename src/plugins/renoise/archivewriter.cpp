@@ -20,8 +20,8 @@
 #include <cassert>
 #include <cerrno>
 
+#include <QtCore/QBuffer>
 #include <QtCore/QFileInfo>
-#include <QtCore/QTemporaryFile>
 
 #include <synthclone/error.h>
 
@@ -78,22 +78,18 @@ ArchiveWriter::~ArchiveWriter()
 void
 ArchiveWriter::addConfiguration(const QString &configuration)
 {
-    QTemporaryFile tempFile;
-    if (! tempFile.open()) {
-        throw synthclone::Error(tr("failed to open temporary file: %1").
-                                arg(tempFile.errorString()));
-    }
-    tempFile.write(configuration.toLocal8Bit());
-    tempFile.close();
-
-    addFile(tempFile.fileName(), "Instrument.xml", ZIP_CM_STORE);
-    //addFile(tempFile.fileName(), "Instrument.xml", ZIP_CM_DEFLATE);
+    QBuffer *buffer = new QBuffer();
+    buffer->setData(configuration.toLocal8Bit());
+    addDevice(buffer, "Instrument.xml", ZIP_CM_STORE);
+    //addDevice(buffer, "Instrument.xml", ZIP_CM_DEFLATE);
 }
 
 void
-ArchiveWriter::addFile(const QString &path, const QString &entry,
-                       zip_uint16_t compressionMethod)
+ArchiveWriter::addDevice(QIODevice *device, const QString &entry,
+                         zip_uint16_t compressionMethod)
 {
+    QScopedPointer<QIODevice> devicePtr(device);
+
     // Open the archive.
     QByteArray pathBytes = this->path.toLocal8Bit();
     int error;
@@ -114,15 +110,14 @@ ArchiveWriter::addFile(const QString &path, const QString &entry,
                                 arg(zip_strerror(archive)));
     }
     sourceCompressionMethod = compressionMethod;
-    sourceFile = new QFile(path);
-    QScopedPointer<QFile> sourceFilePtr(sourceFile);
+    sourceDevice = device;
 
     // Add the source.
     QByteArray entryBytes = entry.toLocal8Bit();
     zip_int64_t result = zip_add(archive, entryBytes.constData(), source);
     if (result == -1) {
         zip_source_free(source);
-        sourceFile = 0;
+        sourceDevice = 0;
         throw synthclone::Error(tr("zip_add(): %1").arg(zip_strerror(archive)));
     }
 
@@ -140,7 +135,7 @@ ArchiveWriter::addSample(const QString &name, const synthclone::Sample &sample)
         n = "0" + n;
     }
     QString entry = QString("SampleData/Sample%1 (%2).flac").arg(n).arg(name);
-    addFile(sample.getPath(), entry, ZIP_CM_STORE);
+    addDevice(sample.createDataDevice(), entry, ZIP_CM_STORE);
 }
 
 zip_int64_t
@@ -152,7 +147,7 @@ ArchiveWriter::handleSourceCommand(void *data, zip_uint64_t length,
     struct zip_stat *statData;
     switch (command) {
     case ZIP_SOURCE_CLOSE:
-        sourceFile->close();
+        sourceDevice->close();
         break;
 
     case ZIP_SOURCE_ERROR:
@@ -168,7 +163,7 @@ ArchiveWriter::handleSourceCommand(void *data, zip_uint64_t length,
         break;
 
     case ZIP_SOURCE_OPEN:
-        if (! sourceFile->open(QIODevice::ReadOnly)) {
+        if (! sourceDevice->open(QIODevice::ReadOnly)) {
             sourceZipError = ZIP_ER_OPEN;
             sourceSystemError = errno;
             return -1;
@@ -176,7 +171,7 @@ ArchiveWriter::handleSourceCommand(void *data, zip_uint64_t length,
         break;
 
     case ZIP_SOURCE_READ:
-        readResult = sourceFile->read(static_cast<char *>(data), length);
+        readResult = sourceDevice->read(static_cast<char *>(data), length);
         if (readResult == -1) {
             sourceZipError = ZIP_ER_READ;
             sourceSystemError = errno;
@@ -187,7 +182,7 @@ ArchiveWriter::handleSourceCommand(void *data, zip_uint64_t length,
         statData = static_cast<struct zip_stat *>(data);
         zip_stat_init(statData);
         statData->comp_method = sourceCompressionMethod;
-        statData->size = QFileInfo(*sourceFile).size();
+        statData->size = sourceDevice->size();
         statData->valid |= ZIP_STAT_COMP_METHOD | ZIP_STAT_SIZE;
         return sizeof(struct zip_stat);
 
@@ -22,7 +22,7 @@
 
 #include <zip.h>
 
-#include <QtCore/QFile>
+#include <QtCore/QIODevice>
 
 #include <synthclone/sample.h>
 
@@ -46,8 +46,8 @@ public:
 private:
 
     void
-    addFile(const QString &path, const QString &entry,
-            zip_uint16_t compressionMethod);
+    addDevice(QIODevice *device, const QString &entry,
+              zip_uint16_t compressionMethod);
 
     static zip_int64_t
     handleSourceCommand(void *writer, void *data, zip_uint64_t length,
@@ -61,7 +61,7 @@ private:
     QString instrumentName;
     QString path;
     zip_uint16_t sourceCompressionMethod;
-    QFile *sourceFile;
+    QIODevice *sourceDevice;
     int sourceSystemError;
     int sourceZipError;
 
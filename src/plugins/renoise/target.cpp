@@ -45,7 +45,7 @@ Target::~Target()
 void
 Target::build(const QList<synthclone::Zone *> &zones)
 {
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     QString message;
     if (path.isEmpty()) {
         message = tr("the build path is not set");
@@ -109,7 +109,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
     QMultiMap<ZoneKey, synthclone::Zone *> zoneMap;
     confWriter.writeStartElement("Samples");
     for (int i = 0; i < zoneCount; i++) {
-        emit progressChanged((static_cast<float>(i) / zoneCount) * 0.5);
+        reportProgress((static_cast<float>(i) / zoneCount) * 0.5);
         synthclone::Zone *zone = zones[i];
 
         const synthclone::Sample *sample = zone->getWetSample();
@@ -161,7 +161,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
         zoneMap.insert(ZoneKey(*zone), zone);
     }
     confWriter.writeEndElement();
-    emit progressChanged(0.5);
+    reportProgress(0.5);
 
     QList<ZoneKey> keys = zoneMap.uniqueKeys();
     int keyCount = keys.count();
@@ -188,7 +188,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
             0.5;
         float difference = endProgress - startProgress;
 
-        emit progressChanged(startProgress);
+        reportProgress(startProgress);
         emit statusChanged(tr("Writing note %1 of %2 ...").
                            arg(locale.toString(i + 1),
                                locale.toString(keyCount)));
@@ -211,8 +211,8 @@ Target::build(const QList<synthclone::Zone *> &zones)
         synthclone::Zone *currentZone;
         synthclone::MIDIData lowVelocity = 0;
         for (int j = 0; j < layerCount - 1; j++) {
-            emit progressChanged(((static_cast<float>(j) / layerCount) *
-                                  difference) + startProgress);
+            reportProgress(((static_cast<float>(j) / layerCount) *
+                            difference) + startProgress);
             emit statusChanged(tr("Writing layer %1 of %2 for note %3 of %4 "
                                   "...").
                                arg(locale.toString(j + 1),
@@ -245,8 +245,8 @@ Target::build(const QList<synthclone::Zone *> &zones)
             lowVelocity = highVelocity;
         }
 
-        emit progressChanged(((static_cast<float>(layerCount - 1) /
-                               layerCount) * difference) + startProgress);
+        reportProgress(((static_cast<float>(layerCount - 1) /
+                         layerCount) * difference) + startProgress);
         emit statusChanged(tr("Writing layer %1 of %2 for note %3 of %4 ...").
                            arg(locale.toString(layerCount),
                                locale.toString(layerCount),
@@ -291,7 +291,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
 
     archiveWriter.addConfiguration(configuration);
 
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     emit statusChanged("Idle.");
 }
 
@@ -409,7 +409,7 @@ Target::writeSample(ArchiveWriter &archiveWriter, QXmlStreamWriter &confWriter,
     }
 
     synthclone::MIDIData note = zone->getNote();
-    synthclone::Sample outSample;
+    synthclone::Sample outSample(synthclone::Sample::STORAGE_MEMORY);
     synthclone::SampleInputStream inputStream(*sample);
     synthclone::SampleChannelCount channels = inputStream.getChannels();
     synthclone::SampleOutputStream outputStream
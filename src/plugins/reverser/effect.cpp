@@ -18,14 +18,17 @@
  * Ave, Cambridge, MA 02139, USA.
  */
 
-#include <cassert>
-
-#include <QtCore/QScopedArrayPointer>
+#include <algorithm>
 
 #include "effect.h"
 
+// Upper bound on the memory used to buffer audio data while reversing.  Samples
+// that fit are reversed with a single read; larger samples are read backwards
+// in blocks of this size.
+const qint64 MAXIMUM_BLOCK_BYTES = 32 * 1024 * 1024;
+
 Effect::Effect(const QString &name, QObject *parent):
-    synthclone::Effect(name, parent)
+    synthclone::BlockEffect(name, parent)
 {
     // Empty
 }
@@ -35,24 +38,42 @@ Effect::~Effect()
     // Empty
 }
 
+Effect::Direction
+Effect::getDirection() const
+{
+    return DIRECTION_BACKWARD;
+}
+
 void
-Effect::process(const synthclone::Zone &/*zone*/,
-                synthclone::SampleInputStream &inputStream,
-                synthclone::SampleOutputStream &outputStream)
+Effect::prepareBlocks(const synthclone::Zone &/*zone*/,
+                      synthclone::SampleInputStream &inputStream,
+                      synthclone::SampleFrameCount &/*startFrame*/,
+                      synthclone::SampleFrameCount &frames)
 {
-    QScopedArrayPointer<float> dataPtr(new float[inputStream.getChannels()]);
-    float *data = dataPtr.data();
-    synthclone::SampleFrameCount totalFrames = inputStream.getFrames();
-    emit progressChanged(0.0);
+    qint64 frameBytes = static_cast<qint64>(inputStream.getChannels()) *
+        static_cast<qint64>(sizeof(float));
+    synthclone::SampleFrameCount maximumBlockSize =
+        static_cast<synthclone::SampleFrameCount>(MAXIMUM_BLOCK_BYTES /
+                                                  frameBytes);
+    setBlockSize(qMax(static_cast<synthclone::SampleFrameCount>(1),
+                      qMin(frames, maximumBlockSize)));
     emit statusChanged(tr("Reversing sample ..."));
-    for (synthclone::SampleFrameCount i = totalFrames - 1; i >= 0; i--) {
-        inputStream.seek(i, synthclone::SampleStream::OFFSET_START);
-        synthclone::SampleFrameCount n = inputStream.read(data, 1);
-        assert(n == 1);
-        outputStream.write(data, 1);
-        emit progressChanged(static_cast<float>(totalFrames - i) /
-                             static_cast<float>(totalFrames));
+}
+
+void
+Effect::processBlock(float *data, synthclone::SampleFrameCount /*offset*/,
+                     synthclone::SampleFrameCount frames,
+                     synthclone::SampleChannelCount channels)
+{
+    // Blocks are read from the end of the sample; reversing the frames in
+    // each block completes the reversal.
+    if (channels == 1) {
+        std::reverse(data, data + frames);
+        return;
+    }
+    float *front = data;
+    float *back = data + ((frames - 1) * channels);
+    for (; front < back; front += channels, back -= channels) {
+        std::swap_ranges(front, front + channels, back);
     }
-    emit progressChanged(0.0);
-    emit statusChanged("");
 }
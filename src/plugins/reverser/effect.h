@@ -21,9 +21,9 @@
 #ifndef __EFFECT_H__
 #define __EFFECT_H__
 
-#include <synthclone/effect.h>
+#include <synthclone/blockeffect.h>
 
-class Effect: public synthclone::Effect {
+class Effect: public synthclone::BlockEffect {
 
     Q_OBJECT
 
@@ -34,10 +34,21 @@ public:
 
     ~Effect();
 
+protected:
+
+    Direction
+    getDirection() const;
+
+    void
+    prepareBlocks(const synthclone::Zone &zone,
+                  synthclone::SampleInputStream &inputStream,
+                  synthclone::SampleFrameCount &startFrame,
+                  synthclone::SampleFrameCount &frames);
+
     void
-    process(const synthclone::Zone &zone,
-            synthclone::SampleInputStream &inputStream,
-            synthclone::SampleOutputStream &outputStream);
+    processBlock(float *data, synthclone::SampleFrameCount offset,
+                 synthclone::SampleFrameCount frames,
+                 synthclone::SampleChannelCount channels);
 
 };
 
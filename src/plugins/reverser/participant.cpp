@@ -58,6 +58,14 @@ Participant::addEffect()
     return effect;
 }
 
+synthclone::Effect *
+Participant::cloneEffect(const QVariant &state) const
+{
+    Effect *effect = new Effect(tr("Reverser"));
+    restoreEffectState(effect, state);
+    return effect;
+}
+
 void
 Participant::deactivate(synthclone::Context &context)
 {
@@ -85,7 +93,12 @@ Participant::handleUnregistration(QObject *obj)
 void
 Participant::restoreEffect(const QVariant &state)
 {
-    Effect *effect = addEffect();
+    restoreEffectState(addEffect(), state);
+}
+
+void
+Participant::restoreEffectState(Effect *effect, const QVariant &state) const
+{
     const QVariantMap map = state.toMap();
     effect->setName(map.value("name", tr("Reverser")).toString());
 }
@@ -86,6 +86,7 @@ Participant::handleSampleSelection(const QStringList &paths)
         context->getZoneIndex(context->getSelectedZone(0)) :
         context->getZoneCount();
 
+    context->beginZoneBatch();
     for (int i = 0; i < count; i++) {
         QString path = paths[i];
         try {
@@ -141,6 +142,7 @@ Participant::handleSampleSelection(const QStringList &paths)
         insertIndex++;
 
     }
+    context->endZoneBatch();
 
     // Report any errors that occurred during the operation.
     if (errors.count()) {
@@ -123,7 +123,7 @@ Target::addControlLayer(synthclone::MIDIData control)
 void
 Target::build(const QList<synthclone::Zone *> &zones)
 {
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     QString message;
     if (path.isEmpty()) {
         message = tr("the build path is not set");
@@ -172,7 +172,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
     // }
 
     for (int i = 0; i < zoneCount; i++) {
-        emit progressChanged((static_cast<float>(i) / zoneCount) * 0.5);
+        reportProgress((static_cast<float>(i) / zoneCount) * 0.5);
         synthclone::Zone *zone = zones[i];
         const synthclone::Sample *sample = zone->getWetSample();
         if (! sample) {
@@ -204,7 +204,7 @@ Target::build(const QList<synthclone::Zone *> &zones)
         }
         zoneList->append(zone);
     }
-    emit progressChanged(0.5);
+    reportProgress(0.5);
 
     synthclone::SampleStream::Type sampleStreamType;
     synthclone::SampleStream::SubType sampleStreamSubType;
@@ -458,13 +458,13 @@ Target::build(const QList<synthclone::Zone *> &zones)
                 }
 
                 zonesWritten += zoneList->count();
-                emit progressChanged(((static_cast<float>(zonesWritten) /
-                                       zoneCount) * 0.5) + 0.5);
+                reportProgress(((static_cast<float>(zonesWritten) /
+                                 zoneCount) * 0.5) + 0.5);
             }
         }
     }
     file.close();
-    emit progressChanged(0.0);
+    reportProgress(0.0);
     emit statusChanged("Idle.");
 }
 
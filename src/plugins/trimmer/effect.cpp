@@ -18,17 +18,19 @@
  */
 
 #include <cassert>
-#include <cfloat>
 #include <cmath>
 
 #include <QtCore/QScopedArrayPointer>
 
-#include <synthclone/samplecopier.h>
-
 #include "effect.h"
 
+// Samples are compared against the threshold in chunks of this size so that
+// the comparison loop can be vectorized.  Only a chunk that contains an audible
+// sample is searched sample by sample.
+const qint64 SCAN_CHUNK_SIZE = 64;
+
 Effect::Effect(const QString &name, QObject *parent):
-    synthclone::Effect(name, parent)
+    synthclone::BlockEffect(name, parent)
 {
     sampleFloor = -70.0;
     trimEnd = true;
@@ -40,10 +42,49 @@ Effect::~Effect()
     // Empty
 }
 
-float
-Effect::getDBFS(float sample) const
+qint64
+Effect::findFirstAudibleSample(const float *data, qint64 count,
+                               float threshold) const
 {
-    return (sample == 0.0) ? -FLT_MAX : 20.0 * std::log10(std::fabs(sample));
+    for (qint64 chunkStart = 0; chunkStart < count;
+         chunkStart += SCAN_CHUNK_SIZE) {
+        qint64 chunkEnd = qMin(count, chunkStart + SCAN_CHUNK_SIZE);
+        int audible = 0;
+        for (qint64 i = chunkStart; i < chunkEnd; i++) {
+            audible += std::fabs(data[i]) >= threshold;
+        }
+        if (audible) {
+            for (qint64 i = chunkStart; i < chunkEnd; i++) {
+                if (std::fabs(data[i]) >= threshold) {
+                    return i;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+qint64
+Effect::findLastAudibleSample(const float *data, qint64 count,
+                              float threshold) const
+{
+    for (qint64 chunkEnd = count; chunkEnd > 0;
+         chunkEnd -= SCAN_CHUNK_SIZE) {
+        qint64 chunkStart = qMax(static_cast<qint64>(0),
+                                 chunkEnd - SCAN_CHUNK_SIZE);
+        int audible = 0;
+        for (qint64 i = chunkStart; i < chunkEnd; i++) {
+            audible += std::fabs(data[i]) >= threshold;
+        }
+        if (audible) {
+            for (qint64 i = chunkEnd - 1; i >= chunkStart; i--) {
+                if (std::fabs(data[i]) >= threshold) {
+                    return i;
+                }
+            }
+        }
+    }
+    return -1;
 }
 
 float
@@ -65,65 +106,61 @@ Effect::getTrimStart() const
 }
 
 void
-Effect::handleCopyProgress(synthclone::SampleFrameCount current,
-                           synthclone::SampleFrameCount total)
-{
-    emit progressChanged(static_cast<float>(current) / total);
-}
-
-void
-Effect::process(const synthclone::Zone &/*zone*/,
-                synthclone::SampleInputStream &inputStream,
-                synthclone::SampleOutputStream &outputStream)
+Effect::prepareBlocks(const synthclone::Zone &/*zone*/,
+                      synthclone::SampleInputStream &inputStream,
+                      synthclone::SampleFrameCount &startFrame,
+                      synthclone::SampleFrameCount &frames)
 {
     synthclone::SampleChannelCount channels = inputStream.getChannels();
-    QScopedArrayPointer<float> audioDataPtr(new float[channels]);
+    synthclone::SampleFrameCount blockSize = getBlockSize();
+    QScopedArrayPointer<float> audioDataPtr(new float[blockSize * channels]);
     float *audioData = audioDataPtr.data();
-    synthclone::SampleFrameCount frames = inputStream.getFrames();
+    float threshold = std::pow(10.0, sampleFloor / 20.0);
+    synthclone::SampleFrameCount blockFrames;
+    synthclone::SampleFrameCount blockStart;
     synthclone::SampleFrameCount framesRead;
+    qint64 index;
+
+    // The last frame is never checked when trimming the start, so that at
+    // least one frame is left for the end scan.
     synthclone::SampleFrameCount end = frames - 1;
     synthclone::SampleFrameCount start = 0;
     if (trimStart) {
         emit statusChanged(tr("Trimming start of sample ..."));
-        for (; start < end; start++) {
-            framesRead = inputStream.read(audioData, 1);
-            assert(framesRead == 1);
-            for (int i = 0; i < channels; i++) {
-                if (getDBFS(audioData[i]) >= sampleFloor) {
-                    goto findEnd;
-                }
+        inputStream.seek(0, synthclone::SampleStream::OFFSET_START);
+        for (; start < end; start += blockFrames) {
+            blockFrames = qMin(blockSize, end - start);
+            framesRead = inputStream.read(audioData, blockFrames);
+            assert(framesRead == blockFrames);
+            index = findFirstAudibleSample(audioData, blockFrames * channels,
+                                           threshold);
+            if (index != -1) {
+                start += index / channels;
+                break;
             }
         }
     }
- findEnd:
     if (trimEnd) {
         emit statusChanged(tr("Trimming end of sample ..."));
-        for (; end >= start; end--) {
-            inputStream.seek(end, synthclone::SampleStream::OFFSET_START);
-            framesRead = inputStream.read(audioData, 1);
-            assert(framesRead == 1);
-            for (int i = 0; i < channels; i++) {
-                if (getDBFS(audioData[i]) >= sampleFloor) {
-                    goto writeSample;
-                }
+        for (; end >= start; end -= blockFrames) {
+            blockStart = qMax(start, (end - blockSize) + 1);
+            blockFrames = (end - blockStart) + 1;
+            inputStream.seek(blockStart,
+                             synthclone::SampleStream::OFFSET_START);
+            framesRead = inputStream.read(audioData, blockFrames);
+            assert(framesRead == blockFrames);
+            index = findLastAudibleSample(audioData, blockFrames * channels,
+                                          threshold);
+            if (index != -1) {
+                end = blockStart + (index / channels);
+                break;
             }
         }
     }
- writeSample:
-    inputStream.seek(start, synthclone::SampleStream::OFFSET_START);
-    synthclone::SampleFrameCount newFrameCount = (end - start) + 1;
-    emit progressChanged(0.0);
+    startFrame = start;
+    frames = (end - start) + 1;
+    reportProgress(0.0);
     emit statusChanged(tr("Writing sample ..."));
-    synthclone::SampleCopier copier;
-    connect(&copier,
-            SIGNAL(copyProgress(synthclone::SampleFrameCount,
-                                synthclone::SampleFrameCount)),
-            SLOT(handleCopyProgress(synthclone::SampleFrameCount,
-                                    synthclone::SampleFrameCount)),
-            Qt::DirectConnection);
-    copier.copy(inputStream, outputStream, newFrameCount);
-    emit progressChanged(0.0);
-    emit statusChanged("");
 }
 
 void
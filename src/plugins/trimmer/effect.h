@@ -20,9 +20,9 @@
 #ifndef __EFFECT_H__
 #define __EFFECT_H__
 
-#include <synthclone/effect.h>
+#include <synthclone/blockeffect.h>
 
-class Effect: public synthclone::Effect {
+class Effect: public synthclone::BlockEffect {
 
     Q_OBJECT
 
@@ -42,11 +42,6 @@ public:
     bool
     getTrimStart() const;
 
-    void
-    process(const synthclone::Zone &zone,
-            synthclone::SampleInputStream &inputStream,
-            synthclone::SampleOutputStream &outputStream);
-
 public slots:
 
     void
@@ -69,16 +64,23 @@ signals:
     void
     trimStartChanged(bool trimStart);
 
-private slots:
+protected:
 
     void
-    handleCopyProgress(synthclone::SampleFrameCount current,
-                       synthclone::SampleFrameCount total);
+    prepareBlocks(const synthclone::Zone &zone,
+                  synthclone::SampleInputStream &inputStream,
+                  synthclone::SampleFrameCount &startFrame,
+                  synthclone::SampleFrameCount &frames);
 
 private:
 
-    float
-    getDBFS(float sample) const;
+    qint64
+    findFirstAudibleSample(const float *data, qint64 count,
+                           float threshold) const;
+
+    qint64
+    findLastAudibleSample(const float *data, qint64 count,
+                          float threshold) const;
 
     float sampleFloor;
     bool trimEnd;
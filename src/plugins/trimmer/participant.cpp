@@ -113,6 +113,14 @@ Participant::configureEffect(Effect *effect)
     effectView.setVisible(true);
 }
 
+synthclone::Effect *
+Participant::cloneEffect(const QVariant &state) const
+{
+    Effect *effect = new Effect(tr("Trimmer"));
+    restoreEffectState(effect, state);
+    return effect;
+}
+
 void
 Participant::deactivate(synthclone::Context &context)
 {
@@ -193,7 +201,12 @@ Participant::handleUnregistration(QObject *obj)
 void
 Participant::restoreEffect(const QVariant &state)
 {
-    Effect *effect = addEffect();
+    restoreEffectState(addEffect(), state);
+}
+
+void
+Participant::restoreEffectState(Effect *effect, const QVariant &state) const
+{
     const QVariantMap map = state.toMap();
     effect->setName(map.value("name", tr("Trimmer")).toString());
     effect->setSampleFloor(map.value("sampleFloor", -70.0).toFloat());
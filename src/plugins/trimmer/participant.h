@@ -39,6 +39,9 @@ public:
     void
     activate(synthclone::Context &context, const QVariant &state=QVariant());
 
+    synthclone::Effect *
+    cloneEffect(const QVariant &state) const;
+
     void
     deactivate(synthclone::Context &context);
 
@@ -76,6 +79,9 @@ private:
     void
     configureEffect(Effect *effect);
 
+    void
+    restoreEffectState(Effect *effect, const QVariant &state) const;
+
     synthclone::MenuAction addEffectAction;
     synthclone::Context *context;
     Effect *configuredEffect;
@@ -128,6 +128,8 @@ Participant::handleGenerateRequest()
     synthclone::MIDIData totalNotes = data.getTotalNotes();
     synthclone::MIDIData velocityLayers = data.getVelocityLayers();
 
+    context->beginZoneBatch();
+
     // Iterate over note values
     for (int noteIndex = static_cast<int>(totalNotes - 1); noteIndex >= 0;
          noteIndex--) {
@@ -207,6 +209,8 @@ Participant::handleGenerateRequest()
             zone->setVelocity(velocity);
         }
     }
+
+    context->endZoneBatch();
 }
 
 void
@@ -142,12 +142,21 @@ static QByteArray REMOVING_ZONE_SIGNAL =
 static QByteArray ZONE_ADDED_SIGNAL =
     QMetaObject::normalizedSignature
     (SIGNAL(zoneAdded(synthclone::Zone *, int)));
+static QByteArray ZONE_BATCH_FINISHED_SIGNAL =
+    QMetaObject::normalizedSignature
+    (SIGNAL(zoneBatchFinished()));
+static QByteArray ZONE_BATCH_STARTED_SIGNAL =
+    QMetaObject::normalizedSignature
+    (SIGNAL(zoneBatchStarted()));
 static QByteArray ZONE_MOVED_SIGNAL =
     QMetaObject::normalizedSignature
     (SIGNAL(zoneMoved(synthclone::Zone *, int, int)));
 static QByteArray ZONE_REMOVED_SIGNAL =
     QMetaObject::normalizedSignature
     (SIGNAL(zoneRemoved(synthclone::Zone *, int)));
+static QByteArray ZONES_REORDERED_SIGNAL =
+    QMetaObject::normalizedSignature
+    (SIGNAL(zonesReordered(const QList<int> &)));
 
 static QByteArray ZONE_SELECTION_CHANGED_SIGNAL =
     QMetaObject::normalizedSignature
@@ -411,6 +420,9 @@ static QByteArray VELOCITY_PROPERTY_VISIBILITY_CHANGED_SIGNAL =
 static QByteArray WET_SAMPLE_PROPERTY_VISIBILITY_CHANGED_SIGNAL =
     QMetaObject::normalizedSignature
     (SIGNAL(wetSamplePropertyVisibilityChanged(bool)));
+static QByteArray XRUN_COUNT_PROPERTY_VISIBILITY_CHANGED_SIGNAL =
+    QMetaObject::normalizedSignature
+    (SIGNAL(xrunCountPropertyVisibilityChanged(bool)));
 
 static QByteArray SAMPLE_CHANNEL_COUNT_CHANGED_SIGNAL =
     QMetaObject::normalizedSignature
@@ -543,8 +555,11 @@ Context::Context(synthclone::Participant &participant,
 
     connect_(&session, ADDING_ZONE_SIGNAL);
     connect_(&session, ZONE_ADDED_SIGNAL);
+    connect_(&session, ZONE_BATCH_FINISHED_SIGNAL);
+    connect_(&session, ZONE_BATCH_STARTED_SIGNAL);
     connect_(&session, ZONE_MOVED_SIGNAL);
     connect_(&session, ZONE_REMOVED_SIGNAL);
+    connect_(&session, ZONES_REORDERED_SIGNAL);
     connect_(&session, MOVING_ZONE_SIGNAL);
     connect_(&session, REMOVING_ZONE_SIGNAL);
 
@@ -567,6 +582,7 @@ Context::Context(synthclone::Participant &participant,
     connect_(&session, STATUS_PROPERTY_VISIBILITY_CHANGED_SIGNAL);
     connect_(&session, VELOCITY_PROPERTY_VISIBILITY_CHANGED_SIGNAL);
     connect_(&session, WET_SAMPLE_PROPERTY_VISIBILITY_CHANGED_SIGNAL);
+    connect_(&session, XRUN_COUNT_PROPERTY_VISIBILITY_CHANGED_SIGNAL);
 
     connect_(&session, SAMPLE_CHANNEL_COUNT_CHANGED_SIGNAL);
     connect_(&session, SAMPLE_RATE_CHANGED_SIGNAL);
@@ -781,6 +797,12 @@ Context::addZone(int index)
     return session.addZone(index);
 }
 
+void
+Context::beginZoneBatch()
+{
+    session.beginZoneBatch();
+}
+
 void
 Context::buildTargets()
 {
@@ -806,6 +828,12 @@ Context::deactivateParticipant(const synthclone::Participant *participant)
     participantManager.deactivateParticipant(participant);
 }
 
+void
+Context::endZoneBatch()
+{
+    session.endZoneBatch();
+}
+
 const synthclone::EffectJob *
 Context::getCurrentEffectJob() const
 {
@@ -1152,6 +1180,18 @@ Context::isWetSamplePropertyVisible() const
     return session.isWetSamplePropertyVisible();
 }
 
+bool
+Context::isXrunCountPropertyVisible() const
+{
+    return session.isXrunCountPropertyVisible();
+}
+
+bool
+Context::isZoneBatchActive() const
+{
+    return session.isZoneBatchActive();
+}
+
 bool
 Context::isZoneSelected(const synthclone::Zone *zone) const
 {
@@ -1290,6 +1330,12 @@ Context::removeZone(int index)
     session.removeZone(index);
 }
 
+void
+Context::reorderZones(const QList<int> &indexes)
+{
+    session.reorderZones(indexes);
+}
+
 void
 Context::reportError(const QString &message)
 {
@@ -1422,6 +1468,12 @@ Context::setWetSamplePropertyVisible(bool visible)
     session.setWetSamplePropertyVisible(visible);
 }
 
+void
+Context::setXrunCountPropertyVisible(bool visible)
+{
+    session.setXrunCountPropertyVisible(visible);
+}
+
 void
 Context::setZoneSelected(const synthclone::Zone *zone, bool selected)
 {
@@ -187,6 +187,12 @@ public:
     bool
     isWetSamplePropertyVisible() const;
 
+    bool
+    isXrunCountPropertyVisible() const;
+
+    bool
+    isZoneBatchActive() const;
+
     bool
     isZoneSelected(const synthclone::Zone *zone) const;
 
@@ -261,6 +267,9 @@ public slots:
     synthclone::Zone *
     addZone(int index=-1);
 
+    void
+    beginZoneBatch();
+
     void
     buildTargets();
 
@@ -271,6 +280,9 @@ public slots:
     void
     deactivateParticipant(const synthclone::Participant *participant);
 
+    void
+    endZoneBatch();
+
     void
     loadSession(const QDir &directory);
 
@@ -334,6 +346,9 @@ public slots:
     void
     removeZone(int index);
 
+    void
+    reorderZones(const QList<int> &indexes);
+
     void
     reportError(const QString &message);
 
@@ -400,6 +415,9 @@ public slots:
     void
     setWetSamplePropertyVisible(bool visible);
 
+    void
+    setXrunCountPropertyVisible(bool visible);
+
     void
     setZoneSelected(const synthclone::Zone *zone, bool selected);
 
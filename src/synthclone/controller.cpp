@@ -27,6 +27,7 @@
 #include <QtGui/QClipboard>
 
 #include <synthclone/error.h>
+#include <synthclone/sampler.h>
 
 #include "controller.h"
 #include "samplerateconverter.h"
@@ -190,6 +191,8 @@ Controller::Controller(Application &application, QObject *parent):
             &session, SLOT(setVelocityPropertyVisible(bool)));
     connect(zoneViewlet, SIGNAL(wetSamplePropertyVisibilityChangeRequest(bool)),
             &session, SLOT(setWetSamplePropertyVisible(bool)));
+    connect(zoneViewlet, SIGNAL(xrunCountPropertyVisibilityChangeRequest(bool)),
+            &session, SLOT(setXrunCountPropertyVisible(bool)));
 
     connect(zoneViewlet, SIGNAL(aftertouchPropertySortRequest(bool)),
             SLOT(handleZoneViewletAftertouchPropertySortRequest(bool)));
@@ -215,6 +218,8 @@ Controller::Controller(Application &application, QObject *parent):
             SLOT(handleZoneViewletVelocityPropertySortRequest(bool)));
     connect(zoneViewlet, SIGNAL(wetSamplePropertySortRequest(bool)),
             SLOT(handleZoneViewletWetSamplePropertySortRequest(bool)));
+    connect(zoneViewlet, SIGNAL(xrunCountPropertySortRequest(bool)),
+            SLOT(handleZoneViewletXrunCountPropertySortRequest(bool)));
 
     connect(zoneViewlet,
             SIGNAL(aftertouchChangeRequest(int, synthclone::MIDIData)),
@@ -322,6 +327,8 @@ Controller::Controller(Application &application, QObject *parent):
         (session.isVelocityPropertyVisible());
     zoneViewlet->setWetSamplePropertyVisible
         (session.isWetSamplePropertyVisible());
+    zoneViewlet->setXrunCountPropertyVisible
+        (session.isXrunCountPropertyVisible());
     for (synthclone::MIDIData i = 0; i < 0x80; i++) {
         zoneViewlet->
             setControlPropertyVisible(i, session.isControlPropertyVisible(i));
@@ -385,6 +392,8 @@ Controller::Controller(Application &application, QObject *parent):
             zoneViewlet, SLOT(setVelocityPropertyVisible(bool)));
     connect(&session, SIGNAL(wetSamplePropertyVisibilityChanged(bool)),
             zoneViewlet, SLOT(setWetSamplePropertyVisible(bool)));
+    connect(&session, SIGNAL(xrunCountPropertyVisibilityChanged(bool)),
+            zoneViewlet, SLOT(setXrunCountPropertyVisible(bool)));
 
     connect(&session,
             SIGNAL(selectedEffectChanged(const synthclone::Effect *, int)),
@@ -430,6 +439,8 @@ Controller::Controller(Application &application, QObject *parent):
 
     connect(&session, SIGNAL(zoneAdded(synthclone::Zone *, int)),
             SLOT(handleSessionZoneAddition(synthclone::Zone *, int)));
+    connect(&session, SIGNAL(zoneBatchFinished()),
+            SLOT(handleSessionZoneBatchFinish()));
     connect(&session, SIGNAL(zoneMoved(synthclone::Zone *, int, int)),
             SLOT(handleSessionZoneMove(synthclone::Zone *, int, int)));
     connect(&session, SIGNAL(removingZone(synthclone::Zone *, int)),
@@ -438,6 +449,8 @@ Controller::Controller(Application &application, QObject *parent):
             SIGNAL(zoneSelectionChanged(synthclone::Zone *, int, bool)),
             SLOT(handleSessionZoneSelectionChange(synthclone::Zone *, int,
                                                   bool)));
+    connect(&session, SIGNAL(zonesReordered(const QList<int> &)),
+            SLOT(handleSessionZonesReorder(const QList<int> &)));
 
     connect(&session, SIGNAL(buildingTarget(const synthclone::Target *)),
             SLOT(handleSessionTargetBuild(const synthclone::Target *)));
@@ -471,6 +484,19 @@ Controller::Controller(Application &application, QObject *parent):
 
     lastSessionState = synthclone::SESSIONSTATE_CURRENT;
 
+    session.setEffectJobThreadCount(settings.getEffectJobThreadCount());
+    session.setSweepSize(settings.getSamplerSweepSize());
+    session.setXrunRetryCount(settings.getSamplerXrunRetryCount());
+    synthclone::Sampler::setRealtimePriority
+        (settings.getSamplerRealtimePriority());
+    synthclone::Sampler::setSilenceHoldTime
+        (settings.getSamplerSilenceHoldTime());
+    synthclone::Sampler::setSilenceThreshold
+        (settings.getSamplerSilenceThreshold());
+    synthclone::Sample::setHardLinksEnabled
+        (settings.isSampleHardLinkingEnabled());
+    synthclone::Sample::setMemoryBudget(settings.getSampleMemoryBudget());
+
     // Load plugins
     QStringList scannedPaths;
     loadPlugins(getCorePluginDirectory(), scannedPaths);
@@ -776,9 +802,11 @@ Controller::removeDirectoryContents(QDir &directory)
 void
 Controller::removeSelectedZones()
 {
+    session.beginZoneBatch();
     for (int i = session.getSelectedZoneCount() - 1; i >= 0; i--) {
         session.removeZone(session.getSelectedZone(i));
     }
+    session.endZoneBatch();
 }
 
 void
@@ -789,6 +817,27 @@ Controller::reportError(const QString &message)
     emit errorReported(message);
 }
 
+void
+Controller::resetZoneViewlet()
+{
+    int count = session.getZoneCount();
+    ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
+    zoneViewlet->resetZones(count);
+    for (int i = 0; i < count; i++) {
+        updateZoneViewlet(session.getZone(i), i);
+    }
+    for (int i = session.getSelectedZoneCount() - 1; i >= 0; i--) {
+        zoneViewlet->
+            setSelected(session.getZoneIndex(session.getSelectedZone(i)),
+                        true);
+    }
+    bool enabled = static_cast<bool>(count);
+    zoneViewlet->setInvertSelectionEnabled(enabled);
+    zoneViewlet->setSelectAllEnabled(enabled);
+    refreshZoneViewletActions();
+    refreshZoneBuildTargetsAction();
+}
+
 void
 Controller::run(const QDir *sessionDirectory)
 {
@@ -861,6 +910,7 @@ Controller::updateZoneViewlet(const synthclone::Zone *zone, int index)
     viewlet->setStatus(index, zone->getStatus());
     viewlet->setVelocity(index, zone->getVelocity());
     viewlet->setWetSampleStale(index, zone->isWetSampleStale());
+    viewlet->setXrunCount(index, zone->getXrunCount());
 
     for (synthclone::MIDIData i = 0; i < 0x80; i++) {
         viewlet->setControlValue(index, i, zone->getControlValue(i));
@@ -1740,10 +1790,6 @@ Controller::handleSessionTargetRemoval(const synthclone::Target *target,
 void
 Controller::handleSessionZoneAddition(synthclone::Zone *zone, int index)
 {
-    ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
-    zoneViewlet->addZone(index);
-    updateZoneViewlet(zone, index);
-
     connect(zone, SIGNAL(aftertouchChanged(synthclone::MIDIData)),
             SLOT(handleZoneAftertouchChange(synthclone::MIDIData)));
     connect(zone, SIGNAL(channelChanged(synthclone::MIDIData)),
@@ -1773,21 +1819,43 @@ Controller::handleSessionZoneAddition(synthclone::Zone *zone, int index)
             SLOT(handleZoneWetSampleChange(const synthclone::Sample *)));
     connect(zone, SIGNAL(wetSampleStaleChanged(bool)),
             SLOT(handleZoneWetSampleStaleChange(bool)));
+    connect(zone, SIGNAL(xrunCountChanged(int)),
+            SLOT(handleZoneXrunCountChange(int)));
+
+    // The zone table is rebuilt when the batch is finished.
+    if (session.isZoneBatchActive()) {
+        return;
+    }
 
+    ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
+    zoneViewlet->addZone(index);
+    updateZoneViewlet(zone, index);
     zoneViewlet->setInvertSelectionEnabled(true);
     zoneViewlet->setSelectAllEnabled(true);
 }
 
+void
+Controller::handleSessionZoneBatchFinish()
+{
+    resetZoneViewlet();
+}
+
 void
 Controller::handleSessionZoneMove(synthclone::Zone */*zone*/, int fromIndex,
                                   int toIndex)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     mainView.getZoneViewlet()->moveZone(fromIndex, toIndex);
 }
 
 void
 Controller::handleSessionZoneRemoval(synthclone::Zone */*zone*/, int index)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
     zoneViewlet->removeZone(index);
     if (! session.getZoneCount()) {
@@ -1810,11 +1878,23 @@ void
 Controller::handleSessionZoneSelectionChange(synthclone::Zone */*zone*/,
                                              int index, bool selected)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
     zoneViewlet->setSelected(index, selected);
     refreshZoneViewletActions();
 }
 
+void
+Controller::handleSessionZonesReorder(const QList<int> &indexes)
+{
+    if (session.isZoneBatchActive()) {
+        return;
+    }
+    mainView.getZoneViewlet()->reorderZones(indexes);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // SessionLoadView signal handlers
 ////////////////////////////////////////////////////////////////////////////////
@@ -1993,6 +2073,9 @@ Controller::handleViewViewletParticipantEditRequest()
 void
 Controller::handleZoneAftertouchChange(synthclone::MIDIData aftertouch)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setAftertouch(session.getZoneIndex(zone), aftertouch);
@@ -2001,6 +2084,9 @@ Controller::handleZoneAftertouchChange(synthclone::MIDIData aftertouch)
 void
 Controller::handleZoneChannelChange(synthclone::MIDIData channel)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->setChannel(session.getZoneIndex(zone), channel);
 }
@@ -2008,6 +2094,9 @@ Controller::handleZoneChannelChange(synthclone::MIDIData channel)
 void
 Controller::handleZoneChannelPressureChange(synthclone::MIDIData pressure)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setChannelPressure(session.getZoneIndex(zone), pressure);
@@ -2017,6 +2106,9 @@ void
 Controller::handleZoneControlValueChange(synthclone::MIDIData control,
                                          synthclone::MIDIData value)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setControlValue(session.getZoneIndex(zone), control, value);
@@ -2025,6 +2117,9 @@ Controller::handleZoneControlValueChange(synthclone::MIDIData control,
 void
 Controller::handleZoneDrySampleChange(const synthclone::Sample *sample)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     int index = session.getZoneIndex(zone);
     ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
@@ -2056,6 +2151,9 @@ Controller::handleZoneDrySampleChange(const synthclone::Sample *sample)
 void
 Controller::handleZoneDrySampleStaleChange(bool stale)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setDrySampleStale(session.getZoneIndex(zone), stale);
@@ -2064,6 +2162,9 @@ Controller::handleZoneDrySampleStaleChange(bool stale)
 void
 Controller::handleZoneNoteChange(synthclone::MIDIData note)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->setNote(session.getZoneIndex(zone), note);
 }
@@ -2071,6 +2172,9 @@ Controller::handleZoneNoteChange(synthclone::MIDIData note)
 void
 Controller::handleZoneReleaseTimeChange(synthclone::SampleTime releaseTime)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setReleaseTime(session.getZoneIndex(zone), releaseTime);
@@ -2079,6 +2183,9 @@ Controller::handleZoneReleaseTimeChange(synthclone::SampleTime releaseTime)
 void
 Controller::handleZoneSampleTimeChange(synthclone::SampleTime sampleTime)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setSampleTime(session.getZoneIndex(zone), sampleTime);
@@ -2087,6 +2194,9 @@ Controller::handleZoneSampleTimeChange(synthclone::SampleTime sampleTime)
 void
 Controller::handleZoneStatusChange(synthclone::Zone::Status status)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
     zoneViewlet->setStatus(session.getZoneIndex(zone), status);
@@ -2097,6 +2207,9 @@ Controller::handleZoneStatusChange(synthclone::Zone::Status status)
 void
 Controller::handleZoneVelocityChange(synthclone::MIDIData velocity)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setVelocity(session.getZoneIndex(zone), velocity);
@@ -2105,6 +2218,9 @@ Controller::handleZoneVelocityChange(synthclone::MIDIData velocity)
 void
 Controller::handleZoneWetSampleChange(const synthclone::Sample *sample)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     int index = session.getZoneIndex(zone);
     ZoneViewlet *zoneViewlet = mainView.getZoneViewlet();
@@ -2134,11 +2250,24 @@ Controller::handleZoneWetSampleChange(const synthclone::Sample *sample)
 void
 Controller::handleZoneWetSampleStaleChange(bool stale)
 {
+    if (session.isZoneBatchActive()) {
+        return;
+    }
     synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
     mainView.getZoneViewlet()->
         setWetSampleStale(session.getZoneIndex(zone), stale);
 }
 
+void
+Controller::handleZoneXrunCountChange(int count)
+{
+    if (session.isZoneBatchActive()) {
+        return;
+    }
+    synthclone::Zone *zone = qobject_cast<synthclone::Zone *>(sender());
+    mainView.getZoneViewlet()->setXrunCount(session.getZoneIndex(zone), count);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ZoneListLoader signal handlers
 ////////////////////////////////////////////////////////////////////////////////
@@ -2173,10 +2302,12 @@ Controller::handleZoneViewletAftertouchPropertySortRequest(bool ascending)
 void
 Controller::handleZoneViewletApplyEffectsRequest()
 {
+    session.beginZoneBatch();
     int count = session.getSelectedZoneCount();
     for (int i = 0; i < count; i++) {
         session.addEffectJob(session.getSelectedZone(i));
     }
+    session.endZoneBatch();
 }
 
 void
@@ -2211,25 +2342,31 @@ Controller::handleZoneViewletChannelPropertySortRequest(bool ascending)
 void
 Controller::handleZoneViewletClearEffectJobsRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getEffectJobCount() - 1; i >= 0; i--) {
         session.removeEffectJob(i);
     }
+    session.endZoneBatch();
 }
 
 void
 Controller::handleZoneViewletClearSamplerJobsRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getSamplerJobCount() - 1; i >= 0; i--) {
         session.removeSamplerJob(i);
     }
+    session.endZoneBatch();
 }
 
 void
 Controller::handleZoneViewletClearSelectionRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getZoneCount() - 1; i >= 0; i--) {
         session.setZoneSelected(i, false);
     }
+    session.endZoneBatch();
 }
 
 void
@@ -2288,9 +2425,11 @@ Controller::handleZoneViewletInsertRequest()
 void
 Controller::handleZoneViewletInvertSelectionRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getZoneCount() - 1; i >= 0; i--) {
         session.setZoneSelected(i, ! session.isZoneSelected(i));
     }
+    session.endZoneBatch();
 }
 
 void
@@ -2362,29 +2501,35 @@ Controller::handleZoneViewletReleaseTimePropertySortRequest(bool ascending)
 void
 Controller::handleZoneViewletRemoveEffectJobRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getSelectedZoneCount() - 1; i >= 0; i--) {
         session.removeEffectJob
             (session.getEffectJob(session.getSelectedZone(i)));
     }
+    session.endZoneBatch();
 }
 
 void
 Controller::handleZoneViewletRemoveSamplerJobRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getSelectedZoneCount() - 1; i >= 0; i--) {
         session.removeSamplerJob
             (session.getSamplerJob(session.getSelectedZone(i)));
     }
+    session.endZoneBatch();
 }
 
 void
 Controller::handleZoneViewletSampleRequest()
 {
+    session.beginZoneBatch();
     int count = session.getSelectedZoneCount();
     for (int i = 0; i < count; i++) {
         session.addSamplerJob(synthclone::SamplerJob::TYPE_SAMPLE,
                               session.getSelectedZone(i));
     }
+    session.endZoneBatch();
 }
 
 void
@@ -2405,9 +2550,11 @@ Controller::handleZoneViewletSampleTimePropertySortRequest(bool ascending)
 void
 Controller::handleZoneViewletSelectAllRequest()
 {
+    session.beginZoneBatch();
     for (int i = session.getZoneCount() - 1; i >= 0; i--) {
         session.setZoneSelected(i, true);
     }
+    session.endZoneBatch();
 }
 
 void
@@ -2437,3 +2584,10 @@ Controller::handleZoneViewletWetSamplePropertySortRequest(bool ascending)
     ZoneComparer comparer(ZoneComparer::PROPERTY_WET_SAMPLE);
     session.sortZones(comparer, ascending);
 }
+
+void
+Controller::handleZoneViewletXrunCountPropertySortRequest(bool ascending)
+{
+    ZoneComparer comparer(ZoneComparer::PROPERTY_XRUN_COUNT);
+    session.sortZones(comparer, ascending);
+}
@@ -241,6 +241,9 @@ private slots:
     void
     handleSessionZoneAddition(synthclone::Zone *zone, int index);
 
+    void
+    handleSessionZoneBatchFinish();
+
     void
     handleSessionZoneMove(synthclone::Zone *zone, int fromIndex, int toIndex);
 
@@ -251,6 +254,9 @@ private slots:
     handleSessionZoneSelectionChange(synthclone::Zone *zone, int index,
                                      bool selected);
 
+    void
+    handleSessionZonesReorder(const QList<int> &indexes);
+
     void
     handleSessionLoadViewCloseRequest();
 
@@ -347,6 +353,9 @@ private slots:
     void
     handleZoneWetSampleStaleChange(bool stale);
 
+    void
+    handleZoneXrunCountChange(int count);
+
     void
     handleZoneListLoaderWarning(int line, int column, const QString &message);
 
@@ -465,6 +474,9 @@ private slots:
     void
     handleZoneViewletWetSamplePropertySortRequest(bool ascending);
 
+    void
+    handleZoneViewletXrunCountPropertySortRequest(bool ascending);
+
 private:
 
     enum PostDirectorySelectAction {
@@ -516,6 +528,9 @@ private:
     void
     removeSelectedZones();
 
+    void
+    resetZoneViewlet();
+
     void
     setSessionLoadViewCreationDefaults();
 
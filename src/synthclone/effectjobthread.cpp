@@ -17,13 +17,32 @@
  * Ave, Cambridge, MA 02139, USA.
  */
 
+#include <cassert>
+
+#include <QtCore/QScopedPointer>
+
+#include <synthclone/error.h>
+#include <synthclone/sampleinputstream.h>
+#include <synthclone/sampleoutputstream.h>
+
 #include "effectjobthread.h"
 #include "session.h"
 
+// Static data
+
+// The largest intermediate sample, in bytes, that's kept in memory.  Each
+// thread holds at most two intermediate samples at a time (the input and the
+// output of the current effect), so this caps the memory used by a thread no
+// matter how long the sample or the effect chain is.  Larger intermediates
+// are written to temporary files.
+static const qint64 MAXIMUM_INTERMEDIATE_BYTES = 32 * 1024 * 1024;
+
 EffectJobThread::EffectJobThread(Session *session, QObject *parent):
     QThread(parent)
 {
+    job = 0;
     this->session = session;
+    wetSample = 0;
 }
 
 EffectJobThread::~EffectJobThread()
@@ -31,8 +50,149 @@ EffectJobThread::~EffectJobThread()
     // Empty
 }
 
+EffectJobThread::EffectList
+EffectJobThread::getEffects() const
+{
+    return effects;
+}
+
+QVariantList
+EffectJobThread::getEffectStates() const
+{
+    return effectStates;
+}
+
+EffectJob *
+EffectJobThread::getJob()
+{
+    return job;
+}
+
 void
 EffectJobThread::run()
 {
-    session->runEffectJobs();
+    for (;;) {
+        semaphore.acquire();
+        if (stopped.load()) {
+            break;
+        }
+        if (job) {
+            runJob();
+        }
+    }
+
+    // Reset the thread so that it can be started again.
+    semaphore.tryAcquire(semaphore.available());
+    stopped.store(0);
+}
+
+void
+EffectJobThread::runJob()
+{
+    int count = effects.count();
+    QString path;
+    Zone *zone = job->getZone();
+    const synthclone::Sample *drySample = zone->getDrySample();
+    assert(drySample);
+    QScopedPointer<synthclone::Sample> wetSamplePtr;
+    try {
+        if (! count) {
+            // Simple case - just copy the file.
+            path = session->createUniqueSampleFile(*(session->directory));
+            wetSample = new synthclone::Sample(*drySample, path);
+            wetSamplePtr.reset(wetSample);
+        } else {
+            // Intermediate samples are kept in memory so that they never touch
+            // the file system, unless they're too large.  Effects may seek in
+            // their input and need its frame count up front, so intermediates
+            // are buffered whole instead of being piped between effects.
+            // Only the final wet sample is written to the session's samples
+            // directory.
+            const synthclone::Sample *inputSample = drySample;
+            QScopedPointer<synthclone::Sample> inputSamplePtr;
+            for (int i = 0; i < count; i++) {
+                bool lastEffect = i == (count - 1);
+                {
+                    synthclone::SampleInputStream inputStream(*inputSample);
+                    synthclone::Sample *outputSample;
+                    if (lastEffect) {
+                        path = session->createUniqueSampleFile
+                            (*(session->directory));
+                        outputSample = new synthclone::Sample(path);
+                        wetSample = outputSample;
+                    } else {
+                        // The output of an effect is usually about as large
+                        // as its input.  Outputs that grow past the estimate
+                        // are still bounded by the sample memory budget.
+                        qint64 bytes = inputStream.getFrames() *
+                            inputStream.getChannels() *
+                            static_cast<qint64>(sizeof(float));
+                        outputSample = new synthclone::Sample
+                            (bytes > MAXIMUM_INTERMEDIATE_BYTES ?
+                             synthclone::Sample::STORAGE_FILE :
+                             synthclone::Sample::STORAGE_MEMORY);
+                    }
+                    wetSamplePtr.reset(outputSample);
+                    synthclone::SampleOutputStream
+                        outputStream(*outputSample,
+                                     inputStream.getSampleRate(),
+                                     inputStream.getChannels());
+                    effects[i]->process(*zone, inputStream, outputStream);
+                }
+                if (! lastEffect) {
+                    inputSample = wetSamplePtr.data();
+                    inputSamplePtr.reset(wetSamplePtr.take());
+                }
+            }
+        }
+    } catch (synthclone::Error &e) {
+        wetSample = 0;
+        emit jobError(e.getMessage());
+        return;
+    }
+    wetSamplePtr.take();
+    emit jobCompleted();
+}
+
+void
+EffectJobThread::setEffects(const EffectList &effects,
+                            const QVariantList &states)
+{
+    assert(! job);
+    effectStates = states;
+    this->effects = effects;
+}
+
+void
+EffectJobThread::startJob(EffectJob *job)
+{
+    assert(job);
+    assert(! this->job);
+    this->job = job;
+    semaphore.release();
+}
+
+void
+EffectJobThread::stop()
+{
+    if (isRunning()) {
+        stopped.store(1);
+        semaphore.release();
+    }
+}
+
+EffectJob *
+EffectJobThread::takeJob()
+{
+    EffectJob *job = this->job;
+    this->job = 0;
+    return job;
+}
+
+synthclone::Sample *
+EffectJobThread::takeWetSample()
+{
+    synthclone::Sample *sample = wetSample;
+    wetSample = 0;
+    return sample;
 }
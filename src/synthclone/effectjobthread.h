@@ -20,7 +20,16 @@
 #ifndef __EFFECTJOBTHREAD_H__
 #define __EFFECTJOBTHREAD_H__
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QList>
+#include <QtCore/QSemaphore>
 #include <QtCore/QThread>
+#include <QtCore/QVariant>
+
+#include <synthclone/effect.h>
+#include <synthclone/sample.h>
+
+#include "effectjob.h"
 
 class Session;
 
@@ -30,11 +39,46 @@ class EffectJobThread: public QThread {
 
 public:
 
+    typedef QList<synthclone::Effect *> EffectList;
+
     explicit
     EffectJobThread(Session *session, QObject *parent=0);
 
     ~EffectJobThread();
 
+    EffectList
+    getEffects() const;
+
+    QVariantList
+    getEffectStates() const;
+
+    EffectJob *
+    getJob();
+
+    void
+    setEffects(const EffectList &effects,
+               const QVariantList &states=QVariantList());
+
+    void
+    startJob(EffectJob *job);
+
+    void
+    stop();
+
+    EffectJob *
+    takeJob();
+
+    synthclone::Sample *
+    takeWetSample();
+
+signals:
+
+    void
+    jobCompleted();
+
+    void
+    jobError(const QString &message);
+
 protected:
 
     void
@@ -42,7 +86,16 @@ protected:
 
 private:
 
+    void
+    runJob();
+
+    EffectList effects;
+    QVariantList effectStates;
+    EffectJob *job;
+    QSemaphore semaphore;
     Session *session;
+    QAtomicInt stopped;
+    synthclone::Sample *wetSample;
 
 };
 
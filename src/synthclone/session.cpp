@@ -17,14 +17,21 @@
  * Ave, Cambridge, MA 02139, USA.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
 #include <QtCore/QTemporaryFile>
+#include <QtCore/QVector>
 #include <QtCore/QtAlgorithms>
 
 #include <synthclone/error.h>
+#include <synthclone/sampleinputstream.h>
+#include <synthclone/sampleoutputstream.h>
 #include <synthclone/util.h>
 
 #include "effectjob.h"
@@ -34,6 +41,11 @@
 #include "zonecomparerproxy.h"
 #include "zonelistloader.h"
 
+// Static data
+
+// The number of frames copied at a time when slicing a sweep recording.
+static const synthclone::SampleFrameCount SWEEP_SLICE_FRAMES = 65536;
+
 // Static functions
 
 void
@@ -69,6 +81,7 @@ Session::create(const QDir &directory, synthclone::SampleRate sampleRate,
     writer.writeAttribute("status-property-visible", "true");
     writer.writeAttribute("velocity-property-visible", "true");
     writer.writeAttribute("wet-sample-property-visible", "true");
+    writer.writeAttribute("xrun-count-property-visible", "true");
     QString controlTemplate = "control-property-%1-visible";
     for (synthclone::MIDIData i = 0; i < 0x80; i++) {
         writer.writeAttribute(controlTemplate.arg(i), "false");
@@ -146,15 +159,8 @@ Session::loadXML(const QDir &directory, QDomDocument &document)
 
 Session::Session(ParticipantManager &participantManager, QObject *parent):
     QObject(parent),
-    effectJobThread(this),
-    participantManager(participantManager),
-    zoneIndexComparer(zones)
+    participantManager(participantManager)
 {
-    connect(this, SIGNAL(effectJobThreadCompletion()),
-            SLOT(handleEffectJobThreadCompletion()));
-    connect(this, SIGNAL(effectJobThreadError(QString)),
-            SLOT(handleEffectJobThreadError(QString)));
-
     connect(&participantManager,
             SIGNAL(participantActivated(const synthclone::Participant *,
                                         const synthclone::Participant *,
@@ -180,25 +186,33 @@ Session::Session(ParticipantManager &participantManager, QObject *parent):
     channelPressurePropertyVisible = false;
     channelPropertyVisible = true;
     currentEffectJob = 0;
-    currentEffectJobWetSample = 0;
     currentSamplerJob = 0;
     currentSamplerJobSample = 0;
     currentSamplerJobStream = 0;
     directory = 0;
     drySamplePropertyVisible = true;
+    effectsCloned = false;
     focusedComponent = 0;
     notePropertyVisible = true;
+    preparedEffectJobThreadCount = 0;
     releaseTimePropertyVisible = true;
     sampler = 0;
     samplerData.participant = 0;
     samplerData.registration = 0;
+    samplerJobXruns = 0;
     sampleTimePropertyVisible = true;
     selectedEffect = 0;
     selectedTarget = 0;
     state = synthclone::SESSIONSTATE_CURRENT;
     statusPropertyVisible = true;
+    sweepSize = 0;
+    validZoneIndexCount = 0;
     velocityPropertyVisible = true;
     wetSamplePropertyVisible = true;
+    xrunCountPropertyVisible = true;
+    xrunRetryCount = 0;
+    zoneBatchDepth = 0;
+    setEffectJobThreadCount(1);
 }
 
 Session::~Session()
@@ -267,9 +281,7 @@ Session::addEffectJob(synthclone::Zone *zone, int index)
     qobject_cast<Zone *>(zone)->
         setStatus(synthclone::Zone::STATUS_EFFECT_JOB_QUEUE);
     emit effectJobAdded(job, index);
-    if (! currentEffectJob) {
-        updateEffectJobs();
-    }
+    updateEffectJobs();
     setModified();
     return job;
 }
@@ -299,6 +311,8 @@ Session::addSampler(synthclone::Sampler *sampler,
             SLOT(handleSamplerJobCompletion()));
     connect(sampler, SIGNAL(jobError(const QString &)),
             SLOT(handleSamplerJobError(const QString &)));
+    connect(sampler, SIGNAL(jobXrunsCounted(int)),
+            SLOT(handleSamplerJobXruns(int)));
 
     emit samplerAdded(sampler);
     setModified();
@@ -330,13 +344,8 @@ Session::addSamplerJob(synthclone::SamplerJob::Type type,
     if (index == -1) {
         index = samplerJobs.count();
     }
-    Zone *zoneCopy = qobject_cast<Zone *>(zone);
-    SamplerJob *job = new SamplerJob(type, zoneCopy, this);
-    emit addingSamplerJob(job, index);
-    samplerJobs.insert(index, job);
-    zoneSamplerJobMap.insert(zone, job);
-    zoneCopy->setStatus(synthclone::Zone::STATUS_SAMPLER_JOB_QUEUE);
-    emit samplerJobAdded(job, index);
+    synthclone::SamplerJob *job =
+        insertSamplerJob(type, qobject_cast<Zone *>(zone), index);
     if (! currentSamplerJob) {
         updateSamplerJobs();
     }
@@ -385,6 +394,8 @@ Session::addZone(int index)
 
     emit addingZone(zone, index);
     zones.insert(index, zone);
+    invalidateZoneIndexes(index);
+    zoneIndexMap.insert(zone, index);
 
     connect(zone, SIGNAL(aftertouchChanged(synthclone::MIDIData)),
             SLOT(setModified()));
@@ -407,12 +418,22 @@ Session::addZone(int index)
             SLOT(setModified()));
     connect(zone, SIGNAL(wetSampleChanged(const synthclone::Sample *)),
             SLOT(setModified()));
+    connect(zone, SIGNAL(xrunCountChanged(int)), SLOT(setModified()));
 
     emit zoneAdded(zone, index);
     setModified();
     return zone;
 }
 
+void
+Session::beginZoneBatch()
+{
+    zoneBatchDepth++;
+    if (zoneBatchDepth == 1) {
+        emit zoneBatchStarted();
+    }
+}
+
 void
 Session::buildTargets()
 {
@@ -447,6 +468,41 @@ Session::buildTargets()
     emit targetsBuilt();
 }
 
+bool
+Session::cloneEffects(const QVariantList &states, EffectList &clones)
+{
+    assert(states.count() == effects.count());
+    EffectList copies;
+    for (int i = 0; i < effects.count(); i++) {
+        synthclone::Effect *effect = effects[i];
+        ComponentData *data = effectDataMap.value(effect, 0);
+        assert(data);
+        synthclone::Effect *clone;
+        try {
+            clone = data->participant->cloneEffect(states[i]);
+        } catch (synthclone::Error &e) {
+            qWarning() << tr("failed to copy effect '%1': %2").
+                arg(effect->getName(), e.getMessage());
+            clone = 0;
+        }
+        if (! clone) {
+            qDeleteAll(copies);
+            return false;
+        }
+
+        // Progress and status changes are reported through the registered
+        // effect, but only for the current effect job.
+        connect(clone, SIGNAL(progressChanged(float)),
+                SLOT(handleEffectCloneProgressChange(float)));
+        connect(clone, SIGNAL(statusChanged(QString)),
+                SLOT(handleEffectCloneStatusChange(QString)));
+
+        copies.append(clone);
+    }
+    clones = copies;
+    return true;
+}
+
 QString
 Session::createUniqueSampleFile(const QDir &sessionDirectory)
 {
@@ -454,6 +510,16 @@ Session::createUniqueSampleFile(const QDir &sessionDirectory)
     return createUniqueFile(&samplesDirectory);
 }
 
+void
+Session::endZoneBatch()
+{
+    CONFIRM(zoneBatchDepth, tr("no zone batch is active"));
+    zoneBatchDepth--;
+    if (! zoneBatchDepth) {
+        emit zoneBatchFinished();
+    }
+}
+
 void
 Session::emitLoadWarning(const QDomElement &element, const QString &message)
 {
@@ -568,6 +634,32 @@ Session::getEffectJobIndex(const synthclone::EffectJob *job) const
     return index;
 }
 
+int
+Session::getEffectJobThreadCount() const
+{
+    return effectJobThreads.count();
+}
+
+bool
+Session::getEffectStates(QVariantList &states)
+{
+    QVariantList effectStates;
+    for (int i = 0; i < effects.count(); i++) {
+        synthclone::Effect *effect = effects[i];
+        ComponentData *data = effectDataMap.value(effect, 0);
+        assert(data);
+        try {
+            effectStates.append(data->participant->getState(effect));
+        } catch (synthclone::Error &e) {
+            qWarning() << tr("failed to get state of effect '%1': %2").
+                arg(effect->getName(), e.getMessage());
+            return false;
+        }
+    }
+    states = effectStates;
+    return true;
+}
+
 const synthclone::Component *
 Session::getFocusedComponent() const
 {
@@ -586,6 +678,29 @@ Session::getMinorVersion() const
     return SYNTHCLONE_MINOR_VERSION;
 }
 
+synthclone::Effect *
+Session::getRegisteredEffect(const QObject *clone)
+{
+    // Only the effect copies used for the current effect job are reported.
+    // The copy may have been destroyed while its signal was queued, so it's
+    // only compared, and never dereferenced.
+    if (effectsCloned && currentEffectJob) {
+        for (int i = 0; i < preparedEffectJobThreadCount; i++) {
+            EffectJobThread *thread = effectJobThreads[i];
+            if (thread->getJob() == currentEffectJob) {
+                EffectList clones = thread->getEffects();
+                for (int j = clones.count() - 1; j >= 0; j--) {
+                    if (static_cast<QObject *>(clones[j]) == clone) {
+                        return effects[j];
+                    }
+                }
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
 int
 Session::getRevision() const
 {
@@ -651,7 +766,9 @@ QDir
 Session::getSamplesDirectory(const QDir &sessionDirectory)
 {
     if (! sessionDirectory.exists("samples")) {
-        if (! sessionDirectory.mkdir("samples")) {
+        // Effect job threads may race to create the directory.
+        if (! (sessionDirectory.mkdir("samples") ||
+               sessionDirectory.exists("samples"))) {
             throw synthclone::Error(tr("failed to create samples directory"));
         }
     }
@@ -695,6 +812,12 @@ Session::getState() const
     return state;
 }
 
+int
+Session::getSweepSize() const
+{
+    return sweepSize;
+}
+
 const synthclone::Target *
 Session::getTarget(int index) const
 {
@@ -722,6 +845,12 @@ Session::getTargetIndex(const synthclone::Target *target) const
     return index;
 }
 
+int
+Session::getXrunRetryCount() const
+{
+    return xrunRetryCount;
+}
+
 synthclone::Zone *
 Session::getZone(int index)
 {
@@ -742,31 +871,68 @@ Session::getZoneIndex(const synthclone::Zone *zone) const
 {
     CONFIRM(zone, tr("zone is set to NULL"));
 
-    int index = zones.indexOf(const_cast<synthclone::Zone *>(zone));
+    ZoneIndexMap::const_iterator iter = zoneIndexMap.constFind(zone);
 
-    CONFIRM((index >= 0) && (index < zones.count()),
+    CONFIRM(iter != zoneIndexMap.constEnd(),
             tr("zone is not in session zone list"));
 
+    int index = iter.value();
+    if (index >= validZoneIndexCount) {
+        refreshZoneIndexes();
+        index = zoneIndexMap.value(zone);
+    }
+    assert(zones[index] == zone);
     return index;
 }
 
+void
+Session::handleEffectCloneProgressChange(float progress)
+{
+    synthclone::Effect *effect = getRegisteredEffect(sender());
+    if (effect) {
+        emit effect->progressChanged(progress);
+    }
+}
+
+void
+Session::handleEffectCloneStatusChange(const QString &status)
+{
+    synthclone::Effect *effect = getRegisteredEffect(sender());
+    if (effect) {
+        emit effect->statusChanged(status);
+    }
+}
+
 void
 Session::handleEffectJobThreadCompletion()
 {
-    Zone *zone = qobject_cast<EffectJob *>(currentEffectJob)->getZone();
-    zone->setStatus(synthclone::Zone::STATUS_NORMAL);
-    zone->setWetSample(currentEffectJobWetSample, false);
-    assert(currentEffectJobWetSample == zone->getWetSample());
-    recycleCurrentEffectJob();
+    EffectJobThread *thread = qobject_cast<EffectJobThread *>(sender());
+    assert(thread);
+
+    // There's a possibility that the job may not be available if the session
+    // is unloaded while the completion signal is still queued.
+    EffectJob *job = thread->getJob();
+    if (job) {
+        Zone *zone = job->getZone();
+        synthclone::Sample *wetSample = thread->takeWetSample();
+        zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        zone->setWetSample(wetSample, false);
+        assert(wetSample == zone->getWetSample());
+        recycleEffectJob(thread);
+    }
 }
 
 void
 Session::handleEffectJobThreadError(const QString &message)
 {
-    qobject_cast<EffectJob *>(currentEffectJob)->getZone()->
-        setStatus(synthclone::Zone::STATUS_NORMAL);
-    emit effectJobError(message);
-    recycleCurrentEffectJob();
+    EffectJobThread *thread = qobject_cast<EffectJobThread *>(sender());
+    assert(thread);
+    EffectJob *job = thread->getJob();
+    if (job) {
+        job->getZone()->setStatus(synthclone::Zone::STATUS_NORMAL);
+        emit effectJobError(message);
+        recycleEffectJob(thread);
+    }
 }
 
 void
@@ -778,6 +944,7 @@ Session::handleSamplerJobAbort()
         Zone *zone = qobject_cast<SamplerJob *>(currentSamplerJob)->getZone();
         recycleCurrentSamplerJob();
         zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        updateSamplerJobs();
     }
 }
 
@@ -788,20 +955,64 @@ Session::handleSamplerJobCompletion()
     // the session is unloaded while there's still a pending job.
     if (currentSamplerJob) {
         Zone *zone = qobject_cast<SamplerJob *>(currentSamplerJob)->getZone();
-        if (currentSamplerJob->getType() ==
-            synthclone::SamplerJob::TYPE_SAMPLE) {
+
+        // Zones whose samples were captured while the sampler reported xruns
+        // are sampled again.  Their samples are discarded when the job is
+        // recycled.
+        QList<Zone *> retriedZones;
+        if (! parallelJobs.isEmpty()) {
+            for (int i = 0; i < parallelJobs.count(); i++) {
+                parallelStreams[i]->close();
+                Zone *jobZone =
+                    qobject_cast<SamplerJob *>(parallelJobs[i])->getZone();
+                if (zoneIndexMap.contains(jobZone)) {
+                    if (isSamplerJobRetried(jobZone)) {
+                        retriedZones.append(jobZone);
+                        continue;
+                    }
+                    synthclone::Sample *sample = parallelSamples[i];
+                    jobZone->setStatus(synthclone::Zone::STATUS_NORMAL);
+                    jobZone->setDrySample(sample, false);
+                    assert(sample == jobZone->getDrySample());
+                    parallelSamples[i] = 0;
+                }
+            }
+            recycleCurrentSamplerJob();
+            zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        } else if (! sweepJobs.isEmpty()) {
             currentSamplerJobStream->close();
-            if (zones.contains(zone)) {
+            sliceSweepRecording(retriedZones);
+            recycleCurrentSamplerJob();
+            zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        } else if (currentSamplerJob->getType() ==
+                   synthclone::SamplerJob::TYPE_SAMPLE) {
+            currentSamplerJobStream->close();
+            if (zoneIndexMap.contains(zone)) {
                 zone->setStatus(synthclone::Zone::STATUS_NORMAL);
-                zone->setDrySample(currentSamplerJobSample, false);
-                assert(currentSamplerJobSample == zone->getDrySample());
-                currentSamplerJobSample = 0;
+                if (isSamplerJobRetried(zone)) {
+                    retriedZones.append(zone);
+                } else {
+                    zone->setDrySample(currentSamplerJobSample, false);
+                    assert(currentSamplerJobSample == zone->getDrySample());
+                    currentSamplerJobSample = 0;
+                }
             }
             recycleCurrentSamplerJob();
         } else {
             recycleCurrentSamplerJob();
             zone->setStatus(synthclone::Zone::STATUS_NORMAL);
         }
+
+        // Retried zones go to the front of the queue, so they're sampled
+        // again before the sampler moves on.
+        for (int i = 0; i < retriedZones.count(); i++) {
+            insertSamplerJob(synthclone::SamplerJob::TYPE_SAMPLE,
+                             retriedZones[i], i);
+        }
+        if (! retriedZones.isEmpty()) {
+            setModified();
+        }
+        updateSamplerJobs();
     }
 }
 
@@ -816,6 +1027,17 @@ Session::handleSamplerJobError(const QString &message)
         Zone *zone = qobject_cast<SamplerJob *>(currentSamplerJob)->getZone();
         recycleCurrentSamplerJob();
         zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        updateSamplerJobs();
+    }
+}
+
+void
+Session::handleSamplerJobXruns(int count)
+{
+    // The sampler reports the count right before it reports the completion
+    // of the job.
+    if (currentSamplerJob) {
+        samplerJobXruns = count;
     }
 }
 
@@ -827,31 +1049,36 @@ Session::handleZoneLoad(int current, int total)
     emit progressChanged(progress, message);
 }
 
+synthclone::SamplerJob *
+Session::insertSamplerJob(synthclone::SamplerJob::Type type, Zone *zone,
+                          int index)
+{
+    assert(zone);
+    assert((index >= 0) && (index <= samplerJobs.count()));
+    SamplerJob *job = new SamplerJob(type, zone, this);
+    emit addingSamplerJob(job, index);
+    samplerJobs.insert(index, job);
+    zoneSamplerJobMap.insert(zone, job);
+    zone->setStatus(synthclone::Zone::STATUS_SAMPLER_JOB_QUEUE);
+    emit samplerJobAdded(job, index);
+    return job;
+}
+
 void
 Session::insertSelectedZone(synthclone::Zone *zone)
 {
     assert(zone);
-    int index = getZoneIndex(zone);
-    int lastIndex = selectedZones.count() - 1;
-    if (lastIndex == -1) {
-        selectedZones.append(zone);
-    } else if (getZoneIndex(selectedZones[0]) > index) {
-        selectedZones.insert(0, zone);
-    } else if (getZoneIndex(selectedZones[lastIndex]) < index) {
-        selectedZones.append(zone);
-    } else {
-        int firstIndex = 0;
-        while ((lastIndex - firstIndex) > 1) {
-            int testIndex = (lastIndex + firstIndex) / 2;
-            int realIndex = getZoneIndex(selectedZones[testIndex]);
-            assert(realIndex != index);
-            if (realIndex > index) {
-                lastIndex = testIndex;
-            } else {
-                firstIndex = testIndex;
-            }
-        }
-        selectedZones.insert(lastIndex, zone);
+    selectedZones.insert(searchSelectedZones(getZoneIndex(zone)), zone);
+    selectedZoneSet.insert(zone);
+}
+
+void
+Session::invalidateZoneIndexes(int index)
+{
+    // Cached indexes below `validZoneIndexCount` are always correct.  Cached
+    // indexes at or above it are refreshed on demand by getZoneIndex().
+    if (index < validZoneIndexCount) {
+        validZoneIndexCount = index;
     }
 }
 
@@ -904,6 +1131,22 @@ Session::isSampleTimePropertyVisible() const
     return sampleTimePropertyVisible;
 }
 
+bool
+Session::isSamplerJobRetried(Zone *zone)
+{
+    assert(zone);
+    if (samplerJobXruns) {
+        int retries = zoneXrunRetryMap.value(zone, 0);
+        if (retries < xrunRetryCount) {
+            zoneXrunRetryMap.insert(zone, retries + 1);
+            return true;
+        }
+    }
+    zoneXrunRetryMap.remove(zone);
+    zone->setXrunCount(samplerJobXruns);
+    return false;
+}
+
 bool
 Session::isStatusPropertyVisible() const
 {
@@ -922,10 +1165,22 @@ Session::isWetSamplePropertyVisible() const
     return wetSamplePropertyVisible;
 }
 
+bool
+Session::isXrunCountPropertyVisible() const
+{
+    return xrunCountPropertyVisible;
+}
+
+bool
+Session::isZoneBatchActive() const
+{
+    return zoneBatchDepth > 0;
+}
+
 bool
 Session::isZoneSelected(const synthclone::Zone *zone) const
 {
-    return selectedZones.contains(const_cast<synthclone::Zone *>(zone));
+    return selectedZoneSet.contains(zone);
 }
 
 bool
@@ -1026,6 +1281,9 @@ Session::load(const QDir &directory)
     visible = verifyBooleanAttribute
         (documentElement, "wet-sample-property-visible", true);
     setWetSamplePropertyVisible(visible);
+    visible = verifyBooleanAttribute
+        (documentElement, "xrun-count-property-visible", true);
+    setXrunCountPropertyVisible(visible);
     QString controlPropertyTemplate = "control-property-%1-visible";
     for (synthclone::MIDIData i = 0; i < 0x80; i++) {
         visible = verifyBooleanAttribute
@@ -1166,7 +1424,9 @@ Session::load(const QDir &directory)
             }
         }
     }
-    effectJobThread.start();
+    for (int i = effectJobThreads.count() - 1; i >= 0; i--) {
+        effectJobThreads[i]->start();
+    }
 
     emit progressChanged(1.0, tr("Loaded."));
 
@@ -1246,10 +1506,15 @@ Session::moveZone(int fromIndex, int toIndex)
 
     synthclone::Zone *zone = zones[fromIndex];
     emit movingZone(zone, fromIndex, toIndex);
-    zones.move(fromIndex, toIndex);
 
     // Preserve the sort order of the selected zones list.
-    if (selectedZones.removeOne(zone)) {
+    bool selected = isZoneSelected(zone);
+    if (selected) {
+        removeSelectedZone(zone);
+    }
+    zones.move(fromIndex, toIndex);
+    invalidateZoneIndexes(qMin(fromIndex, toIndex));
+    if (selected) {
         insertSelectedZone(zone);
     }
 
@@ -1282,14 +1547,57 @@ Session::readXMLVariant(const QDomElement &element)
 }
 
 void
-Session::recycleCurrentEffectJob()
+Session::prepareEffectJobThreads()
 {
-    bool removed = zoneEffectJobMap.remove(currentEffectJob->getZone());
+    assert(! preparedEffectJobThreadCount);
+
+    // Effects aren't required to be reentrant, so every thread gets its own
+    // copies of the effects, made from the same effect states.  If the
+    // effects can't be copied, then only the first thread is used, and it
+    // uses the registered effects.
+    EffectList clones;
+    QVariantList states;
+    effectsCloned = getEffectStates(states) && cloneEffects(states, clones);
+    if (! effectsCloned) {
+        effectJobThreads[0]->setEffects(effects);
+        preparedEffectJobThreadCount = 1;
+        return;
+    }
+    effectJobThreads[0]->setEffects(clones, states);
+    preparedEffectJobThreadCount = 1;
+    for (int i = 1; i < effectJobThreads.count(); i++) {
+        if (! cloneEffects(states, clones)) {
+            break;
+        }
+        effectJobThreads[i]->setEffects(clones, states);
+        preparedEffectJobThreadCount++;
+    }
+}
+
+void
+Session::recycleEffectJob(EffectJobThread *thread)
+{
+    EffectJob *job = thread->takeJob();
+    assert(job);
+    bool removed = zoneEffectJobMap.remove(job->getZone());
     assert(removed);
-    delete qobject_cast<EffectJob *>(currentEffectJob);
-    currentEffectJob = 0;
-    emit currentEffectJobChanged(0);
+    bool current = job == currentEffectJob;
+    delete job;
+    if (current) {
+        currentEffectJob = 0;
+        for (int i = 0; i < preparedEffectJobThreadCount; i++) {
+            EffectJob *runningJob = effectJobThreads[i]->getJob();
+            if (runningJob) {
+                currentEffectJob = runningJob;
+                break;
+            }
+        }
+        emit currentEffectJobChanged(currentEffectJob);
+    }
     updateEffectJobs();
+    if (! currentEffectJob) {
+        releaseEffectJobThreads();
+    }
 }
 
 void
@@ -1305,12 +1613,67 @@ Session::recycleCurrentSamplerJob()
         delete currentSamplerJobSample;
         currentSamplerJobSample = 0;
     }
+
+    int i;
+    for (i = parallelStreams.count() - 1; i >= 0; i--) {
+        delete qobject_cast<QObject *>(parallelStreams[i]);
+    }
+    parallelStreams.clear();
+    for (i = parallelSamples.count() - 1; i >= 0; i--) {
+        synthclone::Sample *sample = parallelSamples[i];
+        if (sample) {
+            sample->setTemporary(true);
+            delete sample;
+        }
+    }
+    parallelSamples.clear();
+    recycleExtraSamplerJobs(parallelJobs);
+    recycleExtraSamplerJobs(sweepJobs);
+
     bool removed = zoneSamplerJobMap.remove(currentSamplerJob->getZone());
     assert(removed);
     delete qobject_cast<SamplerJob *>(currentSamplerJob);
     currentSamplerJob = 0;
+    samplerJobXruns = 0;
     emit currentSamplerJobChanged(0);
-    updateSamplerJobs();
+}
+
+void
+Session::recycleExtraSamplerJobs(SamplerJobList &jobs)
+{
+    // The first job of a sweep or a parallel batch is the current sampler job;
+    // the other jobs are recycled here.
+    for (int i = jobs.count() - 1; i > 0; i--) {
+        Zone *zone = qobject_cast<SamplerJob *>(jobs[i])->getZone();
+        bool removed = zoneSamplerJobMap.remove(zone);
+        assert(removed);
+        delete qobject_cast<SamplerJob *>(jobs[i]);
+        zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+    }
+    jobs.clear();
+}
+
+void
+Session::refreshZoneIndexes() const
+{
+    for (int i = zones.count() - 1; i >= validZoneIndexCount; i--) {
+        zoneIndexMap[zones[i]] = i;
+    }
+    validZoneIndexCount = zones.count();
+}
+
+void
+Session::releaseEffectJobThreads()
+{
+    for (int i = 0; i < preparedEffectJobThreadCount; i++) {
+        EffectJobThread *thread = effectJobThreads[i];
+        if (effectsCloned) {
+            qDeleteAll(thread->getEffects());
+        }
+        thread->setEffects(EffectList());
+    }
+    effectsCloned = false;
+    preparedEffectJobThreadCount = 0;
 }
 
 void
@@ -1377,6 +1740,7 @@ Session::removeSampler()
         Zone *zone = qobject_cast<SamplerJob *>(currentSamplerJob)->getZone();
         recycleCurrentSamplerJob();
         zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+        updateSamplerJobs();
     }
     if (sampler == focusedComponent) {
         setFocusedComponent(0);
@@ -1390,6 +1754,8 @@ Session::removeSampler()
                this, SLOT(handleSamplerJobCompletion()));
     disconnect(sampler, SIGNAL(jobError(const QString &)),
                this, SLOT(handleSamplerJobError(const QString &)));
+    disconnect(sampler, SIGNAL(jobXrunsCounted(int)),
+               this, SLOT(handleSamplerJobXruns(int)));
 
     samplerData.participant = 0;
     QScopedPointer<Registration> registrationPtr(samplerData.registration);
@@ -1420,6 +1786,16 @@ Session::removeSamplerJob(int index)
     setModified();
 }
 
+void
+Session::removeSelectedZone(synthclone::Zone *zone)
+{
+    assert(zone);
+    int index = searchSelectedZones(getZoneIndex(zone));
+    assert((index < selectedZones.count()) && (selectedZones[index] == zone));
+    selectedZones.removeAt(index);
+    selectedZoneSet.remove(zone);
+}
+
 void
 Session::removeTarget(const synthclone::Target *target)
 {
@@ -1466,94 +1842,58 @@ Session::removeZone(int index)
     setZoneSelected(index, false);
     emit removingZone(zone, index);
     zones.removeAt(index);
+    zoneIndexMap.remove(zone);
+    invalidateZoneIndexes(index);
+    zoneXrunRetryMap.remove(zone);
     emit zoneRemoved(zone, index);
     delete qobject_cast<Zone *>(zone);
     setModified();
 }
 
 void
-Session::runEffectJobs()
+Session::reorderZones(const QList<int> &indexes)
 {
-    for (;;) {
-        effectJobSemaphore.acquire();
-        if (! currentEffectJob) {
-            // Session is being unloaded.
-            break;
+    int count = zones.count();
+
+    CONFIRM(indexes.count() == count,
+            tr("index list does not contain every zone index"));
+
+    QVector<bool> used(count, false);
+    bool changed = false;
+    ZoneList reorderedZones;
+    reorderedZones.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int index = indexes[i];
+
+        CONFIRM((index >= 0) && (index < count),
+                tr("'%1': index is out of range").arg(index));
+        CONFIRM(! used[index], tr("'%1': index is repeated").arg(index));
+
+        used[index] = true;
+        if (index != i) {
+            changed = true;
         }
-        int count = effects.count();
-        QString path;
-        Zone *zone = qobject_cast<EffectJob *>(currentEffectJob)->getZone();
-        const synthclone::Sample *drySample = zone->getDrySample();
-        assert(drySample);
-        QScopedPointer<synthclone::Sample> wetSamplePtr;
-        try {
-            if (! count) {
-                // Simple case - just copy the file.
-                path = createUniqueSampleFile(*directory);
-                currentEffectJobWetSample =
-                    new synthclone::Sample(*drySample, path);
-                wetSamplePtr.reset(currentEffectJobWetSample);
-            } else if (count == 1) {
-                // Simple case - one input stream and one output stream.
-                path = createUniqueSampleFile(*directory);
-                currentEffectJobWetSample = new synthclone::Sample(path);
-                wetSamplePtr.reset(currentEffectJobWetSample);
-                synthclone::SampleInputStream inputStream(*drySample);
-                synthclone::SampleOutputStream
-                    outputStream(*currentEffectJobWetSample,
-                                 inputStream.getSampleRate(),
-                                 inputStream.getChannels());
-                effects[0]->process(*zone, inputStream, outputStream);
-            } else {
-                // Complex case - 2 or more effects.
-                synthclone::Sample *tempWetSample = new synthclone::Sample();
-                wetSamplePtr.reset(tempWetSample);
-                synthclone::SampleInputStream firstInputStream(*drySample);
-                synthclone::SampleChannelCount channelCount =
-                    firstInputStream.getChannels();
-                synthclone::SampleRate sampleRate =
-                    firstInputStream.getSampleRate();
-                synthclone::SampleOutputStream
-                    firstOutputStream(*tempWetSample, sampleRate,
-                                      channelCount);
-                effects[0]->process(*zone, firstInputStream,
-                                    firstOutputStream);
-                firstInputStream.close();
-                firstOutputStream.close();
-                synthclone::Sample *tempDrySample = tempWetSample;
-                QScopedPointer<synthclone::Sample>
-                    tempDrySamplePtr(tempDrySample);
-                wetSamplePtr.take();
-                for (int i = 1; i < (count - 1); i++) {
-                    tempWetSample = new synthclone::Sample();
-                    wetSamplePtr.reset(tempWetSample);
-                    synthclone::SampleInputStream
-                        tempInputStream(*tempDrySample);
-                    synthclone::SampleOutputStream
-                        tempOutputStream(*tempWetSample, sampleRate,
-                                         channelCount);
-                    effects[i]->process(*zone, tempInputStream,
-                                        tempOutputStream);
-                    tempDrySample = tempWetSample;
-                    tempDrySamplePtr.reset(tempDrySample);
-                    wetSamplePtr.take();
-                }
-                path = createUniqueSampleFile(*directory);
-                currentEffectJobWetSample = new synthclone::Sample(path);
-                wetSamplePtr.reset(currentEffectJobWetSample);
-                synthclone::SampleInputStream inputStream(*tempDrySample);
-                synthclone::SampleOutputStream
-                    outputStream(*currentEffectJobWetSample, sampleRate,
-                                 channelCount);
-                effects[count - 1]->process(*zone, inputStream, outputStream);
+        reorderedZones.append(zones[index]);
+    }
+    if (! changed) {
+        return;
+    }
+    zones = reorderedZones;
+    invalidateZoneIndexes(0);
+
+    // Preserve the sort order of the selected zones list.
+    if (! selectedZones.isEmpty()) {
+        selectedZones.clear();
+        for (int i = 0; i < count; i++) {
+            synthclone::Zone *zone = zones[i];
+            if (selectedZoneSet.contains(zone)) {
+                selectedZones.append(zone);
             }
-        } catch (synthclone::Error &e) {
-            emit effectJobThreadError(e.getMessage());
-            continue;
         }
-        wetSamplePtr.take();
-        emit effectJobThreadCompletion();
     }
+
+    emit zonesReordered(indexes);
+    setModified();
 }
 
 void
@@ -1625,6 +1965,8 @@ Session::save(const QDir &directory)
                                   velocityPropertyVisible ? "true" : "false");
             writer.writeAttribute("wet-sample-property-visible",
                                   wetSamplePropertyVisible ? "true" : "false");
+            writer.writeAttribute("xrun-count-property-visible",
+                                  xrunCountPropertyVisible ? "true" : "false");
             QString controlPropertyTemplate = "control-property-%1-visible";
             for (synthclone::MIDIData i = 0; i < 0x80; i++) {
                 writer.writeAttribute(controlPropertyTemplate.arg(i),
@@ -1728,6 +2070,24 @@ Session::save(const QDir &directory)
     emit stateChanged(state, this->directory);
 }
 
+int
+Session::searchSelectedZones(int index) const
+{
+    // Returns the position in the selected zone list of the first zone with
+    // an index that isn't less than `index`.
+    int first = 0;
+    int last = selectedZones.count();
+    while (first < last) {
+        int middle = (first + last) / 2;
+        if (getZoneIndex(selectedZones[middle]) < index) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
 void
 Session::setSelectedEffect(const synthclone::Effect *effect)
 {
@@ -1820,6 +2180,26 @@ Session::setDrySamplePropertyVisible(bool visible)
     }
 }
 
+void
+Session::setEffectJobThreadCount(int count)
+{
+    CONFIRM(count > 0,
+            tr("'%1': invalid effect job thread count").arg(count));
+    CONFIRM(! directory, tr("session is currently loaded"));
+
+    while (effectJobThreads.count() < count) {
+        EffectJobThread *thread = new EffectJobThread(this, this);
+        connect(thread, SIGNAL(jobCompleted()),
+                SLOT(handleEffectJobThreadCompletion()));
+        connect(thread, SIGNAL(jobError(QString)),
+                SLOT(handleEffectJobThreadError(QString)));
+        effectJobThreads.append(thread);
+    }
+    while (effectJobThreads.count() > count) {
+        delete effectJobThreads.takeLast();
+    }
+}
+
 void
 Session::setFocusedComponent(const synthclone::Component *component)
 {
@@ -1909,6 +2289,13 @@ Session::setStatusPropertyVisible(bool visible)
     }
 }
 
+void
+Session::setSweepSize(int size)
+{
+    CONFIRM(size >= 0, tr("'%1': invalid sweep size").arg(size));
+    sweepSize = size;
+}
+
 void
 Session::setVelocityPropertyVisible(bool visible)
 {
@@ -1927,6 +2314,22 @@ Session::setWetSamplePropertyVisible(bool visible)
     }
 }
 
+void
+Session::setXrunCountPropertyVisible(bool visible)
+{
+    if (xrunCountPropertyVisible != visible) {
+        xrunCountPropertyVisible = visible;
+        emit xrunCountPropertyVisibilityChanged(visible);
+    }
+}
+
+void
+Session::setXrunRetryCount(int count)
+{
+    CONFIRM(count >= 0, tr("'%1': invalid xrun retry count").arg(count));
+    xrunRetryCount = count;
+}
+
 void
 Session::setZoneSelected(const synthclone::Zone *zone, bool selected)
 {
@@ -1940,94 +2343,230 @@ Session::setZoneSelected(int index, bool selected)
             tr("'%1': index is out of range").arg(index));
 
     synthclone::Zone *zone = zones[index];
-    if (selectedZones.contains(zone) != selected) {
+    if (selectedZoneSet.contains(zone) != selected) {
         if (selected) {
             insertSelectedZone(zone);
         } else {
-            bool removed = selectedZones.removeOne(zone);
-            assert(removed);
+            removeSelectedZone(zone);
         }
         emit zoneSelectionChanged(zone, index, selected);
     }
 }
 
 void
-Session::sortZones(const synthclone::ZoneComparer &comparer, bool ascending,
-                   int leftIndex, int rightIndex)
+Session::sliceSweepRecording(QList<Zone *> &retriedZones)
 {
+    synthclone::SampleChannelCount channels =
+        sessionSampleData.getSampleChannelCount();
+    synthclone::SampleRate sampleRate = sessionSampleData.getSampleRate();
+    QVector<float> buffer(SWEEP_SLICE_FRAMES * channels);
+    float *data = buffer.data();
 
-    // The algorithm here is based on the in-place quick sort algorithm found
-    // at http://en.wikipedia.org/wiki/Quicksort.  We implement the algorithm
-    // instead of using std::stable_sort because we want to keep track of each
-    // zone move so that any objects listening for move signals can be updated.
-    // This makes any sort operation a bit slower than it could be, but allows
-    // objects observing zone order to be notified when zones are moved.
-
-    if (leftIndex < rightIndex) {
-        int pivotIndex = (leftIndex + rightIndex) / 2;
-        synthclone::Zone *pivotZone = zones[pivotIndex];
-        swapZones(pivotIndex, rightIndex);
-        int storeIndex = leftIndex;
-
-        synthclone::Zone *checkZone;
-        int i;
-        if (ascending) {
-            for (i = leftIndex; i < rightIndex; i++) {
-                checkZone = zones[i];
-                if (comparer.isLessThan(checkZone, pivotZone)) {
-                    if (i != storeIndex) {
-                        swapZones(storeIndex, i);
+    // Release tails are kept when the sampler is set to capture them.
+    bool releaseCaptured = synthclone::Sampler::getSilenceThreshold() > 0.0;
+    synthclone::Sample *sample = 0;
+    try {
+        // The sampler starts the recording after its latency, so the spans are
+        // laid out back to back from the first frame of the recording.
+        synthclone::SampleInputStream inputStream(*currentSamplerJobSample);
+        for (int i = 0; i < sweepJobs.count(); i++) {
+            Zone *zone = qobject_cast<SamplerJob *>(sweepJobs[i])->getZone();
+            synthclone::SampleFrameCount sampleFrames =
+                static_cast<synthclone::SampleFrameCount>
+                (zone->getSampleTime() * sampleRate);
+            synthclone::SampleFrameCount skipFrames =
+                static_cast<synthclone::SampleFrameCount>
+                (zone->getReleaseTime() * sampleRate);
+            if (releaseCaptured) {
+                sampleFrames += skipFrames;
+                skipFrames = 0;
+            }
+            // A sweep is one capture, so an xrun during the sweep is
+            // attributed to every zone in it.
+            if (zoneIndexMap.contains(zone) && isSamplerJobRetried(zone)) {
+                retriedZones.append(zone);
+                skipFrames += sampleFrames;
+            } else if (zoneIndexMap.contains(zone)) {
+                QString path = createUniqueSampleFile(*directory);
+                sample = new synthclone::Sample(path, false, this);
+                synthclone::SampleOutputStream
+                    outputStream(*sample, sampleRate, channels);
+                while (sampleFrames) {
+                    synthclone::SampleFrameCount frames =
+                        qMin(sampleFrames, SWEEP_SLICE_FRAMES);
+                    if (inputStream.read(data, frames) != frames) {
+                        throw synthclone::Error
+                            (tr("the sweep recording is shorter than "
+                                "expected"));
                     }
-                    storeIndex++;
+                    outputStream.write(data, frames);
+                    sampleFrames -= frames;
                 }
+                outputStream.close();
+                zone->setStatus(synthclone::Zone::STATUS_NORMAL);
+                zone->setDrySample(sample, false);
+                assert(sample == zone->getDrySample());
+                sample = 0;
+            } else {
+                skipFrames += sampleFrames;
             }
-        } else {
-            for (i = leftIndex; i < rightIndex; i++) {
-                checkZone = zones[i];
-                if (comparer.isLessThan(pivotZone, checkZone)) {
-                    if (i != storeIndex) {
-                        swapZones(storeIndex, i);
-                    }
-                    storeIndex++;
+            while (skipFrames) {
+                synthclone::SampleFrameCount frames =
+                    qMin(skipFrames, SWEEP_SLICE_FRAMES);
+                if (inputStream.read(data, frames) != frames) {
+                    break;
                 }
+                skipFrames -= frames;
             }
         }
-
-        if (storeIndex != rightIndex) {
-            swapZones(storeIndex, rightIndex);
+    } catch (synthclone::Error &e) {
+        if (sample) {
+            sample->setTemporary(true);
+            delete sample;
         }
-        sortZones(comparer, ascending, leftIndex, storeIndex - 1);
-        sortZones(comparer, ascending, storeIndex + 1, rightIndex);
+        emit samplerJobError(e.getMessage());
     }
 }
 
 void
 Session::sortZones(const synthclone::ZoneComparer &comparer, bool ascending)
 {
-    sortZones(comparer, ascending, 0, zones.count() - 1);
-    std::stable_sort(selectedZones.begin(), selectedZones.end(),
-                     ZoneComparerProxy(zoneIndexComparer));
+    // The zones are sorted as a permutation of their indexes so that the new
+    // order can be applied, and reported to observers, in one operation.
+    ZoneList sortedZones = zones;
+    std::stable_sort(sortedZones.begin(), sortedZones.end(),
+                     ZoneComparerProxy(comparer, ascending));
+    QHash<const synthclone::Zone *, int> oldIndexes;
+    int count = zones.count();
+    int i;
+    for (i = 0; i < count; i++) {
+        oldIndexes.insert(zones[i], i);
+    }
+    QList<int> indexes;
+    indexes.reserve(count);
+    for (i = 0; i < count; i++) {
+        indexes.append(oldIndexes.value(sortedZones[i]));
+    }
+    reorderZones(indexes);
 }
 
-void
-Session::swapZones(int firstIndex, int secondIndex)
+bool
+Session::startParallelJobs()
 {
-    assert((firstIndex >= 0) && (firstIndex < zones.count()));
-    assert((secondIndex >= 0) && (secondIndex < zones.count()));
-    assert(firstIndex != secondIndex);
-    int highIndex;
-    int lowIndex;
-    if (firstIndex > secondIndex) {
-        highIndex = firstIndex;
-        lowIndex = secondIndex;
-    } else {
-        highIndex = secondIndex;
-        lowIndex = firstIndex;
+    // Pick the first job for each MIDI channel that the sampler can sample in
+    // parallel, up to the first job that isn't a sampling job.  The job at the
+    // head of the queue must be one of them.
+    QList<synthclone::MIDIData> channels;
+    QList<int> indexes;
+    int i;
+    for (i = 0; i < samplerJobs.count(); i++) {
+        synthclone::SamplerJob *job = samplerJobs[i];
+        if (job->getType() != synthclone::SamplerJob::TYPE_SAMPLE) {
+            break;
+        }
+        synthclone::MIDIData channel = job->getZone()->getChannel();
+        if (! sampler->isParallelChannel(channel)) {
+            if (! i) {
+                return false;
+            }
+            continue;
+        }
+        if (! channels.contains(channel)) {
+            channels.append(channel);
+            indexes.append(i);
+        }
+    }
+    if (indexes.count() < 2) {
+        return false;
+    }
+
+    // Each job is recorded to its own sample, as it would be with a single
+    // job.
+    QList<synthclone::Sample *> samples;
+    QList<synthclone::SampleStream *> streams;
+    try {
+        for (i = 0; i < indexes.count(); i++) {
+            QString path = createUniqueSampleFile(*directory);
+            synthclone::Sample *sample =
+                new synthclone::Sample(path, false, this);
+            samples.append(sample);
+            streams.append(new synthclone::SampleOutputStream
+                           (*sample, sessionSampleData.getSampleRate(),
+                            sessionSampleData.getSampleChannelCount()));
+        }
+    } catch (synthclone::Error &e) {
+        for (i = streams.count() - 1; i >= 0; i--) {
+            delete qobject_cast<QObject *>(streams[i]);
+        }
+        for (i = samples.count() - 1; i >= 0; i--) {
+            samples[i]->setTemporary(true);
+            delete samples[i];
+        }
+        emit samplerJobError(e.getMessage());
+        return false;
     }
-    moveZone(lowIndex, highIndex);
-    if ((highIndex - 1) != lowIndex) {
-        moveZone(highIndex - 1, lowIndex);
+    QList<const synthclone::SamplerJob *> jobs;
+    for (i = indexes.count() - 1; i >= 0; i--) {
+        SamplerJob *job =
+            qobject_cast<SamplerJob *>(takeSamplerJob(indexes[i]));
+        jobs.prepend(job);
+        parallelJobs.prepend(job);
+        job->getZone()->setStatus(synthclone::Zone::STATUS_SAMPLER_SAMPLING);
+    }
+    parallelSamples = samples;
+    parallelStreams = streams;
+    currentSamplerJob = parallelJobs[0];
+    emit currentSamplerJobChanged(currentSamplerJob);
+    sampler->startParallelJobs(jobs, streams);
+    return true;
+}
+
+bool
+Session::startSweep()
+{
+    if ((sweepSize < 2) || (! sampler->isSweepSupported())) {
+        return false;
+    }
+    int count = 0;
+    for (; (count < sweepSize) && (count < samplerJobs.count()); count++) {
+        if (samplerJobs[count]->getType() !=
+            synthclone::SamplerJob::TYPE_SAMPLE) {
+            break;
+        }
     }
+    if (count < 2) {
+        return false;
+    }
+
+    // The sweep is recorded to a single temporary sample, which is sliced into
+    // the zones' dry samples when the sweep is complete.
+    synthclone::Sample *sample;
+    synthclone::SampleStream *stream;
+    try {
+        QString path = createUniqueSampleFile(*directory);
+        sample = new synthclone::Sample(path, false, this);
+        QScopedPointer<synthclone::Sample> samplePtr(sample);
+        stream = new synthclone::SampleOutputStream
+            (*sample, sessionSampleData.getSampleRate(),
+             sessionSampleData.getSampleChannelCount());
+        samplePtr.take();
+    } catch (synthclone::Error &e) {
+        emit samplerJobError(e.getMessage());
+        return false;
+    }
+    QList<const synthclone::SamplerJob *> jobs;
+    for (int i = 0; i < count; i++) {
+        SamplerJob *job = qobject_cast<SamplerJob *>(takeSamplerJob(0));
+        jobs.append(job);
+        sweepJobs.append(job);
+        job->getZone()->setStatus(synthclone::Zone::STATUS_SAMPLER_SAMPLING);
+    }
+    currentSamplerJob = sweepJobs[0];
+    currentSamplerJobSample = sample;
+    currentSamplerJobStream = stream;
+    emit currentSamplerJobChanged(currentSamplerJob);
+    sampler->startSweep(jobs, *stream);
+    return true;
 }
 
 synthclone::EffectJob *
@@ -2059,11 +2598,13 @@ Session::unload()
         state = synthclone::SESSIONSTATE_UNLOADING;
         emit stateChanged(state, directory);
 
-        // Let the effect job thread know that it needs to terminate.
-        effectJobSemaphore.release();
-
         int i;
 
+        // Let the effect job threads know that they need to terminate.
+        for (i = effectJobThreads.count() - 1; i >= 0; i--) {
+            effectJobThreads[i]->stop();
+        }
+
         // Take care of sampler jobs before removing components.
         for (i = samplerJobs.count() - 1; i >= 0; i--) {
             removeSamplerJob(i);
@@ -2072,6 +2613,20 @@ Session::unload()
             if (sampler) {
                 removeSampler();
             } else {
+                for (i = parallelJobs.count() - 1; i > 0; i--) {
+                    delete qobject_cast<SamplerJob *>(parallelJobs[i]);
+                }
+                parallelJobs.clear();
+                for (i = parallelStreams.count() - 1; i >= 0; i--) {
+                    delete qobject_cast<QObject *>(parallelStreams[i]);
+                }
+                parallelStreams.clear();
+                qDeleteAll(parallelSamples);
+                parallelSamples.clear();
+                for (i = sweepJobs.count() - 1; i > 0; i--) {
+                    delete qobject_cast<SamplerJob *>(sweepJobs[i]);
+                }
+                sweepJobs.clear();
                 delete qobject_cast<SamplerJob *>(currentSamplerJob);
                 currentSamplerJob = 0;
                 if (currentSamplerJobStream) {
@@ -2088,10 +2643,30 @@ Session::unload()
             removeEffectJob(i);
         }
 
-        // We need to make sure the effect job thread is terminated before
+        // We need to make sure the effect job threads are terminated before
         // removing components, as contexts associated with participants that
         // are deactivated will want to remove the effects they've registered.
-        effectJobThread.wait();
+        for (i = effectJobThreads.count() - 1; i >= 0; i--) {
+            EffectJobThread *thread = effectJobThreads[i];
+            thread->wait();
+            EffectJob *job = thread->takeJob();
+            if (job) {
+                synthclone::Sample *wetSample = thread->takeWetSample();
+                if (wetSample) {
+                    wetSample->setTemporary(true);
+                    delete wetSample;
+                }
+                bool removed = zoneEffectJobMap.remove(job->getZone());
+                assert(removed);
+                job->getZone()->setStatus(synthclone::Zone::STATUS_NORMAL);
+                delete job;
+            }
+        }
+        if (currentEffectJob) {
+            currentEffectJob = 0;
+            emit currentEffectJobChanged(0);
+        }
+        releaseEffectJobThreads();
 
         // Removing activated root participants should remove all components,
         // child participants, etc.
@@ -2104,9 +2679,11 @@ Session::unload()
             }
         }
 
+        beginZoneBatch();
         for (int i = zones.count() - 1; i >= 0; i--) {
             removeZone(i);
         }
+        endZoneBatch();
 
         sessionSampleData.setSampleDirectory(0);
         delete directory;
@@ -2124,9 +2701,11 @@ Session::unload()
         assert(! selectedEffect);
         assert(! selectedTarget);
         assert(! selectedZones.count());
+        assert(! selectedZoneSet.count());
         assert(! targets.count());
         assert(! targetDataMap.count());
         assert(! zones.count());
+        assert(! zoneIndexMap.count());
         assert(! zoneEffectJobMap.count());
         assert(! zoneSamplerJobMap.count());
 
@@ -2138,12 +2717,36 @@ Session::unload()
 void
 Session::updateEffectJobs()
 {
-    if ((! currentEffectJob) && (effectJobs.count())) {
+    if (effectJobs.count() && (! preparedEffectJobThreadCount)) {
+        prepareEffectJobThreads();
+    }
+    QVariantList states;
+    bool statesRead = effectsCloned && getEffectStates(states);
+    for (int i = 0; (i < preparedEffectJobThreadCount) && effectJobs.count();
+         i++) {
+        EffectJobThread *thread = effectJobThreads[i];
+        if (thread->getJob()) {
+            continue;
+        }
+
+        // Effects may have been edited since the thread's copies were made.
+        // Idle threads get new copies, so that every job started from now on
+        // uses the edited effects.  If new copies can't be made, the old ones
+        // are kept.
+        if (statesRead && (states != thread->getEffectStates())) {
+            EffectList clones;
+            if (cloneEffects(states, clones)) {
+                qDeleteAll(thread->getEffects());
+                thread->setEffects(clones, states);
+            }
+        }
         EffectJob *job = qobject_cast<EffectJob *>(takeEffectJob(0));
-        currentEffectJob = job;
-        emit currentEffectJobChanged(job);
+        if (! currentEffectJob) {
+            currentEffectJob = job;
+            emit currentEffectJobChanged(job);
+        }
         job->getZone()->setStatus(synthclone::Zone::STATUS_EFFECTS);
-        effectJobSemaphore.release();
+        thread->startJob(job);
     }
 }
 
@@ -2151,6 +2754,9 @@ void
 Session::updateSamplerJobs()
 {
     if (sampler && (! currentSamplerJob)) {
+        if (startParallelJobs() || startSweep()) {
+            return;
+        }
         while (samplerJobs.count()) {
             SamplerJob *job = qobject_cast<SamplerJob *>(takeSamplerJob(0));
             QScopedPointer<SamplerJob> jobPtr(job);
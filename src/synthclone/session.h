@@ -23,7 +23,8 @@
 #include <limits>
 
 #include <QtCore/QDir>
-#include <QtCore/QSemaphore>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QXmlStreamWriter>
 #include <QtXml/QDomDocument>
 
@@ -37,7 +38,6 @@
 #include "effectjobthread.h"
 #include "participantmanager.h"
 #include "zone.h"
-#include "zoneindexcomparer.h"
 
 class Session: public QObject {
 
@@ -88,6 +88,9 @@ public:
     int
     getEffectJobIndex(const synthclone::EffectJob *job) const;
 
+    int
+    getEffectJobThreadCount() const;
+
     const synthclone::Component *
     getFocusedComponent() const;
 
@@ -136,6 +139,9 @@ public:
     synthclone::SessionState
     getState() const;
 
+    int
+    getSweepSize() const;
+
     const synthclone::Target *
     getTarget(int index) const;
 
@@ -145,6 +151,9 @@ public:
     int
     getTargetIndex(const synthclone::Target *target) const;
 
+    int
+    getXrunRetryCount() const;
+
     synthclone::Zone *
     getZone(int index);
 
@@ -187,6 +196,12 @@ public:
     bool
     isWetSamplePropertyVisible() const;
 
+    bool
+    isXrunCountPropertyVisible() const;
+
+    bool
+    isZoneBatchActive() const;
+
     bool
     isZoneSelected(const synthclone::Zone *zone) const;
 
@@ -220,9 +235,15 @@ public slots:
     synthclone::Zone *
     addZone(int index=-1);
 
+    void
+    beginZoneBatch();
+
     void
     buildTargets();
 
+    void
+    endZoneBatch();
+
     void
     load(const QDir &directory);
 
@@ -274,6 +295,9 @@ public slots:
     void
     removeZone(int index);
 
+    void
+    reorderZones(const QList<int> &indexes);
+
     void
     save();
 
@@ -295,6 +319,9 @@ public slots:
     void
     setDrySamplePropertyVisible(bool visible);
 
+    void
+    setEffectJobThreadCount(int count);
+
     void
     setFocusedComponent(const synthclone::Component *component);
 
@@ -331,12 +358,21 @@ public slots:
     void
     setStatusPropertyVisible(bool visible);
 
+    void
+    setSweepSize(int size);
+
     void
     setVelocityPropertyVisible(bool visible);
 
     void
     setWetSamplePropertyVisible(bool visible);
 
+    void
+    setXrunCountPropertyVisible(bool visible);
+
+    void
+    setXrunRetryCount(int count);
+
     void
     setZoneSelected(const synthclone::Zone *zone, bool selected);
 
@@ -413,12 +449,6 @@ signals:
     void
     effectJobRemoved(const synthclone::EffectJob *job, int index);
 
-    void
-    effectJobThreadCompletion();
-
-    void
-    effectJobThreadError(const QString &message);
-
     void
     effectMoved(const synthclone::Effect *effect, int fromIndex, int toIndex);
 
@@ -539,9 +569,18 @@ signals:
     void
     wetSamplePropertyVisibilityChanged(bool visible);
 
+    void
+    xrunCountPropertyVisibilityChanged(bool visible);
+
     void
     zoneAdded(synthclone::Zone *zone, int index);
 
+    void
+    zoneBatchFinished();
+
+    void
+    zoneBatchStarted();
+
     void
     zoneMoved(synthclone::Zone *zone, int fromIndex, int toIndex);
 
@@ -551,8 +590,17 @@ signals:
     void
     zoneSelectionChanged(synthclone::Zone *zone, int index, bool selected);
 
+    void
+    zonesReordered(const QList<int> &indexes);
+
 private slots:
 
+    void
+    handleEffectCloneProgressChange(float progress);
+
+    void
+    handleEffectCloneStatusChange(const QString &status);
+
     void
     handleEffectJobThreadCompletion();
 
@@ -568,16 +616,21 @@ private slots:
     void
     handleSamplerJobError(const QString &message);
 
+    void
+    handleSamplerJobXruns(int count);
+
     void
     handleZoneLoad(int current, int total);
 
 private:
 
     typedef QList<synthclone::EffectJob *> EffectJobList;
+    typedef QList<EffectJobThread *> EffectJobThreadList;
     typedef QList<synthclone::Effect *> EffectList;
     typedef QList<synthclone::SamplerJob *> SamplerJobList;
     typedef QList<synthclone::Target *> TargetList;
     typedef QList<synthclone::Zone *> ZoneList;
+    typedef QSet<const synthclone::Zone *> ZoneSet;
 
     struct ComponentData {
         const synthclone::Participant *participant;
@@ -588,8 +641,10 @@ private:
     typedef QMap<const synthclone::Target *, ComponentData *> TargetDataMap;
     typedef QMap<const synthclone::Zone *,
                  synthclone::EffectJob *> ZoneEffectJobMap;
+    typedef QHash<const synthclone::Zone *, int> ZoneIndexMap;
     typedef QMap<const synthclone::Zone *,
                  synthclone::SamplerJob *> ZoneSamplerJobMap;
+    typedef QMap<const synthclone::Zone *, int> ZoneXrunRetryMap;
 
     static void
     initializeDirectory(const QDir &directory);
@@ -601,6 +656,9 @@ private:
     static bool
     loadXML(const QDir &directory, QDomDocument &document);
 
+    bool
+    cloneEffects(const QVariantList &states, EffectList &clones);
+
     QString
     createUniqueSampleFile(const QDir &sessionDirectory);
 
@@ -610,12 +668,31 @@ private:
     synthclone::Participant *
     getActivatedParticipant(const QDomElement &element);
 
+    bool
+    getEffectStates(QVariantList &states);
+
+    synthclone::Effect *
+    getRegisteredEffect(const QObject *clone);
+
     QDir
     getSamplesDirectory(const QDir &sessionDirectory);
 
+    synthclone::SamplerJob *
+    insertSamplerJob(synthclone::SamplerJob::Type type, Zone *zone,
+                     int index);
+
     void
     insertSelectedZone(synthclone::Zone *zone);
 
+    void
+    invalidateZoneIndexes(int index);
+
+    bool
+    isSamplerJobRetried(Zone *zone);
+
+    void
+    prepareEffectJobThreads();
+
     QVariant
     readXMLState(const QDomElement &element);
 
@@ -623,23 +700,37 @@ private:
     readXMLVariant(const QDomElement &element);
 
     void
-    recycleCurrentEffectJob();
+    recycleEffectJob(EffectJobThread *thread);
 
     void
     recycleCurrentSamplerJob();
 
+    void
+    recycleExtraSamplerJobs(SamplerJobList &jobs);
+
     void
     refreshWetSample(Zone *zone);
 
     void
-    runEffectJobs();
+    refreshZoneIndexes() const;
 
     void
-    sortZones(const synthclone::ZoneComparer &comparer, bool ascending,
-              int leftIndex, int rightIndex);
+    releaseEffectJobThreads();
 
     void
-    swapZones(int firstIndex, int secondIndex);
+    removeSelectedZone(synthclone::Zone *zone);
+
+    int
+    searchSelectedZones(int index) const;
+
+    void
+    sliceSweepRecording(QList<Zone *> &retriedZones);
+
+    bool
+    startParallelJobs();
+
+    bool
+    startSweep();
 
     synthclone::EffectJob *
     takeEffectJob(int index);
@@ -679,7 +770,6 @@ private:
     bool channelPropertyVisible;
     bool controlPropertiesVisible[0x80];
     synthclone::EffectJob *currentEffectJob;
-    synthclone::Sample *currentEffectJobWetSample;
     synthclone::SamplerJob *currentSamplerJob;
     synthclone::Sample *currentSamplerJobSample;
     synthclone::SampleStream *currentSamplerJobStream;
@@ -687,31 +777,44 @@ private:
     bool drySamplePropertyVisible;
     EffectDataMap effectDataMap;
     EffectJobList effectJobs;
-    QSemaphore effectJobSemaphore;
-    EffectJobThread effectJobThread;
+    EffectJobThreadList effectJobThreads;
     EffectList effects;
+    bool effectsCloned;
     const synthclone::Component *focusedComponent;
     bool notePropertyVisible;
+    SamplerJobList parallelJobs;
+    QList<synthclone::Sample *> parallelSamples;
+    QList<synthclone::SampleStream *> parallelStreams;
     ParticipantManager &participantManager;
+    int preparedEffectJobThreadCount;
     bool releaseTimePropertyVisible;
     synthclone::Sampler *sampler;
     ComponentData samplerData;
     SamplerJobList samplerJobs;
+    int samplerJobXruns;
     bool sampleTimePropertyVisible;
     const synthclone::Effect *selectedEffect;
     const synthclone::Target *selectedTarget;
+    ZoneSet selectedZoneSet;
     ZoneList selectedZones;
     SessionSampleData sessionSampleData;
     synthclone::SessionState state;
     bool statusPropertyVisible;
+    SamplerJobList sweepJobs;
+    int sweepSize;
     TargetList targets;
     TargetDataMap targetDataMap;
+    mutable int validZoneIndexCount;
     bool velocityPropertyVisible;
     bool wetSamplePropertyVisible;
+    bool xrunCountPropertyVisible;
+    int xrunRetryCount;
+    int zoneBatchDepth;
     ZoneList zones;
     ZoneEffectJobMap zoneEffectJobMap;
-    ZoneIndexComparer zoneIndexComparer;
+    mutable ZoneIndexMap zoneIndexMap;
     ZoneSamplerJobMap zoneSamplerJobMap;
+    ZoneXrunRetryMap zoneXrunRetryMap;
 
 };
 
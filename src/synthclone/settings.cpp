@@ -18,6 +18,9 @@
  */
 
 #include <cassert>
+#include <cmath>
+
+#include <QtCore/QThread>
 
 #include <synthclone/error.h>
 
@@ -52,6 +55,14 @@ Settings::addPluginPath(const QString &path)
     }
 }
 
+int
+Settings::getEffectJobThreadCount()
+{
+    int count = read("effectJobThreadCount", QThread::idealThreadCount()).
+        toInt();
+    return (count < 1) ? 1 : count;
+}
+
 QStringList
 Settings::getPluginPaths()
 {
@@ -64,6 +75,58 @@ Settings::getRecentSessionPaths()
     return read("recentSessionPaths").toStringList();
 }
 
+qint64
+Settings::getSampleMemoryBudget()
+{
+    // The budget is stored in MiB.
+    qint64 budget = read("sampleMemoryBudget", 256).toLongLong();
+    return ((budget < 0) ? 0 : budget) * 1024 * 1024;
+}
+
+int
+Settings::getSamplerRealtimePriority()
+{
+    // Sampler helper threads use normal scheduling by default.
+    int priority = read("samplerRealtimePriority", 0).toInt();
+    return qBound(0, priority, 99);
+}
+
+float
+Settings::getSamplerSilenceHoldTime()
+{
+    float time = read("samplerSilenceHoldTime", 0.1).toFloat();
+    return (time < 0.0) ? 0.0 : time;
+}
+
+float
+Settings::getSamplerSilenceThreshold()
+{
+    // The threshold is stored in dBFS.  Silence detection is disabled unless a
+    // threshold is set.
+    bool success;
+    float decibels = read("samplerSilenceThreshold").toFloat(&success);
+    if (! success) {
+        return 0.0;
+    }
+    return (decibels > 0.0) ? 1.0 : std::pow(10.0, decibels / 20.0);
+}
+
+int
+Settings::getSamplerSweepSize()
+{
+    // Sweeps are disabled by default.
+    int size = read("samplerSweepSize", 0).toInt();
+    return (size < 0) ? 0 : size;
+}
+
+int
+Settings::getSamplerXrunRetryCount()
+{
+    // Samples captured during xruns are kept by default.
+    int count = read("samplerXrunRetryCount", 0).toInt();
+    return (count < 0) ? 0 : count;
+}
+
 void
 Settings::handleStateChange(synthclone::SessionState state,
                             const QDir *directory)
@@ -79,6 +142,12 @@ Settings::handleStateChange(synthclone::SessionState state,
     }
 }
 
+bool
+Settings::isSampleHardLinkingEnabled()
+{
+    return read("sampleHardLinkingEnabled", false).toBool();
+}
+
 QVariant
 Settings::read(const QString &key, const QVariant &defaultValue)
 {
@@ -39,12 +39,36 @@ public:
     void
     addPluginPath(const QString &path);
 
+    int
+    getEffectJobThreadCount();
+
     QStringList
     getPluginPaths();
 
     QStringList
     getRecentSessionPaths();
 
+    qint64
+    getSampleMemoryBudget();
+
+    int
+    getSamplerRealtimePriority();
+
+    float
+    getSamplerSilenceHoldTime();
+
+    float
+    getSamplerSilenceThreshold();
+
+    int
+    getSamplerSweepSize();
+
+    int
+    getSamplerXrunRetryCount();
+
+    bool
+    isSampleHardLinkingEnabled();
+
     void
     removePluginPath(const QString &path);
 
@@ -1,54 +0,0 @@
-/*
- * synthclone - Synthesizer-cloning software
- * Copyright (C) 2011-2012 Devin Anderson
- *
- * This program is free software; you can redistribute it and/or modify it
- * under the terms of the GNU General Public License as published by the Free
- * Software Foundation; either version 2 of the License, or (at your option)
- * any later version.
- *
- * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
- * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
- * more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
- * Ave, Cambridge, MA 02139, USA.
- */
-
-#include "standarditem.h"
-
-StandardItem::StandardItem():
-    QStandardItem()
-{
-    // Empty
-}
-
-StandardItem::~StandardItem()
-{
-    // Empty
-}
-
-QStandardItem *
-StandardItem::clone() const
-{
-    return new StandardItem();
-}
-
-QVariant
-StandardItem::data(int role) const
-{
-    return role == Qt::EditRole ? editValue : QStandardItem::data(role);
-}
-
-void
-StandardItem::setData(const QVariant &value, int role)
-{
-    if (role != Qt::EditRole) {
-        QStandardItem::setData(value, role);
-    } else if (editValue != value) {
-        editValue = value;
-        emitDataChanged();
-    }
-}
@@ -1,49 +0,0 @@
-/*
- * synthclone - Synthesizer-cloning software
- * Copyright (C) 2011 Devin Anderson
- *
- * This program is free software; you can redistribute it and/or modify it
- * under the terms of the GNU General Public License as published by the Free
- * Software Foundation; either version 2 of the License, or (at your option)
- * any later version.
- *
- * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
- * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
- * more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * this program; if not, write to the Free Software Foundation, Inc., 675 Mass
- * Ave, Cambridge, MA 02139, USA.
- */
-
-#ifndef __STANDARDITEM_H__
-#define __STANDARDITEM_H__
-
-#include <QtGui/QStandardItem>
-
-class StandardItem: public QStandardItem {
-
-public:
-
-    explicit
-    StandardItem();
-
-    ~StandardItem();
-
-    QStandardItem *
-    clone() const;
-
-    QVariant
-    data(int role=Qt::UserRole + 1) const;
-
-    void
-    setData(const QVariant &value, int role=Qt::UserRole + 1);
-
-private:
-
-    QVariant editValue;
-
-};
-
-#endif
@@ -66,7 +66,6 @@ HEADERS += aboutview.h \
     sessionsampledata.h \
     sessionviewlet.h \
     settings.h \
-    standarditem.h \
     toolviewlet.h \
     types.h \
     util.h \
@@ -74,7 +73,6 @@ HEADERS += aboutview.h \
     zone.h \
     zonecomparer.h \
     zonecomparerproxy.h \
-    zoneindexcomparer.h \
     zonelistloader.h \
     zonetabledelegate.h \
     zonetablemodel.h \
@@ -121,14 +119,12 @@ SOURCES += aboutview.cpp \
     sessionsampledata.cpp \
     sessionviewlet.cpp \
     settings.cpp \
-    standarditem.cpp \
     toolviewlet.cpp \
     util.cpp \
     viewviewlet.cpp \
     zone.cpp \
     zonecomparer.cpp \
     zonecomparerproxy.cpp \
-    zoneindexcomparer.cpp \
     zonelistloader.cpp \
     zonetabledelegate.cpp \
     zonetablemodel.cpp \
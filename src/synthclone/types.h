@@ -44,8 +44,9 @@ enum ZoneTableColumn {
     ZONETABLECOLUMN_RELEASE_TIME = 135,
     ZONETABLECOLUMN_DRY_SAMPLE = 136,
     ZONETABLECOLUMN_WET_SAMPLE = 137,
+    ZONETABLECOLUMN_XRUN_COUNT = 138,
 
-    ZONETABLECOLUMN_BASE_TOTAL = 138
+    ZONETABLECOLUMN_BASE_TOTAL = 139
 };
 
 #endif
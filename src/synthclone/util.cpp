@@ -153,6 +153,7 @@ writeZone(QXmlStreamWriter &writer, Zone *zone, QDir *samplesDirectory,
     writer.writeAttribute("velocity", QString::number(uValue));
     writer.writeAttribute("wet-sample-stale",
                           zone->isWetSampleStale() ? "true" : "false");
+    writer.writeAttribute("xruns", QString::number(zone->getXrunCount()));
 
     const synthclone::Sample *drySample = zone->getDrySample();
     if (drySample) {
@@ -50,6 +50,7 @@ Zone::Zone(SessionSampleData &sessionSampleData, QObject *parent):
     velocity = 0x7f;
     wetSample = 0;
     wetSampleStale = true;
+    xrunCount = 0;
 }
 
 Zone::~Zone()
@@ -138,6 +139,12 @@ Zone::getWetSample() const
     return wetSample;
 }
 
+int
+Zone::getXrunCount() const
+{
+    return xrunCount;
+}
+
 void
 Zone::handleSessionSampleDataChange()
 {
@@ -371,6 +378,17 @@ Zone::setWetSampleStale(bool stale)
     }
 }
 
+void
+Zone::setXrunCount(int count)
+{
+    CONFIRM(count >= 0, tr("'%1': invalid xrun count").arg(count));
+
+    if (xrunCount != count) {
+        xrunCount = count;
+        emit xrunCountChanged(count);
+    }
+}
+
 void
 Zone::updateSampleRate(const synthclone::Sample &sample)
 {
@@ -73,6 +73,9 @@ public:
     const synthclone::Sample *
     getWetSample() const;
 
+    int
+    getXrunCount() const;
+
     bool
     isDrySampleStale() const;
 
@@ -126,6 +129,9 @@ public slots:
     void
     setWetSampleStale(bool stale);
 
+    void
+    setXrunCount(int count);
+
 private slots:
 
     void
@@ -150,6 +156,7 @@ private:
     synthclone::MIDIData velocity;
     synthclone::Sample *wetSample;
     bool wetSampleStale;
+    int xrunCount;
 
 };
 
@@ -26,7 +26,7 @@
 ZoneComparer::ZoneComparer(int property, QObject *parent):
     synthclone::ZoneComparer(parent)
 {
-    assert((property >= 0) && (property <= PROPERTY_CONTROL_127));
+    assert((property >= 0) && (property <= PROPERTY_XRUN_COUNT));
     this->property = property;
 }
 
@@ -100,6 +100,8 @@ ZoneComparer::isLessThan(const synthclone::Zone *zone1,
         return zone1->getVelocity() < zone2->getVelocity();
     case PROPERTY_WET_SAMPLE:
         return isLessThan(zone1->getWetSample(), zone2->getWetSample());
+    case PROPERTY_XRUN_COUNT:
+        return zone1->getXrunCount() < zone2->getXrunCount();
     }
     synthclone::MIDIData control =
         static_cast<synthclone::MIDIData>(property - PROPERTY_CONTROL_0);
@@ -43,7 +43,8 @@ public:
         PROPERTY_VELOCITY = 8,
         PROPERTY_WET_SAMPLE = 9,
         PROPERTY_CONTROL_0 = 10,
-        PROPERTY_CONTROL_127 = 137
+        PROPERTY_CONTROL_127 = 137,
+        PROPERTY_XRUN_COUNT = 138
     };
 
     ZoneComparer(int property, QObject *parent=0);
@@ -26,15 +26,15 @@ ZoneComparerProxy::ZoneComparerProxy(const ZoneComparerProxy &proxy,
     QObject(parent),
     comparer(proxy.comparer)
 {
-    // Empty
+    ascending = proxy.ascending;
 }
 
 ZoneComparerProxy::ZoneComparerProxy(const synthclone::ZoneComparer &comparer,
-                                     QObject *parent):
+                                     bool ascending, QObject *parent):
     QObject(parent),
     comparer(comparer)
 {
-    // Empty
+    this->ascending = ascending;
 }
 
 ZoneComparerProxy::~ZoneComparerProxy()
@@ -48,5 +48,6 @@ ZoneComparerProxy::operator()(const synthclone::Zone *zone1,
 {
     assert(zone1);
     assert(zone2);
-    return comparer.isLessThan(zone1, zone2);
+    return ascending ? comparer.isLessThan(zone1, zone2) :
+        comparer.isLessThan(zone2, zone1);
 }
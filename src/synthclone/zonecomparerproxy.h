@@ -32,7 +32,7 @@ public:
 
     explicit
     ZoneComparerProxy(const synthclone::ZoneComparer &comparer,
-                      QObject *parent=0);
+                      bool ascending=true, QObject *parent=0);
 
     ~ZoneComparerProxy();
 
@@ -42,6 +42,7 @@ public:
 
 private:
 
+    bool ascending;
     const synthclone::ZoneComparer &comparer;
 
 };
@@ -53,6 +53,7 @@ ZoneListLoader::loadZones(QDomElement &element, int startIndex,
     int elementCount = element.elementsByTagName("zone").count();
     int i;
     QString message;
+    session.beginZoneBatch();
     for (i = 0, element = element.firstChildElement("zone"); ! element.isNull();
          element = element.nextSiblingElement("zone"), i++) {
         emit loadingZone(i + 1, elementCount);
@@ -111,6 +112,11 @@ ZoneListLoader::loadZones(QDomElement &element, int startIndex,
                                                        "wet-sample-stale",
                                                        false));
 
+        int xrunCount;
+        if (verifyCountAttribute(element, "xruns", xrunCount)) {
+            zone->setXrunCount(xrunCount);
+        }
+
         QDomElement subElement = element.firstChildElement("controls");
         if (subElement.isNull()) {
             message = "'zone' element has no 'controls' element";
@@ -127,6 +133,7 @@ ZoneListLoader::loadZones(QDomElement &element, int startIndex,
             }
         }
     }
+    session.endZoneBatch();
 }
 
 bool
@@ -141,6 +148,28 @@ ZoneListLoader::verifyBooleanAttribute(const QDomElement &element,
     return defaultValue;
 }
 
+bool
+ZoneListLoader::verifyCountAttribute(const QDomElement &element,
+                                     const QString &name, int &count)
+{
+    // Count attributes are optional, as older sessions don't contain them.
+    QString strValue = element.attribute(name);
+    if (strValue.isEmpty()) {
+        return false;
+    }
+    bool success;
+    int value = strValue.toInt(&success);
+    if (! (success && (value >= 0))) {
+        QString message =
+            qApp->tr("'%1' element contains invalid '%2' attribute").
+            arg(element.tagName(), name);
+        emitWarning(element, message);
+        return false;
+    }
+    count = value;
+    return true;
+}
+
 bool
 ZoneListLoader::verifyMIDIAttribute(const QDomElement &element,
                                     const QString &name,
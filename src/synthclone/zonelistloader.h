@@ -53,6 +53,10 @@ private:
     verifyBooleanAttribute(const QDomElement &element, const QString &name,
                            bool defaultValue);
 
+    bool
+    verifyCountAttribute(const QDomElement &element, const QString &name,
+                         int &count);
+
     bool
     verifyMIDIAttribute(const QDomElement &element, const QString &name,
                         synthclone::MIDIData &value, bool required=true,
@@ -24,6 +24,7 @@
 #include <QtGui/QLinearGradient>
 #include <QtGui/QPainter>
 #include <QtGui/QPainterPath>
+#include <QtGui/QPixmapCache>
 
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QDoubleSpinBox>
@@ -69,6 +70,7 @@ ZoneTableDelegate::createEditor(QWidget *parent,
     case ZONETABLECOLUMN_DRY_SAMPLE:
     case ZONETABLECOLUMN_STATUS:
     case ZONETABLECOLUMN_WET_SAMPLE:
+    case ZONETABLECOLUMN_XRUN_COUNT:
         // This shouldn't happen.
         assert(false);
     case ZONETABLECOLUMN_NOTE:
@@ -111,82 +113,23 @@ ZoneTableDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
         variant = index.data(Qt::UserRole);
         if (variant.isValid()) {
             QRect rectangle = option.rect;
-            int height = rectangle.height();
-            int width = rectangle.width();
-            if (height && width) {
-                float midHeight = height / 2.0;
-                QVariantMap variantMap = variant.toMap();
-                QVariantList peaks = variantMap.value("peaks").toList();
-                assert(peaks.count() == 1024);
-                float time = variantMap.value("time").toFloat();
+            if (rectangle.height() && rectangle.width()) {
+                ZoneTableSampleProfile profile =
+                    variant.value<ZoneTableSampleProfile>();
 
-                // Set the operations for drawing the sample.
-                float dBFSFloor = -96.0;
-                float maximumDBFS = dBFSFloor;
-                QPainterPath maximumPath(QPointF(0.0, midHeight));
-                QPainterPath minimumPath(QPointF(0.0, midHeight));
-                for (int i = 0; i < 1024; i++) {
-                    float pixelX = (i / 1023.0) * (width - 1);
-                    float value = peaks[i].toFloat();
-                    if (value > 0.0) {
-                        value = 0.0;
-                    } else if (value < dBFSFloor) {
-                        value = dBFSFloor;
-                    }
-                    float sampleHeight = ((value + (-dBFSFloor)) /
-                                          (-dBFSFloor)) * midHeight;
-                    maximumPath.lineTo(pixelX, midHeight - sampleHeight);
-                    minimumPath.lineTo(pixelX, midHeight + sampleHeight);
-                    if (value > maximumDBFS) {
-                        maximumDBFS = value;
-                    }
+                // Rendered profiles are cached by profile key, cell size, and
+                // palette.  The model gives a profile a new key when its data
+                // changes, so stale renderings are never found again, and
+                // eventually fall out of the cache.
+                QString key = QString("synthclone-sample-profile-%1-%2x%3-%4").
+                    arg(profile.key).arg(rectangle.width()).
+                    arg(rectangle.height()).arg(option.palette.cacheKey());
+                QPixmap pixmap;
+                if (! QPixmapCache::find(key, &pixmap)) {
+                    pixmap = renderSampleProfile(profile, rectangle.size(),
+                                                 option.palette);
+                    QPixmapCache::insert(key, pixmap);
                 }
-                maximumPath.lineTo(width - 1, midHeight);
-                minimumPath.lineTo(width - 1, midHeight);
-                maximumPath.addPath(minimumPath.toReversed());
-
-                // Create the off-screen pixmap that we'll draw on.
-                QPixmap pixmap(width, height);
-                QPainter pixmapPainter;
-                QPalette palette = option.palette;
-                pixmap.fill(Qt::transparent);
-                pixmapPainter.begin(&pixmap);
-
-                // Draw the waveform.
-                QLinearGradient gradient(0, 0, 0, height);
-                QColor insideColor = palette.color(QPalette::Text);
-                QColor outsideColor = palette.color(QPalette::Text);
-                insideColor.setAlpha(0x10);
-                outsideColor.setAlpha(0xf0);
-                float maximumHeight = ((maximumDBFS + (-dBFSFloor)) /
-                                       (-dBFSFloor)) * midHeight;
-                gradient.setColorAt((midHeight - maximumHeight) / height,
-                                    outsideColor);
-                gradient.setColorAt(0.5, insideColor);
-                gradient.setColorAt((midHeight + maximumHeight) / height,
-                                    outsideColor);
-                gradient.setSpread(QLinearGradient::ReflectSpread);
-                pixmapPainter.fillPath(maximumPath, gradient);
-
-                // Write the sample time.
-                QString timeString = tr("%1 seconds").
-                    arg(QLocale::system().toString(time));
-                QRect pixmapRectangle = pixmap.rect();
-                int flags = Qt::AlignHCenter | Qt::AlignVCenter;
-                QFont font(pixmapPainter.font());
-                pixmapPainter.setFont(font);
-                QRect textRectangle =
-                    pixmapPainter.boundingRect(pixmapRectangle, flags,
-                                               timeString);
-                QRect borderRectangle = textRectangle.adjusted(-1, -1, 1, 1);
-                QColor baseColor = palette.color(QPalette::Base);
-                baseColor.setAlpha(0xb8);
-
-                pixmapPainter.fillRect(borderRectangle, baseColor);
-                pixmapPainter.drawText(pixmapRectangle, flags, timeString);
-                pixmapPainter.drawRect(borderRectangle);
-
-                pixmapPainter.end();
 
                 painter->save();
                 painter->drawPixmap(rectangle.topLeft(), pixmap);
@@ -196,6 +139,85 @@ ZoneTableDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
     }
 }
 
+QPixmap
+ZoneTableDelegate::renderSampleProfile(const ZoneTableSampleProfile &profile,
+                                       const QSize &size,
+                                       const QPalette &palette) const
+{
+    int height = size.height();
+    int width = size.width();
+    float midHeight = height / 2.0;
+    const QVector<float> &peaks = profile.peaks;
+    int peakCount = peaks.count();
+    assert(peakCount == 1024);
+    const float *peakData = peaks.constData();
+
+    // Set the operations for drawing the sample.
+    float dBFSFloor = -96.0;
+    float maximumDBFS = dBFSFloor;
+    QPainterPath maximumPath(QPointF(0.0, midHeight));
+    QPainterPath minimumPath(QPointF(0.0, midHeight));
+    for (int i = 0; i < peakCount; i++) {
+        float pixelX = (i / static_cast<float>(peakCount - 1)) * (width - 1);
+        float value = peakData[i];
+        if (value > 0.0) {
+            value = 0.0;
+        } else if (value < dBFSFloor) {
+            value = dBFSFloor;
+        }
+        float sampleHeight = ((value + (-dBFSFloor)) / (-dBFSFloor)) *
+            midHeight;
+        maximumPath.lineTo(pixelX, midHeight - sampleHeight);
+        minimumPath.lineTo(pixelX, midHeight + sampleHeight);
+        if (value > maximumDBFS) {
+            maximumDBFS = value;
+        }
+    }
+    maximumPath.lineTo(width - 1, midHeight);
+    minimumPath.lineTo(width - 1, midHeight);
+    maximumPath.addPath(minimumPath.toReversed());
+
+    // Create the off-screen pixmap that we'll draw on.
+    QPixmap pixmap(width, height);
+    QPainter pixmapPainter;
+    pixmap.fill(Qt::transparent);
+    pixmapPainter.begin(&pixmap);
+
+    // Draw the waveform.
+    QLinearGradient gradient(0, 0, 0, height);
+    QColor insideColor = palette.color(QPalette::Text);
+    QColor outsideColor = palette.color(QPalette::Text);
+    insideColor.setAlpha(0x10);
+    outsideColor.setAlpha(0xf0);
+    float maximumHeight = ((maximumDBFS + (-dBFSFloor)) / (-dBFSFloor)) *
+        midHeight;
+    gradient.setColorAt((midHeight - maximumHeight) / height, outsideColor);
+    gradient.setColorAt(0.5, insideColor);
+    gradient.setColorAt((midHeight + maximumHeight) / height, outsideColor);
+    gradient.setSpread(QLinearGradient::ReflectSpread);
+    pixmapPainter.fillPath(maximumPath, gradient);
+
+    // Write the sample time.
+    QString timeString = tr("%1 seconds").
+        arg(QLocale::system().toString(profile.time));
+    QRect pixmapRectangle = pixmap.rect();
+    int flags = Qt::AlignHCenter | Qt::AlignVCenter;
+    QFont font(pixmapPainter.font());
+    pixmapPainter.setFont(font);
+    QRect textRectangle =
+        pixmapPainter.boundingRect(pixmapRectangle, flags, timeString);
+    QRect borderRectangle = textRectangle.adjusted(-1, -1, 1, 1);
+    QColor baseColor = palette.color(QPalette::Base);
+    baseColor.setAlpha(0xb8);
+
+    pixmapPainter.fillRect(borderRectangle, baseColor);
+    pixmapPainter.drawText(pixmapRectangle, flags, timeString);
+    pixmapPainter.drawRect(borderRectangle);
+
+    pixmapPainter.end();
+    return pixmap;
+}
+
 void
 ZoneTableDelegate::setEditorData(QWidget *editor,
                                  const QModelIndex &index) const
@@ -221,6 +243,7 @@ ZoneTableDelegate::setEditorData(QWidget *editor,
     case ZONETABLECOLUMN_DRY_SAMPLE:
     case ZONETABLECOLUMN_STATUS:
     case ZONETABLECOLUMN_WET_SAMPLE:
+    case ZONETABLECOLUMN_XRUN_COUNT:
         // This shouldn't happen.
         assert(false);
     case ZONETABLECOLUMN_NOTE:
@@ -266,6 +289,7 @@ ZoneTableDelegate::setModelData(QWidget *editor, QAbstractItemModel */*model*/,
     case ZONETABLECOLUMN_DRY_SAMPLE:
     case ZONETABLECOLUMN_STATUS:
     case ZONETABLECOLUMN_WET_SAMPLE:
+    case ZONETABLECOLUMN_XRUN_COUNT:
         // This shouldn't happen.
         assert(false);
     case ZONETABLECOLUMN_NOTE:
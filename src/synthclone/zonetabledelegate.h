@@ -24,6 +24,8 @@
 
 #include <synthclone/types.h>
 
+#include "zonetablemodel.h"
+
 class ZoneTableDelegate: public QStyledItemDelegate {
 
     Q_OBJECT
@@ -88,6 +90,10 @@ signals:
 
 private:
 
+    QPixmap
+    renderSampleProfile(const ZoneTableSampleProfile &profile,
+                        const QSize &size, const QPalette &palette) const;
+
     mutable QModelIndex editIndex;
 
 };
@@ -17,17 +17,552 @@
  * Ave, Cambridge, MA 02139, USA.
  */
 
+#include <cassert>
+
+#include <QtCore/QVariant>
+
+#include <synthclone/util.h>
+
+#include "types.h"
 #include "zonetablemodel.h"
 
+// Static data
+
+// Source of the keys that identify rendered sample profiles.  A profile gets a
+// new key whenever its data changes, so a key is never reused for different
+// data.
+static quint64 lastSampleProfileKey = 0;
+
 ZoneTableModel::ZoneTableModel(QObject *parent):
-    QStandardItemModel(parent)
+    QAbstractTableModel(parent),
+    lockedPixmap(":/synthclone/images/16x16/locked.png")
 {
     // Empty
 }
 
 ZoneTableModel::~ZoneTableModel()
 {
-    // Empty
+    qDeleteAll(zoneDataList);
+}
+
+int
+ZoneTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ZONETABLECOLUMN_BASE_TOTAL;
+}
+
+ZoneTableModel::ZoneData *
+ZoneTableModel::createZoneData()
+{
+    // The defaults match the defaults of a new zone.
+    ZoneData *data = new ZoneData();
+    data->aftertouch = synthclone::MIDI_VALUE_NOT_SET;
+    data->channel = 1;
+    data->channelPressure = synthclone::MIDI_VALUE_NOT_SET;
+    for (int i = 0; i < 0x80; i++) {
+        data->controlValues[i] = synthclone::MIDI_VALUE_NOT_SET;
+    }
+    data->drySampleProfile.key = 0;
+    data->drySampleProfile.time = 0.0;
+    data->drySampleStale = true;
+    data->note = 60;
+    data->releaseTime = 1.0;
+    data->sampleTime = 5.0;
+    data->status = synthclone::Zone::STATUS_NORMAL;
+    data->velocity = 0x7f;
+    data->wetSampleProfile.key = 0;
+    data->wetSampleProfile.time = 0.0;
+    data->wetSampleStale = true;
+    data->xrunCount = 0;
+    return data;
+}
+
+QVariant
+ZoneTableModel::data(const QModelIndex &index, int role) const
+{
+    if (! index.isValid()) {
+        return QVariant();
+    }
+    int column = index.column();
+    const ZoneData *data = zoneDataList[index.row()];
+    switch (role) {
+    case Qt::BackgroundRole:
+        switch (column) {
+        case ZONETABLECOLUMN_DRY_SAMPLE:
+            return data->drySampleStale ? palette.alternateBase() :
+                palette.base();
+        case ZONETABLECOLUMN_WET_SAMPLE:
+            return data->wetSampleStale ? palette.alternateBase() :
+                palette.base();
+        }
+        break;
+    case Qt::DecorationRole:
+        if ((column == ZONETABLECOLUMN_STATUS) &&
+            (data->status != synthclone::Zone::STATUS_NORMAL)) {
+            return lockedPixmap;
+        }
+        break;
+    case Qt::DisplayRole:
+        return getDisplayData(data, column);
+    case Qt::EditRole:
+        return getEditData(data, column);
+    case Qt::UserRole:
+        switch (column) {
+        case ZONETABLECOLUMN_DRY_SAMPLE:
+            return getSampleProfileData(data->drySampleProfile);
+        case ZONETABLECOLUMN_WET_SAMPLE:
+            return getSampleProfileData(data->wetSampleProfile);
+        }
+    }
+    return QVariant();
+}
+
+void
+ZoneTableModel::emitCellChanged(int row, int column)
+{
+    QModelIndex cellIndex = index(row, column);
+    emit dataChanged(cellIndex, cellIndex);
+}
+
+Qt::ItemFlags
+ZoneTableModel::flags(const QModelIndex &index) const
+{
+    if (! index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (zoneDataList[index.row()]->status ==
+        synthclone::Zone::STATUS_NORMAL) {
+        switch (index.column()) {
+        case ZONETABLECOLUMN_DRY_SAMPLE:
+        case ZONETABLECOLUMN_STATUS:
+        case ZONETABLECOLUMN_WET_SAMPLE:
+        case ZONETABLECOLUMN_XRUN_COUNT:
+            break;
+        default:
+            flags |= Qt::ItemIsEditable;
+        }
+    }
+    return flags;
+}
+
+QVariant
+ZoneTableModel::getDisplayData(const ZoneData *data, int column) const
+{
+    switch (column) {
+    case ZONETABLECOLUMN_AFTERTOUCH:
+        return getMIDIValueDisplayData(data->aftertouch);
+    case ZONETABLECOLUMN_CHANNEL:
+        return static_cast<int>(data->channel);
+    case ZONETABLECOLUMN_CHANNEL_PRESSURE:
+        return getMIDIValueDisplayData(data->channelPressure);
+    case ZONETABLECOLUMN_DRY_SAMPLE:
+    case ZONETABLECOLUMN_WET_SAMPLE:
+        return QVariant();
+    case ZONETABLECOLUMN_NOTE:
+        return synthclone::getMIDINoteString(data->note);
+    case ZONETABLECOLUMN_RELEASE_TIME:
+        return tr("%1 seconds").arg(data->releaseTime);
+    case ZONETABLECOLUMN_SAMPLE_TIME:
+        return tr("%1 seconds").arg(data->sampleTime);
+    case ZONETABLECOLUMN_STATUS:
+        return getStatusString(data->status);
+    case ZONETABLECOLUMN_VELOCITY:
+        return static_cast<int>(data->velocity);
+    case ZONETABLECOLUMN_XRUN_COUNT:
+        return data->xrunCount;
+    }
+    return getMIDIValueDisplayData
+        (data->controlValues[column - ZONETABLECOLUMN_CONTROL_0]);
+}
+
+QVariant
+ZoneTableModel::getEditData(const ZoneData *data, int column) const
+{
+    switch (column) {
+    case ZONETABLECOLUMN_AFTERTOUCH:
+        return static_cast<int>(data->aftertouch);
+    case ZONETABLECOLUMN_CHANNEL:
+        return static_cast<int>(data->channel);
+    case ZONETABLECOLUMN_CHANNEL_PRESSURE:
+        return static_cast<int>(data->channelPressure);
+    case ZONETABLECOLUMN_DRY_SAMPLE:
+    case ZONETABLECOLUMN_STATUS:
+    case ZONETABLECOLUMN_WET_SAMPLE:
+        return QVariant();
+    case ZONETABLECOLUMN_NOTE:
+        return static_cast<int>(data->note);
+    case ZONETABLECOLUMN_RELEASE_TIME:
+        return data->releaseTime;
+    case ZONETABLECOLUMN_SAMPLE_TIME:
+        return data->sampleTime;
+    case ZONETABLECOLUMN_VELOCITY:
+        return static_cast<int>(data->velocity);
+    case ZONETABLECOLUMN_XRUN_COUNT:
+        return data->xrunCount;
+    }
+    return static_cast<int>
+        (data->controlValues[column - ZONETABLECOLUMN_CONTROL_0]);
+}
+
+QVariant
+ZoneTableModel::getMIDIValueDisplayData(synthclone::MIDIData value) const
+{
+    if (value == synthclone::MIDI_VALUE_NOT_SET) {
+        return tr("(not set)");
+    }
+    return static_cast<int>(value);
+}
+
+QVariant
+ZoneTableModel::getSampleProfileData(const ZoneTableSampleProfile &data) const
+{
+    // The peak vector is implicitly shared, so this doesn't copy the peaks.
+    return data.peaks.isEmpty() ? QVariant() : QVariant::fromValue(data);
+}
+
+QString
+ZoneTableModel::getStatusString(synthclone::Zone::Status status) const
+{
+    switch (status) {
+    case synthclone::Zone::STATUS_EFFECT_JOB_QUEUE:
+        return tr("In effect job queue ...");
+    case synthclone::Zone::STATUS_EFFECTS:
+        return tr("Applying effects ...");
+    case synthclone::Zone::STATUS_NORMAL:
+        break;
+    case synthclone::Zone::STATUS_SAMPLER_PLAYING_DRY_SAMPLE:
+        return tr("Playing dry sample ...");
+    case synthclone::Zone::STATUS_SAMPLER_PLAYING_WET_SAMPLE:
+        return tr("Playing wet sample ...");
+    case synthclone::Zone::STATUS_SAMPLER_SAMPLING:
+        return tr("Sampling ...");
+    case synthclone::Zone::STATUS_SAMPLER_JOB_QUEUE:
+        return tr("In sampler job queue ...");
+    case synthclone::Zone::STATUS_TARGETS:
+        return tr("Building targets ...");
+    }
+    return QString();
+}
+
+ZoneTableModel::ZoneData *
+ZoneTableModel::getZoneData(int row)
+{
+    assert((row >= 0) && (row < zoneDataList.count()));
+    return zoneDataList[row];
+}
+
+QVariant
+ZoneTableModel::headerData(int section, Qt::Orientation orientation,
+                           int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case ZONETABLECOLUMN_AFTERTOUCH:
+        return tr("Aftertouch");
+    case ZONETABLECOLUMN_CHANNEL:
+        return tr("Channel");
+    case ZONETABLECOLUMN_CHANNEL_PRESSURE:
+        return tr("Channel Pressure");
+    case ZONETABLECOLUMN_DRY_SAMPLE:
+        return tr("Dry Sample");
+    case ZONETABLECOLUMN_NOTE:
+        return tr("Note");
+    case ZONETABLECOLUMN_RELEASE_TIME:
+        return tr("Release Time");
+    case ZONETABLECOLUMN_SAMPLE_TIME:
+        return tr("Sample Time");
+    case ZONETABLECOLUMN_STATUS:
+        return tr("Status");
+    case ZONETABLECOLUMN_VELOCITY:
+        return tr("Velocity");
+    case ZONETABLECOLUMN_WET_SAMPLE:
+        return tr("Wet Sample");
+    case ZONETABLECOLUMN_XRUN_COUNT:
+        return tr("Xruns");
+    }
+    return synthclone::getMIDIControlString
+        (static_cast<synthclone::MIDIData>
+         (section - ZONETABLECOLUMN_CONTROL_0));
+}
+
+bool
+ZoneTableModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || (row < 0) || (row > zoneDataList.count()) ||
+        (count < 1)) {
+        return false;
+    }
+    beginInsertRows(parent, row, row + count - 1);
+    for (int i = 0; i < count; i++) {
+        zoneDataList.insert(row, createZoneData());
+    }
+    endInsertRows();
+    return true;
+}
+
+bool
+ZoneTableModel::moveRows(const QModelIndex &sourceParent, int sourceRow,
+                         int count, const QModelIndex &destinationParent,
+                         int destinationChild)
+{
+    int lastRow = sourceRow + count - 1;
+    if (sourceParent.isValid() || destinationParent.isValid() ||
+        (sourceRow < 0) || (count < 1) || (lastRow >= zoneDataList.count()) ||
+        (destinationChild < 0) ||
+        (destinationChild > zoneDataList.count()) ||
+        (! beginMoveRows(sourceParent, sourceRow, lastRow, destinationParent,
+                         destinationChild))) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (destinationChild > sourceRow) {
+            zoneDataList.move(sourceRow, destinationChild - 1);
+        } else {
+            zoneDataList.move(sourceRow + i, destinationChild + i);
+        }
+    }
+    endMoveRows();
+    return true;
+}
+
+bool
+ZoneTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || (row < 0) || (count < 1) ||
+        ((row + count) > zoneDataList.count())) {
+        return false;
+    }
+    beginRemoveRows(parent, row, row + count - 1);
+    for (int i = 0; i < count; i++) {
+        delete zoneDataList.takeAt(row);
+    }
+    endRemoveRows();
+    return true;
+}
+
+void
+ZoneTableModel::reorderRows(const QList<int> &indexes)
+{
+    int rows = zoneDataList.count();
+    assert(indexes.count() == rows);
+
+    // Views are told about the new order with a single layout change.
+    // Moving the rows one at a time would notify views of every
+    // intermediate order.
+    emit layoutAboutToBeChanged();
+    ZoneDataList reorderedList;
+    reorderedList.reserve(rows);
+    QVector<int> newRows(rows);
+    int i;
+    for (i = 0; i < rows; i++) {
+        int oldRow = indexes[i];
+        assert((oldRow >= 0) && (oldRow < rows));
+        newRows[oldRow] = i;
+        reorderedList.append(zoneDataList[oldRow]);
+    }
+    zoneDataList = reorderedList;
+
+    QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    for (i = 0; i < oldIndexes.count(); i++) {
+        const QModelIndex &oldIndex = oldIndexes[i];
+        newIndexes.append(index(newRows[oldIndex.row()], oldIndex.column()));
+    }
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged();
+}
+
+void
+ZoneTableModel::resetRows(int count)
+{
+    assert(count >= 0);
+    beginResetModel();
+    qDeleteAll(zoneDataList);
+    zoneDataList.clear();
+    zoneDataList.reserve(count);
+    for (int i = 0; i < count; i++) {
+        zoneDataList.append(createZoneData());
+    }
+    endResetModel();
+}
+
+int
+ZoneTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : zoneDataList.count();
+}
+
+void
+ZoneTableModel::setAftertouch(int row, synthclone::MIDIData aftertouch)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->aftertouch != aftertouch) {
+        data->aftertouch = aftertouch;
+        emitCellChanged(row, ZONETABLECOLUMN_AFTERTOUCH);
+    }
+}
+
+void
+ZoneTableModel::setChannel(int row, synthclone::MIDIData channel)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->channel != channel) {
+        data->channel = channel;
+        emitCellChanged(row, ZONETABLECOLUMN_CHANNEL);
+    }
+}
+
+void
+ZoneTableModel::setChannelPressure(int row, synthclone::MIDIData pressure)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->channelPressure != pressure) {
+        data->channelPressure = pressure;
+        emitCellChanged(row, ZONETABLECOLUMN_CHANNEL_PRESSURE);
+    }
+}
+
+void
+ZoneTableModel::setControlValue(int row, synthclone::MIDIData control,
+                                synthclone::MIDIData value)
+{
+    assert(control < 0x80);
+    ZoneData *data = getZoneData(row);
+    if (data->controlValues[control] != value) {
+        data->controlValues[control] = value;
+        emitCellChanged(row,
+                        ZONETABLECOLUMN_CONTROL_0 + static_cast<int>(control));
+    }
+}
+
+void
+ZoneTableModel::setDrySampleProfile(int row, const SampleProfile *profile)
+{
+    setSampleProfileData(getZoneData(row)->drySampleProfile, profile);
+    emitCellChanged(row, ZONETABLECOLUMN_DRY_SAMPLE);
+}
+
+void
+ZoneTableModel::setDrySampleStale(int row, bool stale)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->drySampleStale != stale) {
+        data->drySampleStale = stale;
+        emitCellChanged(row, ZONETABLECOLUMN_DRY_SAMPLE);
+    }
+}
+
+void
+ZoneTableModel::setNote(int row, synthclone::MIDIData note)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->note != note) {
+        data->note = note;
+        emitCellChanged(row, ZONETABLECOLUMN_NOTE);
+    }
+}
+
+void
+ZoneTableModel::setPalette(const QPalette &palette)
+{
+    this->palette = palette;
+    int rows = zoneDataList.count();
+    if (rows) {
+        emit dataChanged(index(0, ZONETABLECOLUMN_DRY_SAMPLE),
+                         index(rows - 1, ZONETABLECOLUMN_WET_SAMPLE));
+    }
+}
+
+void
+ZoneTableModel::setReleaseTime(int row, synthclone::SampleTime releaseTime)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->releaseTime != releaseTime) {
+        data->releaseTime = releaseTime;
+        emitCellChanged(row, ZONETABLECOLUMN_RELEASE_TIME);
+    }
+}
+
+void
+ZoneTableModel::setSampleProfileData(ZoneTableSampleProfile &data,
+                                     const SampleProfile *profile)
+{
+    if (! profile) {
+        data.key = 0;
+        data.peaks.clear();
+        data.time = 0.0;
+        return;
+    }
+    data.key = ++lastSampleProfileKey;
+    const float *peaks = profile->getPeaks();
+    data.peaks.resize(1024);
+    for (int i = 0; i < 1024; i++) {
+        data.peaks[i] = peaks[i] < -128.0 ? -128.0 : peaks[i];
+    }
+    data.time = profile->getTime();
+}
+
+void
+ZoneTableModel::setSampleTime(int row, synthclone::SampleTime sampleTime)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->sampleTime != sampleTime) {
+        data->sampleTime = sampleTime;
+        emitCellChanged(row, ZONETABLECOLUMN_SAMPLE_TIME);
+    }
+}
+
+void
+ZoneTableModel::setStatus(int row, synthclone::Zone::Status status)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->status != status) {
+        data->status = status;
+
+        // The status affects the flags of every cell in the row.
+        emit dataChanged(index(row, 0),
+                         index(row, ZONETABLECOLUMN_BASE_TOTAL - 1));
+    }
+}
+
+void
+ZoneTableModel::setVelocity(int row, synthclone::MIDIData velocity)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->velocity != velocity) {
+        data->velocity = velocity;
+        emitCellChanged(row, ZONETABLECOLUMN_VELOCITY);
+    }
+}
+
+void
+ZoneTableModel::setWetSampleProfile(int row, const SampleProfile *profile)
+{
+    setSampleProfileData(getZoneData(row)->wetSampleProfile, profile);
+    emitCellChanged(row, ZONETABLECOLUMN_WET_SAMPLE);
+}
+
+void
+ZoneTableModel::setWetSampleStale(int row, bool stale)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->wetSampleStale != stale) {
+        data->wetSampleStale = stale;
+        emitCellChanged(row, ZONETABLECOLUMN_WET_SAMPLE);
+    }
+}
+
+void
+ZoneTableModel::setXrunCount(int row, int count)
+{
+    ZoneData *data = getZoneData(row);
+    if (data->xrunCount != count) {
+        data->xrunCount = count;
+        emitCellChanged(row, ZONETABLECOLUMN_XRUN_COUNT);
+    }
 }
 
 void
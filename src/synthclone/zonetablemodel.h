@@ -20,9 +20,27 @@
 #ifndef __ZONETABLEMODEL_H__
 #define __ZONETABLEMODEL_H__
 
-#include <QtGui/QStandardItemModel>
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
 
-class ZoneTableModel: public QStandardItemModel {
+#include <QtGui/QPalette>
+#include <QtGui/QPixmap>
+
+#include <synthclone/types.h>
+#include <synthclone/zone.h>
+
+#include "sampleprofile.h"
+
+struct ZoneTableSampleProfile {
+    quint64 key;
+    QVector<float> peaks;
+    float time;
+};
+
+Q_DECLARE_METATYPE(ZoneTableSampleProfile)
+
+class ZoneTableModel: public QAbstractTableModel {
 
     Q_OBJECT
 
@@ -33,6 +51,84 @@ public:
 
     ~ZoneTableModel();
 
+    int
+    columnCount(const QModelIndex &parent=QModelIndex()) const;
+
+    QVariant
+    data(const QModelIndex &index, int role=Qt::DisplayRole) const;
+
+    Qt::ItemFlags
+    flags(const QModelIndex &index) const;
+
+    QVariant
+    headerData(int section, Qt::Orientation orientation,
+               int role=Qt::DisplayRole) const;
+
+    bool
+    insertRows(int row, int count, const QModelIndex &parent=QModelIndex());
+
+    bool
+    moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+             const QModelIndex &destinationParent, int destinationChild);
+
+    bool
+    removeRows(int row, int count, const QModelIndex &parent=QModelIndex());
+
+    void
+    reorderRows(const QList<int> &indexes);
+
+    void
+    resetRows(int count);
+
+    int
+    rowCount(const QModelIndex &parent=QModelIndex()) const;
+
+    void
+    setAftertouch(int row, synthclone::MIDIData aftertouch);
+
+    void
+    setChannel(int row, synthclone::MIDIData channel);
+
+    void
+    setChannelPressure(int row, synthclone::MIDIData pressure);
+
+    void
+    setControlValue(int row, synthclone::MIDIData control,
+                    synthclone::MIDIData value);
+
+    void
+    setDrySampleProfile(int row, const SampleProfile *profile);
+
+    void
+    setDrySampleStale(int row, bool stale);
+
+    void
+    setNote(int row, synthclone::MIDIData note);
+
+    void
+    setPalette(const QPalette &palette);
+
+    void
+    setReleaseTime(int row, synthclone::SampleTime releaseTime);
+
+    void
+    setSampleTime(int row, synthclone::SampleTime sampleTime);
+
+    void
+    setStatus(int row, synthclone::Zone::Status status);
+
+    void
+    setVelocity(int row, synthclone::MIDIData velocity);
+
+    void
+    setWetSampleProfile(int row, const SampleProfile *profile);
+
+    void
+    setWetSampleStale(int row, bool stale);
+
+    void
+    setXrunCount(int row, int count);
+
     void
     sort(int column, Qt::SortOrder order=Qt::AscendingOrder);
 
@@ -41,6 +137,59 @@ signals:
     void
     sortRequest(int column, bool ascending);
 
+private:
+
+    struct ZoneData {
+        synthclone::MIDIData aftertouch;
+        synthclone::MIDIData channel;
+        synthclone::MIDIData channelPressure;
+        synthclone::MIDIData controlValues[0x80];
+        ZoneTableSampleProfile drySampleProfile;
+        bool drySampleStale;
+        synthclone::MIDIData note;
+        synthclone::SampleTime releaseTime;
+        synthclone::SampleTime sampleTime;
+        synthclone::Zone::Status status;
+        synthclone::MIDIData velocity;
+        ZoneTableSampleProfile wetSampleProfile;
+        bool wetSampleStale;
+        int xrunCount;
+    };
+
+    typedef QList<ZoneData *> ZoneDataList;
+
+    static ZoneData *
+    createZoneData();
+
+    static void
+    setSampleProfileData(ZoneTableSampleProfile &data,
+                         const SampleProfile *profile);
+
+    void
+    emitCellChanged(int row, int column);
+
+    QVariant
+    getDisplayData(const ZoneData *data, int column) const;
+
+    QVariant
+    getEditData(const ZoneData *data, int column) const;
+
+    QVariant
+    getMIDIValueDisplayData(synthclone::MIDIData value) const;
+
+    QVariant
+    getSampleProfileData(const ZoneTableSampleProfile &data) const;
+
+    QString
+    getStatusString(synthclone::Zone::Status status) const;
+
+    ZoneData *
+    getZoneData(int row);
+
+    QPixmap lockedPixmap;
+    QPalette palette;
+    ZoneDataList zoneDataList;
+
 };
 
 #endif
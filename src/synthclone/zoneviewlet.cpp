@@ -132,6 +132,8 @@ ZoneViewlet::ZoneViewlet(QMainWindow *mainWindow, QObject *parent):
                                "velocityColumnShowAction");
     initializeColumnShowAction(mainWindow, ZONETABLECOLUMN_WET_SAMPLE,
                                "wetSampleColumnShowAction");
+    initializeColumnShowAction(mainWindow, ZONETABLECOLUMN_XRUN_COUNT,
+                               "xrunCountColumnShowAction");
     initializeControlColumnShowActions("controlColumnsMenu1", 0, 0x10);
     initializeControlColumnShowActions("controlColumnsMenu2", 0x10, 0x20);
     initializeControlColumnShowActions("controlColumnsMenu3", 0x20, 0x30);
@@ -172,43 +174,14 @@ ZoneViewlet::ZoneViewlet(QMainWindow *mainWindow, QObject *parent):
             SIGNAL(velocityChangeRequest(int, synthclone::MIDIData)),
             SIGNAL(velocityChangeRequest(int, synthclone::MIDIData)));
 
-    itemPrototype = new StandardItem();
     connect(&tableModel, SIGNAL(sortRequest(int, bool)),
             SLOT(handleSortRequest(int, bool)));
-    tableModel.setColumnCount(ZONETABLECOLUMN_BASE_TOTAL);
-    tableModel.setRowCount(0);
-    tableModel.setItemPrototype(itemPrototype);
-    tableModel.setHeaderData(ZONETABLECOLUMN_AFTERTOUCH, Qt::Horizontal,
-                             tr("Aftertouch"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_CHANNEL, Qt::Horizontal,
-                             tr("Channel"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_CHANNEL_PRESSURE, Qt::Horizontal,
-                             tr("Channel Pressure"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_DRY_SAMPLE, Qt::Horizontal,
-                             tr("Dry Sample"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_NOTE, Qt::Horizontal,
-                             tr("Note"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_RELEASE_TIME, Qt::Horizontal,
-                             tr("Release Time"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_SAMPLE_TIME, Qt::Horizontal,
-                             tr("Sample Time"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_STATUS, Qt::Horizontal,
-                             tr("Status"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_VELOCITY, Qt::Horizontal,
-                             tr("Velocity"), Qt::DisplayRole);
-    tableModel.setHeaderData(ZONETABLECOLUMN_WET_SAMPLE, Qt::Horizontal,
-                             tr("Wet Sample"), Qt::DisplayRole);
-    for (synthclone::MIDIData i = 0; i < 0x80; i++) {
-        int column = ZONETABLECOLUMN_CONTROL_0 + i;
-        tableModel.setHeaderData(column, Qt::Horizontal,
-                                 synthclone::getMIDIControlString(i),
-                                 Qt::DisplayRole);
-    }
 
     tableView = synthclone::getChild<QTableView>(mainWindow, "zoneTableView");
     tableView->installEventFilter(&contextMenuEventFilter);
     tableView->setItemDelegate(&tableDelegate);
     tableView->setModel(&tableModel);
+    tableModel.setPalette(tableView->palette());
     connect(tableView->selectionModel(),
             SIGNAL(selectionChanged(QItemSelection, QItemSelection)),
             SLOT(handleSelectionChange(QItemSelection, QItemSelection)));
@@ -233,74 +206,6 @@ ZoneViewlet::addZone(int index)
     assert((index >= 0) && (index <= tableModel.rowCount()));
     bool inserted = tableModel.insertRow(index);
     assert(inserted);
-    enableRow(index);
-}
-
-void
-ZoneViewlet::disableRow(int index)
-{
-    assert((index >= 0) && (index < tableModel.rowCount()));
-
-    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
-    getModelItem(index, ZONETABLECOLUMN_DRY_SAMPLE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_STATUS)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_WET_SAMPLE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_AFTERTOUCH)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_CHANNEL)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_CHANNEL_PRESSURE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_NOTE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_RELEASE_TIME)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_SAMPLE_TIME)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_VELOCITY)->setFlags(flags);
-    for (int i = 0; i < 0x80; i++) {
-        getModelItem(index, ZONETABLECOLUMN_CONTROL_0 + i)->setFlags(flags);
-    }
-
-    QModelIndex editIndex = tableDelegate.getEditIndex();
-    if (editIndex.isValid() && (editIndex.row() == index)) {
-        tableView->closePersistentEditor(editIndex);
-    }
-}
-
-void
-ZoneViewlet::enableRow(int index)
-{
-    assert((index >= 0) && (index < tableModel.rowCount()));
-
-    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
-    getModelItem(index, ZONETABLECOLUMN_DRY_SAMPLE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_STATUS)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_WET_SAMPLE)->setFlags(flags);
-
-    flags |= Qt::ItemIsEditable;
-    getModelItem(index, ZONETABLECOLUMN_AFTERTOUCH)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_CHANNEL)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_CHANNEL_PRESSURE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_NOTE)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_RELEASE_TIME)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_SAMPLE_TIME)->setFlags(flags);
-    getModelItem(index, ZONETABLECOLUMN_VELOCITY)->setFlags(flags);
-    for (int i = 0; i < 0x80; i++) {
-        getModelItem(index, ZONETABLECOLUMN_CONTROL_0 + i)->setFlags(flags);
-    }
-}
-
-QVariant
-ZoneViewlet::generateSampleProfile(const SampleProfile *profile)
-{
-    QVariant data;
-    if (profile) {
-        const float *peaks = profile->getPeaks();
-        QVariantList variants;
-        for (int i = 0; i < 1024; i++) {
-            variants.append(peaks[i] < -128.0 ? -128.0 : peaks[i]);
-        }
-        QVariantMap map;
-        map["peaks"] = variants;
-        map["time"] = profile->getTime();
-        data.setValue(map);
-    }
-    return data;
 }
 
 MenuViewlet *
@@ -309,15 +214,6 @@ ZoneViewlet::getMenuViewlet()
     return menuViewlet;
 }
 
-QStandardItem *
-ZoneViewlet::getModelItem(int row, int column)
-{
-    QStandardItem *item =
-        tableModel.itemFromIndex(tableModel.index(row, column));
-    assert(item);
-    return item;
-}
-
 void
 ZoneViewlet::handleColumnShowAction()
 {
@@ -357,6 +253,9 @@ ZoneViewlet::handleColumnShowAction()
     case ZONETABLECOLUMN_WET_SAMPLE:
         emit wetSamplePropertyVisibilityChangeRequest(visible);
         break;
+    case ZONETABLECOLUMN_XRUN_COUNT:
+        emit xrunCountPropertyVisibilityChangeRequest(visible);
+        break;
     default:
         control = static_cast<synthclone::MIDIData>
             (column - ZONETABLECOLUMN_CONTROL_0);
@@ -432,6 +331,9 @@ ZoneViewlet::handleSortRequest(int column, bool ascending)
     case ZONETABLECOLUMN_WET_SAMPLE:
         emit wetSamplePropertySortRequest(ascending);
         break;
+    case ZONETABLECOLUMN_XRUN_COUNT:
+        emit xrunCountPropertySortRequest(ascending);
+        break;
     default:
         control = static_cast<synthclone::MIDIData>
             (column - ZONETABLECOLUMN_CONTROL_0);
@@ -474,18 +376,13 @@ ZoneViewlet::moveZone(int fromIndex, int toIndex)
     assert((fromIndex >= 0) && (fromIndex < rowCount));
     assert((toIndex >= 0) && (toIndex < rowCount));
     assert(fromIndex != toIndex);
-    bool selected = tableView->selectionModel()->
-        isRowSelected(fromIndex, QModelIndex());
-    tableModel.insertRow(toIndex, tableModel.takeRow(fromIndex));
-    if (selected) {
-        int columnCount = tableModel.columnCount();
-        QItemSelection selection(tableModel.index(toIndex, 0),
-                                 tableModel.index(toIndex, columnCount - 1));
-        emitZoneSelectRequest = false;
-        tableView->selectionModel()->
-            select(selection, QItemSelectionModel::Select);
-        emitZoneSelectRequest = true;
-    }
+
+    // The row is moved with a single move notification, and the selection
+    // model moves the row's selection along with it.
+    int destination = (fromIndex < toIndex) ? toIndex + 1 : toIndex;
+    bool moved = tableModel.moveRow(QModelIndex(), fromIndex, QModelIndex(),
+                                    destination);
+    assert(moved);
 }
 
 void
@@ -496,19 +393,35 @@ ZoneViewlet::removeZone(int index)
     assert(removed);
 }
 
+void
+ZoneViewlet::reorderZones(const QList<int> &indexes)
+{
+    assert(indexes.count() == tableModel.rowCount());
+
+    // The selection model keeps the selection on the reordered rows, which
+    // already matches the session's selection.
+    emitZoneSelectRequest = false;
+    tableModel.reorderRows(indexes);
+    emitZoneSelectRequest = true;
+}
+
+void
+ZoneViewlet::resetZones(int count)
+{
+    assert(count >= 0);
+
+    // The session's selection is reapplied after the table is rebuilt, so
+    // the selection changes caused by rebuilding it are not forwarded.
+    emitZoneSelectRequest = false;
+    tableModel.resetRows(count);
+    emitZoneSelectRequest = true;
+}
+
 void
 ZoneViewlet::setAftertouch(int index, synthclone::MIDIData aftertouch)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    int intAftertouch = static_cast<int>(aftertouch);
-    setModelData(index, ZONETABLECOLUMN_AFTERTOUCH, intAftertouch);
-    QVariant value;
-    if (aftertouch == synthclone::MIDI_VALUE_NOT_SET) {
-        value = tr("(not set)");
-    } else {
-        value = intAftertouch;
-    }
-    setModelData(index, ZONETABLECOLUMN_AFTERTOUCH, value, Qt::DisplayRole);
+    tableModel.setAftertouch(index, aftertouch);
 }
 
 void
@@ -533,25 +446,14 @@ void
 ZoneViewlet::setChannel(int index, synthclone::MIDIData channel)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    int intChannel = static_cast<int>(channel);
-    setModelData(index, ZONETABLECOLUMN_CHANNEL, intChannel);
-    setModelData(index, ZONETABLECOLUMN_CHANNEL, intChannel, Qt::DisplayRole);
+    tableModel.setChannel(index, channel);
 }
 
 void
 ZoneViewlet::setChannelPressure(int index, synthclone::MIDIData pressure)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    int intPressure = static_cast<int>(pressure);
-    setModelData(index, ZONETABLECOLUMN_CHANNEL_PRESSURE, intPressure);
-    QVariant value;
-    if (pressure == synthclone::MIDI_VALUE_NOT_SET) {
-        value = tr("(not set)");
-    } else {
-        value = intPressure;
-    }
-    setModelData(index, ZONETABLECOLUMN_CHANNEL_PRESSURE, value,
-                 Qt::DisplayRole);
+    tableModel.setChannelPressure(index, pressure);
 }
 
 void
@@ -610,16 +512,7 @@ ZoneViewlet::setControlValue(int index, synthclone::MIDIData control,
     assert((index >= 0) && (index < tableModel.rowCount()));
     assert(control < 0x80);
     assert((value < 0x80) || (value == synthclone::MIDI_VALUE_NOT_SET));
-    int column = ZONETABLECOLUMN_CONTROL_0 + static_cast<int>(control);
-    int intValue = static_cast<int>(value);
-    setModelData(index, column, intValue);
-    QVariant varValue;
-    if (value == synthclone::MIDI_VALUE_NOT_SET) {
-        varValue = tr("(not set)");
-    } else {
-        varValue = intValue;
-    }
-    setModelData(index, column, varValue, Qt::DisplayRole);
+    tableModel.setControlValue(index, control, value);
 }
 
 void
@@ -644,8 +537,7 @@ void
 ZoneViewlet::setDrySampleProfile(int index, const SampleProfile *profile)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    setModelData(index, ZONETABLECOLUMN_DRY_SAMPLE,
-                 generateSampleProfile(profile), Qt::UserRole);
+    tableModel.setDrySampleProfile(index, profile);
 }
 
 void
@@ -658,10 +550,7 @@ void
 ZoneViewlet::setDrySampleStale(int index, bool stale)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    const QPalette &palette = tableView->palette();
-    setModelData(index, ZONETABLECOLUMN_DRY_SAMPLE,
-                 stale ? palette.alternateBase() : palette.base(),
-                 Qt::BackgroundRole);
+    tableModel.setDrySampleStale(index, stale);
 }
 
 void
@@ -676,21 +565,11 @@ ZoneViewlet::setInvertSelectionEnabled(bool enabled)
     invertSelectionAction->setEnabled(enabled);
 }
 
-void
-ZoneViewlet::setModelData(int row, int column, const QVariant &value, int role)
-{
-    bool result = tableModel.setData(tableModel.index(row, column), value,
-                                     role);
-    assert(result);
-}
-
 void
 ZoneViewlet::setNote(int index, synthclone::MIDIData note)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    setModelData(index, ZONETABLECOLUMN_NOTE, static_cast<int>(note));
-    setModelData(index, ZONETABLECOLUMN_NOTE,
-                 synthclone::getMIDINoteString(note), Qt::DisplayRole);
+    tableModel.setNote(index, note);
 }
 
 void
@@ -721,9 +600,7 @@ void
 ZoneViewlet::setReleaseTime(int index, synthclone::SampleTime releaseTime)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    setModelData(index, ZONETABLECOLUMN_RELEASE_TIME, releaseTime);
-    setModelData(index, ZONETABLECOLUMN_RELEASE_TIME,
-                 tr("%1 seconds").arg(releaseTime), Qt::DisplayRole);
+    tableModel.setReleaseTime(index, releaseTime);
 }
 
 void
@@ -754,9 +631,7 @@ void
 ZoneViewlet::setSampleTime(int index, synthclone::SampleTime sampleTime)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    setModelData(index, ZONETABLECOLUMN_SAMPLE_TIME, sampleTime);
-    setModelData(index, ZONETABLECOLUMN_SAMPLE_TIME,
-                 tr("%1 seconds").arg(sampleTime), Qt::DisplayRole);
+    tableModel.setSampleTime(index, sampleTime);
 }
 
 void
@@ -789,45 +664,12 @@ void
 ZoneViewlet::setStatus(int index, synthclone::Zone::Status status)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    bool disabled = true;
-    QString statusStr;
-
-    switch (status) {
-    case synthclone::Zone::STATUS_EFFECT_JOB_QUEUE:
-        statusStr = tr("In effect job queue ...");
-        break;
-    case synthclone::Zone::STATUS_EFFECTS:
-        statusStr = tr("Applying effects ...");
-        break;
-    case synthclone::Zone::STATUS_NORMAL:
-        disabled = false;
-        statusStr = "";
-        break;
-    case synthclone::Zone::STATUS_SAMPLER_PLAYING_DRY_SAMPLE:
-        statusStr = tr("Playing dry sample ...");
-        break;
-    case synthclone::Zone::STATUS_SAMPLER_PLAYING_WET_SAMPLE:
-        statusStr = tr("Playing wet sample ...");
-        break;
-    case synthclone::Zone::STATUS_SAMPLER_SAMPLING:
-        statusStr = tr("Sampling ...");
-        break;
-    case synthclone::Zone::STATUS_SAMPLER_JOB_QUEUE:
-        statusStr = tr("In sampler job queue ...");
-        break;
-    case synthclone::Zone::STATUS_TARGETS:
-        statusStr = tr("Building targets ...");
-    }
-    setModelData(index, ZONETABLECOLUMN_STATUS, statusStr, Qt::DisplayRole);
-    if (disabled) {
-        disableRow(index);
-        setModelData(index, ZONETABLECOLUMN_STATUS,
-                     QPixmap(":/synthclone/images/16x16/locked.png"),
-                     Qt::DecorationRole);
-    } else {
-        enableRow(index);
-        setModelData(index, ZONETABLECOLUMN_STATUS, QVariant(),
-                     Qt::DecorationRole);
+    tableModel.setStatus(index, status);
+    if (status != synthclone::Zone::STATUS_NORMAL) {
+        QModelIndex editIndex = tableDelegate.getEditIndex();
+        if (editIndex.isValid() && (editIndex.row() == index)) {
+            tableView->closePersistentEditor(editIndex);
+        }
     }
 }
 
@@ -841,9 +683,7 @@ void
 ZoneViewlet::setVelocity(int index, synthclone::MIDIData velocity)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    int intVelocity = static_cast<int>(velocity);
-    setModelData(index, ZONETABLECOLUMN_VELOCITY, intVelocity);
-    setModelData(index, ZONETABLECOLUMN_VELOCITY, intVelocity, Qt::DisplayRole);
+    tableModel.setVelocity(index, velocity);
 }
 
 void
@@ -856,8 +696,7 @@ void
 ZoneViewlet::setWetSampleProfile(int index, const SampleProfile *profile)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    setModelData(index, ZONETABLECOLUMN_WET_SAMPLE,
-                 generateSampleProfile(profile), Qt::UserRole);
+    tableModel.setWetSampleProfile(index, profile);
 }
 
 void
@@ -870,8 +709,18 @@ void
 ZoneViewlet::setWetSampleStale(int index, bool stale)
 {
     assert((index >= 0) && (index < tableModel.rowCount()));
-    const QPalette &palette = tableView->palette();
-    setModelData(index, ZONETABLECOLUMN_WET_SAMPLE,
-                 stale ? palette.alternateBase() : palette.base(),
-                 Qt::BackgroundRole);
+    tableModel.setWetSampleStale(index, stale);
+}
+
+void
+ZoneViewlet::setXrunCount(int index, int count)
+{
+    assert((index >= 0) && (index < tableModel.rowCount()));
+    tableModel.setXrunCount(index, count);
+}
+
+void
+ZoneViewlet::setXrunCountPropertyVisible(bool visible)
+{
+    setColumnVisible(ZONETABLECOLUMN_XRUN_COUNT, visible);
 }
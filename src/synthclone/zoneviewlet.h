@@ -20,8 +20,6 @@
 #ifndef __ZONEVIEWLET_H__
 #define __ZONEVIEWLET_H__
 
-#include <QtGui/QStandardItemModel>
-
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QTableView>
@@ -32,7 +30,6 @@
 #include "contextmenueventfilter.h"
 #include "menuviewlet.h"
 #include "sampleprofile.h"
-#include "standarditem.h"
 #include "types.h"
 #include "zonetabledelegate.h"
 #include "zonetablemodel.h"
@@ -62,6 +59,12 @@ public slots:
     void
     removeZone(int index);
 
+    void
+    reorderZones(const QList<int> &indexes);
+
+    void
+    resetZones(int count);
+
     void
     setAftertouch(int index, synthclone::MIDIData aftertouch);
 
@@ -189,6 +192,12 @@ public slots:
     void
     setWetSampleStale(int index, bool stale);
 
+    void
+    setXrunCount(int index, int count);
+
+    void
+    setXrunCountPropertyVisible(bool visible);
+
 signals:
 
     void
@@ -337,6 +346,12 @@ signals:
     void
     wetSamplePropertySortRequest(bool ascending);
 
+    void
+    xrunCountPropertyVisibilityChangeRequest(bool visible);
+
+    void
+    xrunCountPropertySortRequest(bool ascending);
+
 private slots:
 
     void
@@ -354,18 +369,6 @@ private slots:
 
 private:
 
-    void
-    disableRow(int index);
-
-    void
-    enableRow(int index);
-
-    QVariant
-    generateSampleProfile(const SampleProfile *profile);
-
-    QStandardItem *
-    getModelItem(int row, int column);
-
     void
     initializeColumnShowAction(QWidget *widget, int column,
                                const QString &actionId);
@@ -378,13 +381,6 @@ private:
     void
     setColumnVisible(int column, bool visible);
 
-    void
-    setItemFlags(QStandardItem *item, Qt::ItemFlags flags);
-
-    void
-    setModelData(int row, int column, const QVariant &value,
-                 int role=Qt::EditRole);
-
     QAction *applyEffectsAction;
     QAction *buildTargetsAction;
     QAction *clearEffectJobsAction;
@@ -399,7 +395,6 @@ private:
     bool emitZoneSelectRequest;
     QAction *insertAction;
     QAction *invertSelectionAction;
-    StandardItem *itemPrototype;
     MenuViewlet *menuViewlet;
     QAction *pasteAction;
     QAction *playDrySampleAction;